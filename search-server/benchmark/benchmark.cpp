@@ -0,0 +1,668 @@
+//    SearchServer   .
+//    search-server:
+//   g++ -std=c++17 -O2 -I. benchmark/*.cpp < .cpp ,  main.cpp  unit_tests.cpp> -ltbb -lpthread
+//  : ./benchmark --docs=20000 --length=60 --vocab=50000 --stop-ratio=0.001 --seed=1
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <execution>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "corpus_generator.h"
+#include "../corpus_reader.h"
+#include "../ingestion_queue.h"
+#include "../latency_histogram.h"
+#include "../paginator.h"
+#include "../process_queries.h"
+#include "../remove_duplicates.h"
+#include "../search_server.h"
+#include "../sharded_search_server.h"
+#include "../write_ahead_log.h"
+
+using namespace std::literals;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchmarkResult {
+    std::string name;
+    uint64_t operations = 0;
+    double total_seconds = 0;
+    LatencyHistogram::Snapshot latencies;
+};
+
+//       
+volatile size_t benchmark_sink = 0;
+
+// operation(i)  count ,      
+template <typename Operation>
+BenchmarkResult Measure(const std::string& name, size_t count, Operation operation) {
+    BenchmarkResult result;
+    result.name = name;
+    result.operations = count;
+
+    const Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        const Clock::time_point operation_start = Clock::now();
+        benchmark_sink = benchmark_sink + operation(i);
+        result.latencies.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - operation_start).count());
+    }
+    result.total_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return result;
+}
+
+void PrintHeader(std::ostream& out) {
+    out << std::left << std::setw(42) << "operation" << std::right
+        << std::setw(10) << "ops" << std::setw(14) << "ops/s"
+        << std::setw(12) << "p50 us" << std::setw(12) << "p90 us" << std::setw(12) << "p99 us" << std::setw(12) << "max us" << '\n';
+}
+
+void PrintResult(std::ostream& out, const BenchmarkResult& result) {
+    const auto to_us = [](uint64_t ns) { return ns / 1000.0; };
+    out << std::left << std::setw(42) << result.name << std::right << std::fixed << std::setprecision(1)
+        << std::setw(10) << result.operations
+        << std::setw(14) << (result.total_seconds > 0 ? result.operations / result.total_seconds : 0.0)
+        << std::setw(12) << to_us(result.latencies.GetValueAtPercentile(50))
+        << std::setw(12) << to_us(result.latencies.GetValueAtPercentile(90))
+        << std::setw(12) << to_us(result.latencies.GetValueAtPercentile(99))
+        << std::setw(12) << to_us(result.latencies.max_value) << '\n';
+}
+
+long GetPeakRssKilobytes() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+void FillServer(SearchServer& search_server, const Corpus& corpus) {
+    for (size_t i = 0; i < corpus.documents.size(); ++i) {
+        search_server.AddDocument(static_cast<int>(i), corpus.documents[i], corpus.statuses[i], corpus.ratings[i]);
+    }
+}
+
+bool ParseOption(const std::string& arg, const std::string& name, std::string& value) {
+    const std::string prefix = "--"s + name + "="s;
+    if (arg.compare(0, prefix.size(), prefix) != 0) {
+        return false;
+    }
+    value = arg.substr(prefix.size());
+    return true;
+}
+
+CorpusOptions ParseCommandLine(int argc, char** argv, std::string& filter) {
+    CorpusOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        std::string value;
+        if (ParseOption(arg, "docs"s, value)) {
+            options.document_count = std::stoi(value);
+        }
+        else if (ParseOption(arg, "length"s, value)) {
+            options.document_length = std::stoi(value);
+        }
+        else if (ParseOption(arg, "vocab"s, value)) {
+            options.vocabulary_size = std::stoi(value);
+        }
+        else if (ParseOption(arg, "zipf"s, value)) {
+            options.zipf_exponent = std::stod(value);
+        }
+        else if (ParseOption(arg, "stop-ratio"s, value)) {
+            options.stop_word_ratio = std::stod(value);
+        }
+        else if (ParseOption(arg, "queries"s, value)) {
+            options.query_count = std::stoi(value);
+        }
+        else if (ParseOption(arg, "query-length"s, value)) {
+            options.query_length = std::stoi(value);
+        }
+        else if (ParseOption(arg, "duplicates"s, value)) {
+            options.duplicate_ratio = std::stod(value);
+        }
+        else if (ParseOption(arg, "seed"s, value)) {
+            options.seed = std::stoull(value);
+        }
+        else if (ParseOption(arg, "filter"s, value)) {
+            filter = value;
+        }
+        else {
+            std::cerr << "Unknown option: "s << arg << std::endl;
+            std::exit(1);
+        }
+    }
+    //          -
+    if (options.document_count <= 0) {
+        std::cerr << "Option --docs must be positive"s << std::endl;
+        std::exit(1);
+    }
+    return options;
+}
+
+}
+
+int main(int argc, char** argv) {
+    std::string filter;
+    const CorpusOptions options = ParseCommandLine(argc, argv, filter);
+
+    const Corpus corpus = GenerateCorpus(options);
+    std::cout << "corpus: docs = "s << options.document_count << ", length = "s << options.document_length
+        << ", vocabulary = "s << options.vocabulary_size << ", zipf = "s << options.zipf_exponent
+        << ", stop ratio = "s << options.stop_word_ratio << ", seed = "s << options.seed << '\n';
+
+    std::vector<BenchmarkResult> results;
+    const auto run = [&](const std::string& name, size_t count, auto operation) {
+        if (name.find(filter) != std::string::npos) {
+            results.push_back(Measure(name, count, operation));
+            PrintResult(std::cerr, results.back());
+        }
+    };
+
+    SearchServer search_server(corpus.stop_words);
+    run("AddDocument"s, corpus.documents.size(), [&](size_t i) {
+        search_server.AddDocument(static_cast<int>(i), corpus.documents[i], corpus.statuses[i], corpus.ratings[i]);
+        return size_t{ 1 };
+        });
+    if (search_server.GetDocumentCount() == 0) {
+        FillServer(search_server, corpus);
+    }
+    const MemoryStats memory_stats = search_server.GetMemoryStats();
+    run("GetMemoryStats"s, corpus.queries.size(), [&](size_t i) {
+        return search_server.GetMemoryStats().used_bytes;
+        });
+
+    const size_t query_count = corpus.queries.size();
+    const auto& queries = corpus.queries;
+    const auto even_ids = [](int document_id, DocumentStatus, int) { return document_id % 2 == 0; };
+
+    run("FindTopDocuments(seq, query)"s, query_count, [&](size_t i) {
+        return search_server.FindTopDocuments(std::execution::seq, queries[i]).size();
+        });
+    run("FindTopDocuments(par, query)"s, query_count, [&](size_t i) {
+        return search_server.FindTopDocuments(std::execution::par, queries[i]).size();
+        });
+    run("FindTopDocuments(seq, query, status)"s, query_count, [&](size_t i) {
+        return search_server.FindTopDocuments(std::execution::seq, queries[i], DocumentStatus::BANNED).size();
+        });
+    run("FindTopDocuments(par, query, status)"s, query_count, [&](size_t i) {
+        return search_server.FindTopDocuments(std::execution::par, queries[i], DocumentStatus::BANNED).size();
+        });
+    run("FindTopDocuments(seq, query, predicate)"s, query_count, [&](size_t i) {
+        return search_server.FindTopDocuments(std::execution::seq, queries[i], even_ids).size();
+        });
+    run("FindTopDocuments(par, query, predicate)"s, query_count, [&](size_t i) {
+        return search_server.FindTopDocuments(std::execution::par, queries[i], even_ids).size();
+        });
+    {
+        //  :      
+        std::vector<std::string> malformed_queries;
+        for (const std::string& query : queries) {
+            malformed_queries.push_back(query + " --x"s);
+        }
+        run("FindTopDocuments(seq, malformed query, exception)"s, query_count, [&](size_t i) {
+            try {
+                return search_server.FindTopDocuments(malformed_queries[i]).size();
+            }
+            catch (const std::invalid_argument&) {
+                return size_t{ 0 };
+            }
+            });
+        run("TryFindTopDocuments(seq, malformed query)"s, query_count, [&](size_t i) {
+            return static_cast<size_t>(search_server.TryFindTopDocuments(malformed_queries[i]).GetError());
+            });
+        run("TryFindTopDocuments(seq, query)"s, query_count, [&](size_t i) {
+            return search_server.TryFindTopDocuments(queries[i]).Value().size();
+            });
+    }
+    run("FindTopDocuments(seq, query, deadline 20ms)"s, query_count, [&](size_t i) {
+        return search_server.FindTopDocuments(queries[i], QueryDeadline::After(std::chrono::milliseconds(20))).documents.size();
+        });
+
+    {
+        //      :      
+        std::string heavy_query;
+        for (const std::string_view word : search_server.GetCompletions(""sv, 20)) {
+            heavy_query += std::string(word) + " "s;
+        }
+        run("FindTopDocuments(seq, 20 frequent words)"s, 10, [&](size_t) {
+            return search_server.FindTopDocuments(heavy_query).size();
+            });
+        run("FindTopDocuments(seq, 20 frequent words, deadline 1ms)"s, 10, [&](size_t) {
+            return search_server.FindTopDocuments(heavy_query, QueryDeadline::After(std::chrono::milliseconds(1))).documents.size();
+            });
+        run("FindTopDocuments(par, 20 frequent words, deadline 1ms)"s, 10, [&](size_t) {
+            const QueryDeadline deadline = QueryDeadline::After(std::chrono::milliseconds(1));
+            return search_server.FindTopDocuments(std::execution::par, heavy_query, DocumentStatus::ACTUAL, deadline).documents.size();
+            });
+    }
+
+    run("FindPage(seq, 3 pages of 10 by cursor)"s, query_count, [&](size_t i) {
+        size_t found = 0;
+        PageCursor cursor;
+        for (int page_index = 0; page_index < 3; ++page_index) {
+            const SearchPage page = search_server.FindPage(queries[i], 10, cursor);
+            found += page.documents.size();
+            cursor = page.next;
+        }
+        return found;
+        });
+    run("FindPageAt(seq, page 5 of 10)"s, query_count, [&](size_t i) {
+        return search_server.FindPageAt(queries[i], 10, 5).documents.size();
+        });
+
+    {
+        //   ,   - 
+        std::vector<std::string> conjunctive_queries;
+        for (const std::string& query : queries) {
+            std::string conjunctive_query;
+            for (const std::string_view word : SplitIntoWords(query)) {
+                conjunctive_query += (word[0] == '-' ? ""s : "+"s) + std::string(word) + ' ';
+            }
+            conjunctive_queries.push_back(std::move(conjunctive_query));
+        }
+        run("FindTopDocuments(seq, +required words)"s, query_count, [&](size_t i) {
+            return search_server.FindTopDocuments(std::execution::seq, conjunctive_queries[i]).size();
+            });
+        run("FindTopDocuments(par, +required words)"s, query_count, [&](size_t i) {
+            return search_server.FindTopDocuments(std::execution::par, conjunctive_queries[i]).size();
+            });
+    }
+
+    {
+        IndexOptions positional_options;
+        positional_options.store_positions = true;
+        SearchServer positional_server(corpus.stop_words, positional_options);
+        run("AddDocument(with positions)"s, corpus.documents.size(), [&](size_t i) {
+            positional_server.AddDocument(static_cast<int>(i), corpus.documents[i], corpus.statuses[i], corpus.ratings[i]);
+            return size_t{ 1 };
+            });
+        if (positional_server.GetDocumentCount() == 0) {
+            FillServer(positional_server, corpus);
+        }
+
+        //     ,     
+        std::vector<std::string> phrase_queries;
+        for (size_t i = 0; i < query_count; ++i) {
+            const std::vector<std::string_view> words = SplitIntoWords(corpus.documents[i * 7919 % corpus.documents.size()]);
+            const size_t first = i % (words.size() - 1);
+            phrase_queries.push_back("\""s + std::string(words[first]) + ' ' + std::string(words[first + 1]) + '"');
+        }
+        run("FindTopDocuments(seq, query, positional)"s, query_count, [&](size_t i) {
+            return positional_server.FindTopDocuments(std::execution::seq, queries[i]).size();
+            });
+        run("FindTopDocuments(seq, \"phrase\")"s, query_count, [&](size_t i) {
+            return positional_server.FindTopDocuments(std::execution::seq, phrase_queries[i]).size();
+            });
+        run("FindTopDocuments(seq, \"phrase\"~3)"s, query_count, [&](size_t i) {
+            return positional_server.FindTopDocuments(std::execution::seq, phrase_queries[i] + "~3"s).size();
+            });
+    }
+
+    {
+        // - -    ;      
+        std::vector<std::string> minus_queries;
+        std::string minus_words;
+        for (const std::string_view word : search_server.GetCompletions(""sv, 3)) {
+            minus_words += " -"s + std::string(word);
+        }
+        for (const std::string& query : queries) {
+            minus_queries.push_back(query + minus_words);
+        }
+        IndexOptions list_options;
+        list_options.bitmap_min_document_freq = 0;
+        SearchServer list_server(corpus.stop_words, list_options);
+        FillServer(list_server, corpus);
+        run("FindTopDocuments(seq, -frequent words, lists)"s, query_count, [&](size_t i) {
+            return list_server.FindTopDocuments(std::execution::seq, minus_queries[i]).size();
+            });
+        run("FindTopDocuments(seq, -frequent words, bitmaps)"s, query_count, [&](size_t i) {
+            return search_server.FindTopDocuments(std::execution::seq, minus_queries[i]).size();
+            });
+        run("FindTopDocuments(seq, status, lists)"s, query_count, [&](size_t i) {
+            return list_server.FindTopDocuments(std::execution::seq, queries[i], DocumentStatus::BANNED).size();
+            });
+        run("FindTopDocuments(seq, status, bitmaps)"s, query_count, [&](size_t i) {
+            return search_server.FindTopDocuments(std::execution::seq, queries[i], DocumentStatus::BANNED).size();
+            });
+    }
+
+    for (const int bits : { 8, 16 }) {
+        IndexOptions impact_options;
+        impact_options.impact_bits = bits;
+        SearchServer impact_server(corpus.stop_words, impact_options);
+        const std::string suffix = ", "s + std::to_string(bits) + "-bit impacts)"s;
+        run("AddDocument(with"s + suffix.substr(1), corpus.documents.size(), [&](size_t i) {
+            impact_server.AddDocument(static_cast<int>(i), corpus.documents[i], corpus.statuses[i], corpus.ratings[i]);
+            return size_t{ 1 };
+            });
+        if (impact_server.GetDocumentCount() == 0) {
+            FillServer(impact_server, corpus);
+        }
+        run("FindTopDocuments(seq"s + suffix, query_count, [&](size_t i) {
+            return impact_server.FindTopDocuments(std::execution::seq, queries[i]).size();
+            });
+
+        //    :      
+        size_t same_results = 0;
+        double max_error = 0.0;
+        for (size_t i = 0; i < query_count; ++i) {
+            const std::vector<Document> expected = search_server.FindTopDocuments(std::execution::seq, queries[i]);
+            const std::vector<Document> found = impact_server.FindTopDocuments(std::execution::seq, queries[i]);
+            bool is_same = expected.size() == found.size();
+            for (size_t j = 0; is_same && j < found.size(); ++j) {
+                is_same = expected[j].id == found[j].id;
+                max_error = std::max(max_error, std::abs(expected[j].relevance - found[j].relevance));
+            }
+            same_results += is_same;
+        }
+        std::cout << bits << "-bit impacts: same top documents for "s << same_results << " of "s << query_count
+            << " queries, max relevance error "s << max_error << ", impact bytes per posting "s
+            << static_cast<double>(impact_server.GetMemoryStats()[MemoryStructure::IMPACTS].bytes)
+               / std::max<size_t>(impact_server.GetMemoryStats()[MemoryStructure::IMPACTS].entries, 1) << '\n';
+    }
+
+    {
+        //     -   
+        std::vector<std::string> prefix_queries;
+        for (const std::string& query : queries) {
+            std::string prefix_query;
+            for (const std::string_view word : SplitIntoWords(query)) {
+                prefix_query += std::string(word.substr(0, word[0] == '-' ? 3 : 2)) + "* "s;
+            }
+            prefix_queries.push_back(std::move(prefix_query));
+        }
+        run("FindTopDocuments(seq, prefix*)"s, query_count, [&](size_t i) {
+            return search_server.FindTopDocuments(std::execution::seq, prefix_queries[i]).size();
+            });
+        run("GetCompletions(2 letters, 10)"s, query_count, [&](size_t i) {
+            return search_server.GetCompletions(std::string_view(queries[i]).substr(0, 2), 10).size();
+            });
+    }
+
+    {
+        IndexOptions typo_options;
+        typo_options.max_typo_distance = 2;
+        SearchServer typo_server(corpus.stop_words, typo_options);
+        run("AddDocument(with trigram index)"s, corpus.documents.size(), [&](size_t i) {
+            typo_server.AddDocument(static_cast<int>(i), corpus.documents[i], corpus.statuses[i], corpus.ratings[i]);
+            return size_t{ 1 };
+            });
+        if (typo_server.GetDocumentCount() == 0) {
+            FillServer(typo_server, corpus);
+        }
+
+        //       
+        std::vector<std::string> typo_queries;
+        for (size_t i = 0; i < query_count; ++i) {
+            std::string typo_query = queries[i];
+            for (size_t j = 0; j < typo_query.size(); ++j) {
+                if (typo_query[j] != ' ' && typo_query[j] != '-' && (j == 0 || typo_query[j - 1] == ' ' || typo_query[j - 1] == '-')) {
+                    typo_query[j] = static_cast<char>('a' + (typo_query[j] - 'a' + 1) % 26);
+                }
+            }
+            typo_queries.push_back(std::move(typo_query));
+        }
+        run("FindTopDocuments(seq, query, typo index)"s, query_count, [&](size_t i) {
+            return typo_server.FindTopDocuments(std::execution::seq, queries[i]).size();
+            });
+        run("FindTopDocuments(seq, 1 typo per word)"s, query_count, [&](size_t i) {
+            return typo_server.FindTopDocuments(std::execution::seq, typo_queries[i]).size();
+            });
+    }
+
+    {
+        std::vector<NewDocument> batch;
+        for (size_t i = 0; i < corpus.documents.size(); ++i) {
+            batch.push_back({ static_cast<int>(i), corpus.documents[i], corpus.statuses[i], corpus.ratings[i] });
+        }
+        ShardedSearchServer sharded_server(corpus.stop_words);
+        run("ShardedSearchServer AddDocuments(par, all)"s, 1, [&](size_t) {
+            sharded_server.AddDocuments(std::execution::par, batch);
+            return batch.size();
+            });
+        if (sharded_server.GetDocumentCount() == 0) {
+            sharded_server.AddDocuments(std::execution::par, batch);
+        }
+        run("ShardedSearchServer FindTopDocuments(seq)"s, query_count, [&](size_t i) {
+            return sharded_server.FindTopDocuments(std::execution::seq, queries[i]).size();
+            });
+        run("ShardedSearchServer FindTopDocuments(par)"s, query_count, [&](size_t i) {
+            return sharded_server.FindTopDocuments(std::execution::par, queries[i]).size();
+            });
+
+        std::vector<int> removed_ids;
+        for (size_t i = 0; i < std::min<size_t>(corpus.documents.size(), 4000); i += 2) {
+            removed_ids.push_back(static_cast<int>(i));
+        }
+        run("ShardedSearchServer RemoveDocuments(par, 2000)"s, 1, [&](size_t) {
+            sharded_server.RemoveDocuments(std::execution::par, removed_ids);
+            return removed_ids.size();
+            });
+    }
+
+    {
+        //     :        
+        const std::string corpus_path = (std::filesystem::temp_directory_path() / "search_server_benchmark_corpus.txt").string();
+        {
+            std::ofstream out(corpus_path, std::ios::binary);
+            for (size_t i = 0; i < corpus.documents.size(); ++i) {
+                out << i << '\t' << static_cast<int>(corpus.statuses[i]) << '\t';
+                for (size_t j = 0; j < corpus.ratings[i].size(); ++j) {
+                    out << (j > 0 ? " "s : ""s) << corpus.ratings[i][j];
+                }
+                out << '\t' << corpus.documents[i] << '\n';
+            }
+        }
+        IngestOptions ingest_options;
+        ingest_options.format = CorpusFormat::FRAMED;
+        ingest_options.chunk_size = size_t(1) << 20;
+        run("IngestCorpus(mmap, framed)"s, 1, [&](size_t) {
+            SearchServer ingested_server(corpus.stop_words);
+            return IngestCorpus(ingested_server, corpus_path, ingest_options);
+            });
+        std::filesystem::remove(corpus_path);
+    }
+
+    {
+        //  :    AddDocument     
+        const size_t producer_count = 4;
+        const auto produce = [&corpus, producer_count](auto add_document) {
+            std::vector<std::thread> producers;
+            for (size_t p = 0; p < producer_count; ++p) {
+                producers.emplace_back([&corpus, &add_document, p, producer_count] {
+                    for (size_t i = p; i < corpus.documents.size(); i += producer_count) {
+                        add_document(i);
+                    }
+                    });
+            }
+            for (std::thread& producer : producers) {
+                producer.join();
+            }
+            return corpus.documents.size();
+        };
+        run("AddDocument(4 producers, mutex)"s, 1, [&](size_t) {
+            SearchServer locked_server(corpus.stop_words);
+            std::mutex server_mutex;
+            return produce([&](size_t i) {
+                std::lock_guard lock(server_mutex);
+                locked_server.AddDocument(static_cast<int>(i), corpus.documents[i], corpus.statuses[i], corpus.ratings[i]);
+                });
+            });
+        run("IngestionQueue(4 producers)"s, 1, [&](size_t) {
+            SearchServer queued_server(corpus.stop_words);
+            IngestionQueue queue(queued_server);
+            const size_t count = produce([&](size_t i) {
+                queue.AddDocument(static_cast<int>(i), corpus.documents[i], corpus.statuses[i], corpus.ratings[i]);
+                });
+            queue.Flush();
+            const IngestionQueue::Stats stats = queue.GetStats();
+            std::cerr << "  groups: "s << stats.groups << ", documents per group: "s << stats.documents / std::max<size_t>(stats.groups, 1) << '\n';
+            return count;
+            });
+    }
+
+    {
+        //        :      
+        WalOptions wal_options;
+        wal_options.directory = (std::filesystem::temp_directory_path() / "search_server_benchmark_wal").string();
+        const auto add_document = [&corpus](WriteAheadLog& wal, size_t i) {
+            wal.AddDocument(static_cast<int>(i), corpus.documents[i], corpus.statuses[i], corpus.ratings[i]);
+            return size_t{ 1 };
+        };
+        const size_t synced_count = std::min<size_t>(corpus.documents.size(), 2000);
+
+        std::filesystem::remove_all(wal_options.directory);
+        {
+            SearchServer logged_server(corpus.stop_words);
+            WriteAheadLog wal(logged_server, wal_options);
+            run("AddDocument + WAL(fsync each, 2000)"s, synced_count, [&](size_t i) {
+                return add_document(wal, i);
+                });
+        }
+
+        //       fsync
+        std::filesystem::remove_all(wal_options.directory);
+        {
+            const size_t thread_count = 4;
+            SearchServer logged_server(corpus.stop_words);
+            WriteAheadLog wal(logged_server, wal_options);
+            run("AddDocument + WAL(fsync each, 4 threads)"s, 1, [&](size_t) {
+                std::vector<std::thread> threads;
+                for (size_t t = 0; t < thread_count; ++t) {
+                    threads.emplace_back([&, t] {
+                        for (size_t i = t; i < synced_count; i += thread_count) {
+                            add_document(wal, i);
+                        }
+                        });
+                }
+                for (std::thread& thread : threads) {
+                    thread.join();
+                }
+                const WalStats stats = wal.GetStats();
+                std::cerr << "  records: "s << stats.records << ", fsyncs: "s << stats.syncs << '\n';
+                return synced_count;
+                });
+        }
+
+        std::filesystem::remove_all(wal_options.directory);
+        wal_options.sync_batch_size = 256;
+        {
+            SearchServer logged_server(corpus.stop_words);
+            WriteAheadLog wal(logged_server, wal_options);
+            run("AddDocument + WAL(fsync per 256)"s, corpus.documents.size(), [&](size_t i) {
+                return add_document(wal, i);
+                });
+        }
+        run("WAL recovery(log only)"s, 1, [&](size_t) {
+            SearchServer recovered_server(corpus.stop_words);
+            WriteAheadLog wal(recovered_server, wal_options);
+            return wal.GetRecoveryStats().replayed_records;
+            });
+        {
+            SearchServer logged_server(corpus.stop_words);
+            WriteAheadLog wal(logged_server, wal_options);
+            run("WAL Checkpoint"s, 1, [&](size_t) {
+                wal.Checkpoint();
+                return size_t{ 1 };
+                });
+        }
+        run("WAL recovery(snapshot)"s, 1, [&](size_t) {
+            SearchServer recovered_server(corpus.stop_words);
+            WriteAheadLog wal(recovered_server, wal_options);
+            return wal.GetRecoveryStats().snapshot_documents;
+            });
+        std::filesystem::remove_all(wal_options.directory);
+    }
+
+    const int document_count = search_server.GetDocumentCount();
+    run("MatchDocument(seq)"s, query_count, [&](size_t i) {
+        return std::get<0>(search_server.MatchDocument(std::execution::seq, queries[i], static_cast<int>(i * 7919 % document_count))).size();
+        });
+    run("MatchDocument(par)"s, query_count, [&](size_t i) {
+        return std::get<0>(search_server.MatchDocument(std::execution::par, queries[i], static_cast<int>(i * 7919 % document_count))).size();
+        });
+
+    {
+        // :      
+        std::vector<std::vector<int>> found_ids(query_count);
+        for (size_t i = 0; i < query_count; ++i) {
+            for (const Document& document : search_server.FindTopDocuments(queries[i], [](int, DocumentStatus, int) { return true; })) {
+                found_ids[i].push_back(document.id);
+            }
+        }
+        MatchedDocuments matched;
+        run("MatchDocuments(seq, top results)"s, query_count, [&](size_t i) {
+            search_server.MatchDocuments(std::execution::seq, queries[i], found_ids[i], matched);
+            return matched.size();
+            });
+        run("MatchDocuments(par, top results)"s, query_count, [&](size_t i) {
+            search_server.MatchDocuments(std::execution::par, queries[i], found_ids[i], matched);
+            return matched.size();
+            });
+    }
+
+    run("ProcessQueries (per batch)"s, 10, [&](size_t) {
+        return ProcessQueries(search_server, queries).size();
+        });
+    run("ProcessQueries (per batch, deadline 20ms)"s, 10, [&](size_t) {
+        return ProcessQueries(search_server, queries, QueryDeadline::After(std::chrono::milliseconds(20))).size();
+        });
+
+    {
+        std::vector<Document> documents;
+        for (int i = 0; i < document_count; ++i) {
+            documents.push_back({ i, 1.0 / (i + 1), i % 10 });
+        }
+        run("Paginate (page size 10)"s, 100, [&](size_t) {
+            size_t pages = 0;
+            for (const auto& page : Paginate(documents, 10)) {
+                pages += page.size();
+            }
+            return pages;
+            });
+    }
+
+    {
+        SearchServer dedup_server(corpus.stop_words);
+        FillServer(dedup_server, corpus);
+        // RemoveDuplicates     std::cout
+        std::ostringstream discarded;
+        std::streambuf* cout_buffer = std::cout.rdbuf(discarded.rdbuf());
+        run("RemoveDuplicates"s, 1, [&](size_t) {
+            RemoveDuplicates(dedup_server);
+            return static_cast<size_t>(dedup_server.GetDocumentCount());
+            });
+        std::cout.rdbuf(cout_buffer);
+    }
+
+    const size_t removals = std::min<size_t>(document_count / 2, 2000);
+    run("RemoveDocument(seq)"s, removals, [&](size_t i) {
+        search_server.RemoveDocument(std::execution::seq, static_cast<int>(2 * i));
+        return size_t{ 1 };
+        });
+    run("RemoveDocument(par)"s, removals, [&](size_t i) {
+        search_server.RemoveDocument(std::execution::par, static_cast<int>(2 * i + 1));
+        return size_t{ 1 };
+        });
+
+    std::cout << '\n';
+    PrintHeader(std::cout);
+    for (const BenchmarkResult& result : results) {
+        PrintResult(std::cout, result);
+    }
+    std::cout << "\nindex memory after AddDocument:\n"s << memory_stats.ToText();
+    std::cout << "peak RSS: "s << GetPeakRssKilobytes() << " KB"s << std::endl;
+    return 0;
+}
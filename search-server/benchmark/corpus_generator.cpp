@@ -0,0 +1,114 @@
+#include "corpus_generator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+
+class ZipfSampler {
+public:
+    ZipfSampler(int size, double exponent)
+        : cdf_(size)
+    {
+        double sum = 0;
+        for (int rank = 0; rank < size; ++rank) {
+            sum += 1.0 / std::pow(rank + 1, exponent);
+            cdf_[rank] = sum;
+        }
+        for (double& value : cdf_) {
+            value /= sum;
+        }
+    }
+
+    // uniform -   [0, 1)
+    int Sample(double uniform) const {
+        const auto it = std::upper_bound(cdf_.begin(), cdf_.end(), uniform);
+        return std::min(static_cast<int>(it - cdf_.begin()), static_cast<int>(cdf_.size()) - 1);
+    }
+
+private:
+    std::vector<double> cdf_;
+};
+
+//    [0, 1),      
+double NextUniform(std::mt19937_64& generator) {
+    return (generator() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+int NextInt(std::mt19937_64& generator, int min_value, int max_value) {
+    return min_value + static_cast<int>(generator() % static_cast<uint64_t>(max_value - min_value + 1));
+}
+
+}
+
+std::string MakeVocabularyWord(int rank) {
+    //    26- :     ,   
+    std::string word;
+    int value = rank + 1;
+    while (value > 0) {
+        --value;
+        word.push_back(static_cast<char>('a' + value % 26));
+        value /= 26;
+    }
+    return word;
+}
+
+Corpus GenerateCorpus(const CorpusOptions& options) {
+    std::mt19937_64 generator(options.seed);
+    const ZipfSampler sampler(options.vocabulary_size, options.zipf_exponent);
+
+    Corpus corpus;
+
+    const int stop_word_count = static_cast<int>(options.vocabulary_size * options.stop_word_ratio);
+    for (int rank = 0; rank < stop_word_count; ++rank) {
+        if (rank != 0) {
+            corpus.stop_words += ' ';
+        }
+        corpus.stop_words += MakeVocabularyWord(rank);
+    }
+
+    corpus.documents.reserve(options.document_count);
+    for (int i = 0; i < options.document_count; ++i) {
+        if (i != 0 && NextUniform(generator) < options.duplicate_ratio) {
+            //       -     RemoveDuplicates
+            std::string text = corpus.documents[NextInt(generator, 0, i - 1)];
+            corpus.documents.push_back(text + ' ' + text.substr(0, text.find(' ')));
+        }
+        else {
+            std::string text;
+            for (int j = 0; j < options.document_length; ++j) {
+                if (j != 0) {
+                    text += ' ';
+                }
+                text += MakeVocabularyWord(sampler.Sample(NextUniform(generator)));
+            }
+            corpus.documents.push_back(std::move(text));
+        }
+
+        corpus.statuses.push_back(static_cast<DocumentStatus>(NextInt(generator, 0, 3)));
+
+        std::vector<int> ratings(NextInt(generator, 1, 5));
+        for (int& rating : ratings) {
+            rating = NextInt(generator, -10, 10);
+        }
+        corpus.ratings.push_back(std::move(ratings));
+    }
+
+    corpus.queries.reserve(options.query_count);
+    for (int i = 0; i < options.query_count; ++i) {
+        std::string query;
+        for (int j = 0; j < options.query_length; ++j) {
+            if (j != 0) {
+                query += ' ';
+            }
+            if (NextUniform(generator) < options.minus_word_ratio) {
+                query += '-';
+            }
+            query += MakeVocabularyWord(sampler.Sample(NextUniform(generator)));
+        }
+        corpus.queries.push_back(std::move(query));
+    }
+
+    return corpus;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../document.h"
+
+//   .      
+//   :   std::mt19937_64,   .
+struct CorpusOptions {
+    int document_count = 10000;
+    int document_length = 50;       //   
+    int vocabulary_size = 20000;
+    double zipf_exponent = 1.0;     //    r  1 / r^s
+    double stop_word_ratio = 0.001; //     ,  -
+    int query_count = 1000;
+    int query_length = 5;           //   
+    double minus_word_ratio = 0.2;  //  ,    - -
+    double duplicate_ratio = 0.05;  //  ,     
+    uint64_t seed = 42;
+};
+
+struct Corpus {
+    std::string stop_words;
+    std::vector<std::string> documents;
+    std::vector<DocumentStatus> statuses;
+    std::vector<std::vector<int>> ratings;
+    std::vector<std::string> queries;
+};
+
+//      (0 -  )
+std::string MakeVocabularyWord(int rank);
+
+Corpus GenerateCorpus(const CorpusOptions& options);
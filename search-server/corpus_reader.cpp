@@ -0,0 +1,280 @@
+#include "corpus_reader.h"
+
+#include <algorithm>
+#include <charconv>
+#include <exception>
+#include <execution>
+#include <future>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std::literals;
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path) {
+    file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) {
+        file_ = nullptr;
+        throw std::runtime_error("Cannot open file "s + path);
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file_, &size)) {
+        CloseHandle(file_);
+        throw std::runtime_error("Cannot get size of file "s + path);
+    }
+    size_ = static_cast<size_t>(size.QuadPart);
+    if (size_ == 0) {
+        return;
+    }
+    mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_ != nullptr) {
+        data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (data_ == nullptr) {
+        if (mapping_ != nullptr) {
+            CloseHandle(mapping_);
+        }
+        CloseHandle(file_);
+        throw std::runtime_error("Cannot map file "s + path);
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (data_ != nullptr) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_ != nullptr) {
+        CloseHandle(mapping_);
+    }
+    if (file_ != nullptr) {
+        CloseHandle(file_);
+    }
+}
+
+void MappedFile::Release(size_t, size_t) {
+    //    Windows  
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open file "s + path);
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+        close(fd);
+        throw std::runtime_error("Cannot get size of file "s + path);
+    }
+    size_ = static_cast<size_t>(file_stat.st_size);
+    if (size_ > 0) {
+        void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("Cannot map file "s + path);
+        }
+        data_ = static_cast<const char*>(data);
+        madvise(data, size_, MADV_SEQUENTIAL);
+    }
+    //       
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data_ != nullptr) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+}
+
+void MappedFile::Release(size_t offset, size_t size) {
+    const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t begin = (offset + page_size - 1) / page_size * page_size;
+    const size_t end = std::min(offset + size, size_) / page_size * page_size;
+    if (data_ != nullptr && begin < end) {
+        madvise(const_cast<char*>(data_) + begin, end - begin, MADV_DONTNEED);
+    }
+}
+
+#endif
+
+namespace {
+
+struct CorpusEntry {
+    size_t line_number = 0;
+    int id = 0;
+    DocumentStatus status = DocumentStatus::ACTUAL;
+    std::vector<int> ratings;
+    std::string_view text;
+};
+
+//    begin  end;  ,   ,      
+struct CorpusChunk {
+    size_t begin = 0;
+    size_t end = 0;
+    size_t next_line_number = 0;
+    int next_id = 0;
+    std::vector<CorpusEntry> entries;
+    std::vector<PreparedDocument> documents;
+    std::vector<std::exception_ptr> errors;  //    ,  -  
+    std::exception_ptr parse_error;          //      
+};
+
+std::invalid_argument MakeLineError(size_t line_number, std::string_view message) {
+    return std::invalid_argument("Line "s + std::to_string(line_number) + ": "s + std::string(message));
+}
+
+//   text   separator
+std::string_view ExtractField(std::string_view& text, char separator) {
+    const size_t end = text.find(separator);
+    const std::string_view field = text.substr(0, end);
+    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+    return field;
+}
+
+template <typename Number>
+bool ParseNumber(std::string_view token, Number& value) {
+    const std::from_chars_result result = std::from_chars(token.data(), token.data() + token.size(), value);
+    return !token.empty() && result.ec == std::errc() && result.ptr == token.data() + token.size();
+}
+
+void ParseFramedLine(std::string_view line, CorpusEntry& entry) {
+    const std::string_view id = ExtractField(line, '\t');
+    const std::string_view status = ExtractField(line, '\t');
+    std::string_view ratings = ExtractField(line, '\t');
+    int status_value = 0;
+    if (!ParseNumber(id, entry.id)) {
+        throw MakeLineError(entry.line_number, "invalid document id"sv);
+    }
+    if (!ParseNumber(status, status_value) || status_value < 0 || status_value > static_cast<int>(DocumentStatus::REMOVED)) {
+        throw MakeLineError(entry.line_number, "invalid document status"sv);
+    }
+    entry.status = static_cast<DocumentStatus>(status_value);
+    while (!ratings.empty()) {
+        const std::string_view token = ExtractField(ratings, ' ');
+        if (token.empty()) {
+            continue;
+        }
+        int rating = 0;
+        if (!ParseNumber(token, rating)) {
+            throw MakeLineError(entry.line_number, "invalid rating"sv);
+        }
+        entry.ratings.push_back(rating);
+    }
+    entry.text = line;
+}
+
+CorpusChunk ParseChunk(std::string_view data, size_t begin, size_t line_number, int next_id, const IngestOptions& options) {
+    CorpusChunk chunk;
+    chunk.begin = begin;
+    chunk.end = std::min(data.size(), begin + std::max<size_t>(options.chunk_size, 1));
+    //     ,      
+    if (chunk.end < data.size()) {
+        const size_t line_end = data.find('\n', chunk.end - 1);
+        chunk.end = line_end == std::string_view::npos ? data.size() : line_end + 1;
+    }
+
+    std::string_view text = data.substr(begin, chunk.end - begin);
+    while (!text.empty()) {
+        std::string_view line = ExtractField(text, '\n');
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        const size_t current_line_number = line_number++;
+        if (line.empty()) {
+            continue;
+        }
+
+        CorpusEntry entry;
+        entry.line_number = current_line_number;
+        if (options.format == CorpusFormat::FRAMED) {
+            try {
+                ParseFramedLine(line, entry);
+            }
+            catch (...) {
+                chunk.parse_error = std::current_exception();
+                break;
+            }
+        }
+        else {
+            entry.id = next_id++;
+            entry.text = line;
+        }
+        chunk.entries.push_back(std::move(entry));
+    }
+    chunk.next_line_number = line_number;
+    chunk.next_id = next_id;
+    return chunk;
+}
+
+void PrepareChunk(const SearchServer& search_server, CorpusChunk& chunk) {
+    chunk.documents.resize(chunk.entries.size());
+    chunk.errors.resize(chunk.entries.size());
+    std::transform(std::execution::par, chunk.entries.begin(), chunk.entries.end(), chunk.documents.begin(),
+        [&search_server, &chunk](const CorpusEntry& entry) {
+            try {
+                return search_server.PrepareDocument(entry.id, entry.text, entry.status, entry.ratings);
+            }
+            catch (const std::exception& e) {
+                chunk.errors[&entry - chunk.entries.data()] = std::make_exception_ptr(MakeLineError(entry.line_number, e.what()));
+                return PreparedDocument{};
+            }
+        });
+}
+
+}
+
+size_t IngestCorpus(SearchServer& search_server, const std::string& path, const IngestOptions& options) {
+    MappedFile file(path);
+    const std::string_view data = file.GetData();
+
+    const auto read_chunk = [&search_server, &options, data](size_t begin, size_t line_number, int next_id) {
+        CorpusChunk chunk = ParseChunk(data, begin, line_number, next_id, options);
+        PrepareChunk(search_server, chunk);
+        return chunk;
+    };
+
+    size_t added_count = 0;
+    std::future<CorpusChunk> next_chunk = std::async(std::launch::async, read_chunk, size_t(0), size_t(1), options.first_id);
+    while (true) {
+        CorpusChunk chunk = next_chunk.get();
+        const bool is_last = chunk.end == data.size() || chunk.parse_error;
+        if (!is_last) {
+            // PrepareDocument   ,        
+            next_chunk = std::async(std::launch::async, read_chunk, chunk.end, chunk.next_line_number, chunk.next_id);
+        }
+
+        for (size_t i = 0; i < chunk.documents.size(); ++i) {
+            if (chunk.errors[i]) {
+                std::rethrow_exception(chunk.errors[i]);
+            }
+            try {
+                search_server.AddPreparedDocument(chunk.documents[i]);
+            }
+            catch (const std::exception& e) {
+                throw MakeLineError(chunk.entries[i].line_number, e.what());
+            }
+            ++added_count;
+        }
+        file.Release(chunk.begin, chunk.end - chunk.begin);
+
+        if (chunk.parse_error) {
+            std::rethrow_exception(chunk.parse_error);
+        }
+        if (is_last) {
+            break;
+        }
+    }
+    return added_count;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "search_server.h"
+
+// ,      .      ,
+//        
+class MappedFile {
+public:
+    //  std::runtime_error,       
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    std::string_view GetData() const {
+        return { data_, size_ };
+    }
+
+    //  ,      ;     ,
+    //        
+    void Release(size_t offset, size_t size);
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
+
+enum class CorpusFormat {
+    LINES,  //   , id      first_id,  ACTUAL,  
+    FRAMED, // id<TAB> <TAB>  <TAB>
+};
+
+struct IngestOptions {
+    CorpusFormat format = CorpusFormat::LINES;
+    int first_id = 0;
+    size_t chunk_size = size_t(16) << 20; //     ,     
+};
+
+//       ,   .   :
+//       ,     ,
+//     .  -  .
+//      std::invalid_argument   ;      
+size_t IngestCorpus(SearchServer& search_server, const std::string& path, const IngestOptions& options = {});
@@ -1,11 +1,86 @@
 #include "document.h"
 
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
 Document::Document(int id, double relevance, int rating)
     : id(id)
     , relevance(relevance)
     , rating(rating)
 {}
 
+PageCursor::PageCursor(const Document& last_document)
+    : last_document_(last_document)
+    , is_set_(true)
+{}
+
+bool PageCursor::IsSet() const {
+    return is_set_;
+}
+
+std::string PageCursor::Serialize() const {
+    if (!is_set_) {
+        return {};
+    }
+    //   ,         
+    uint64_t relevance_bits = 0;
+    std::memcpy(&relevance_bits, &last_document_.relevance, sizeof(relevance_bits));
+    std::string text;
+    const auto append_number = [&text](auto value, int base) {
+        //     :        
+        char digits[std::numeric_limits<decltype(value)>::digits + 2];
+        const auto [ptr, ec] = std::to_chars(std::begin(digits), std::end(digits), value, base);
+        if (ec != std::errc()) {
+            throw std::length_error("Page cursor field does not fit the buffer");
+        }
+        text.append(digits, ptr);
+    };
+    append_number(last_document_.id, 10);
+    text += ':';
+    append_number(last_document_.rating, 10);
+    text += ':';
+    append_number(relevance_bits, 16);
+    return text;
+}
+
+PageCursor PageCursor::Parse(std::string_view text) {
+    if (text.empty()) {
+        return {};
+    }
+    Document last_document;
+    uint64_t relevance_bits = 0;
+    const char* const end = text.data() + text.size();
+    //            
+    const auto parse_field = [end](const char* begin, auto& value, int base = 10) {
+        const auto [ptr, ec] = std::from_chars(begin, end, value, base);
+        if (ec != std::errc()) {
+            throw std::invalid_argument("Invalid page cursor");
+        }
+        return ptr;
+    };
+    const auto skip_separator = [end](const char* ptr) {
+        if (ptr == end || *ptr != ':') {
+            throw std::invalid_argument("Invalid page cursor");
+        }
+        return ptr + 1;
+    };
+    const char* ptr = skip_separator(parse_field(text.data(), last_document.id));
+    ptr = skip_separator(parse_field(ptr, last_document.rating));
+    if (parse_field(ptr, relevance_bits, 16) != end) {
+        throw std::invalid_argument("Invalid page cursor");
+    }
+    std::memcpy(&last_document.relevance, &relevance_bits, sizeof(relevance_bits));
+    return PageCursor(last_document);
+}
+
+const Document& PageCursor::GetLastDocument() const {
+    return last_document_;
+}
+
 std::ostream& operator<<(std::ostream& os, const Document& doc) {
     return os << "{ document_id = " << doc.id << ", relevance = " << doc.relevance << ", rating = " << doc.rating << " }";
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ostream>
+#include <string>
 #include <vector>
 #include <string_view>
 
@@ -14,6 +15,45 @@ struct Document {
     int rating = 0;
 };
 
+//    .   SearchServer::FindPage,   .
+//  :   ,         
+class PageCursor {
+public:
+    //   
+    PageCursor() = default;
+
+    bool IsSet() const;
+
+    //    ;     - 
+    std::string Serialize() const;
+    //     Serialize.  std::invalid_argument   
+    static PageCursor Parse(std::string_view text);
+
+private:
+    friend class SearchServer;
+    friend class ShardedSearchServer;
+
+    explicit PageCursor(const Document& last_document);
+
+    //   ;          
+    const Document& GetLastDocument() const;
+
+    Document last_document_;
+    bool is_set_ = false;
+};
+
+struct SearchPage {
+    std::vector<Document> documents;
+    PageCursor next; //     
+    bool has_more = false;
+};
+
+//    .      , documents -    
+struct TopDocumentsResult {
+    std::vector<Document> documents;
+    bool is_complete = true;
+};
+
 enum class DocumentStatus
 {
     ACTUAL,
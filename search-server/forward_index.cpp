@@ -0,0 +1,102 @@
+#include "forward_index.h"
+
+#include <algorithm>
+
+WordFrequencies::Iterator WordFrequencies::find(std::string_view word) const {
+    const uint32_t* const last = term_ids_ + size_;
+    const uint32_t* it = std::lower_bound(term_ids_, last, word,
+        [this](uint32_t term_id, std::string_view word) { return words_[term_id] < word; });
+    if (it == last || words_[*it] != word) {
+        return end();
+    }
+    return begin() + (it - term_ids_);
+}
+
+bool WordFrequencies::operator==(const WordFrequencies& other) const {
+    return size_ == other.size_ && std::equal(begin(), end(), other.begin());
+}
+
+ForwardIndex::ForwardIndex(std::pmr::memory_resource* resource)
+    : term_words_(resource)
+    , free_term_ids_(resource)
+    , term_ids_(resource)
+    , term_freqs_(resource)
+    , documents_(resource)
+{}
+
+uint32_t ForwardIndex::AddTerm(std::string_view word) {
+    if (!free_term_ids_.empty()) {
+        const uint32_t term_id = free_term_ids_.back();
+        free_term_ids_.pop_back();
+        term_words_[term_id] = word;
+        return term_id;
+    }
+    term_words_.push_back(word);
+    return static_cast<uint32_t>(term_words_.size() - 1);
+}
+
+void ForwardIndex::RemoveTerm(uint32_t term_id) {
+    term_words_[term_id] = {};
+    free_term_ids_.push_back(term_id);
+    //   -   ,    
+    if (free_term_ids_.size() == term_words_.size()) {
+        term_words_.clear();
+        term_words_.shrink_to_fit();
+        free_term_ids_.clear();
+        free_term_ids_.shrink_to_fit();
+    }
+}
+
+void ForwardIndex::AddDocument(int document_id, const std::pmr::vector<std::pair<uint32_t, double>>& terms) {
+    documents_[document_id] = { term_ids_.size(), terms.size() };
+    for (const auto& [term_id, term_freq] : terms) {
+        term_ids_.push_back(term_id);
+        term_freqs_.push_back(term_freq);
+    }
+    entry_count_ += terms.size();
+}
+
+void ForwardIndex::RemoveDocument(int document_id) {
+    const auto it = documents_.find(document_id);
+    if (it == documents_.end()) {
+        return;
+    }
+    entry_count_ -= it->second.size;
+    documents_.erase(it);
+    if (term_ids_.size() > 2 * entry_count_) {
+        Compact();
+    }
+}
+
+WordFrequencies ForwardIndex::GetWordFrequencies(int document_id) const {
+    const auto it = documents_.find(document_id);
+    if (it == documents_.end()) {
+        return {};
+    }
+    const Range& range = it->second;
+    return { term_ids_.data() + range.offset, term_freqs_.data() + range.offset, range.size, term_words_.data() };
+}
+
+void ForwardIndex::Compact() {
+    //        ,      
+    //          
+    std::vector<std::pair<size_t, int>> order;
+    order.reserve(documents_.size());
+    for (const auto& [document_id, range] : documents_) {
+        order.emplace_back(range.offset, document_id);
+    }
+    std::sort(order.begin(), order.end());
+
+    size_t offset = 0;
+    for (const auto& [old_offset, document_id] : order) {
+        Range& range = documents_.at(document_id);
+        std::copy(term_ids_.begin() + old_offset, term_ids_.begin() + old_offset + range.size, term_ids_.begin() + offset);
+        std::copy(term_freqs_.begin() + old_offset, term_freqs_.begin() + old_offset + range.size, term_freqs_.begin() + offset);
+        range.offset = offset;
+        offset += range.size;
+    }
+    term_ids_.resize(offset);
+    term_freqs_.resize(offset);
+    term_ids_.shrink_to_fit();
+    term_freqs_.shrink_to_fit();
+}
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <memory_resource>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+//     ,   .   : ,
+//  ,   ,  
+class WordFrequencies {
+public:
+    using value_type = std::pair<std::string_view, double>;
+
+    //     ,     ,
+    //     
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = WordFrequencies::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        //    ,  it->first     
+        struct ArrowProxy {
+            value_type value;
+            const value_type* operator->() const {
+                return &value;
+            }
+        };
+
+        Iterator() = default;
+        Iterator(const uint32_t* term_id, const double* term_freq, const std::string_view* words)
+            : term_id_(term_id), term_freq_(term_freq), words_(words)
+        {}
+
+        value_type operator*() const {
+            return { words_[*term_id_], *term_freq_ };
+        }
+
+        ArrowProxy operator->() const {
+            return { **this };
+        }
+
+        Iterator& operator++() {
+            ++term_id_;
+            ++term_freq_;
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+
+        Iterator& operator--() {
+            --term_id_;
+            --term_freq_;
+            return *this;
+        }
+
+        Iterator operator--(int) {
+            Iterator previous = *this;
+            --*this;
+            return previous;
+        }
+
+        Iterator& operator+=(difference_type offset) {
+            term_id_ += offset;
+            term_freq_ += offset;
+            return *this;
+        }
+
+        Iterator& operator-=(difference_type offset) {
+            return *this += -offset;
+        }
+
+        Iterator operator+(difference_type offset) const {
+            Iterator result = *this;
+            return result += offset;
+        }
+
+        friend Iterator operator+(difference_type offset, const Iterator& it) {
+            return it + offset;
+        }
+
+        Iterator operator-(difference_type offset) const {
+            Iterator result = *this;
+            return result -= offset;
+        }
+
+        difference_type operator-(const Iterator& other) const {
+            return term_id_ - other.term_id_;
+        }
+
+        value_type operator[](difference_type offset) const {
+            return *(*this + offset);
+        }
+
+        bool operator==(const Iterator& other) const {
+            return term_id_ == other.term_id_;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return term_id_ != other.term_id_;
+        }
+
+        bool operator<(const Iterator& other) const {
+            return term_id_ < other.term_id_;
+        }
+
+        bool operator>(const Iterator& other) const {
+            return other < *this;
+        }
+
+        bool operator<=(const Iterator& other) const {
+            return !(other < *this);
+        }
+
+        bool operator>=(const Iterator& other) const {
+            return !(*this < other);
+        }
+
+    private:
+        const uint32_t* term_id_ = nullptr;
+        const double* term_freq_ = nullptr;
+        const std::string_view* words_ = nullptr;
+    };
+
+    WordFrequencies() = default;
+    WordFrequencies(const uint32_t* term_ids, const double* term_freqs, size_t size, const std::string_view* words)
+        : term_ids_(term_ids), term_freqs_(term_freqs), size_(size), words_(words)
+    {}
+
+    Iterator begin() const {
+        return { term_ids_, term_freqs_, words_ };
+    }
+
+    Iterator end() const {
+        return { term_ids_ + size_, term_freqs_ + size_, words_ };
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    //    
+    Iterator find(std::string_view word) const;
+
+    size_t count(std::string_view word) const {
+        return find(word) != end() ? 1 : 0;
+    }
+
+    //    ,      
+    bool operator==(const WordFrequencies& other) const;
+
+    bool operator!=(const WordFrequencies& other) const {
+        return !(*this == other);
+    }
+
+private:
+    const uint32_t* term_ids_ = nullptr;
+    const double* term_freqs_ = nullptr;
+    size_t size_ = 0;
+    const std::string_view* words_ = nullptr;
+};
+
+//  :    -  ( , ),   .
+//         ,      .
+//     ,      
+class ForwardIndex {
+public:
+    explicit ForwardIndex(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    //  ;     . string_view    RemoveTerm
+    uint32_t AddTerm(std::string_view word);
+
+    //        
+    void RemoveTerm(uint32_t term_id);
+
+    // terms -  ( , ),   
+    void AddDocument(int document_id, const std::pmr::vector<std::pair<uint32_t, double>>& terms);
+
+    void RemoveDocument(int document_id);
+
+    //    -  
+    WordFrequencies GetWordFrequencies(int document_id) const;
+
+    // -  (, )   
+    size_t GetEntryCount() const {
+        return entry_count_;
+    }
+
+private:
+    struct Range {
+        size_t offset = 0;
+        size_t size = 0;
+    };
+
+    void Compact();
+
+    std::pmr::vector<std::string_view> term_words_; //   
+    std::pmr::vector<uint32_t> free_term_ids_;
+    std::pmr::vector<uint32_t> term_ids_;
+    std::pmr::vector<double> term_freqs_;
+    std::pmr::map<int, Range> documents_;
+    size_t entry_count_ = 0;
+};
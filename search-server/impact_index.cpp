@@ -0,0 +1,117 @@
+#include "impact_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+//        id,      ;
+//   scores -    id,   
+template <typename Impact>
+void AccumulateImpacts(const int* document_ids, const Impact* impacts, size_t count, float factor, float* scores) {
+    const size_t BLOCK_SIZE = 16;
+    float contributions[BLOCK_SIZE];
+    size_t i = 0;
+    for (; i + BLOCK_SIZE <= count; i += BLOCK_SIZE) {
+        for (size_t j = 0; j < BLOCK_SIZE; ++j) {
+            contributions[j] = static_cast<float>(impacts[i + j]) * factor;
+        }
+        for (size_t j = 0; j < BLOCK_SIZE; ++j) {
+            scores[document_ids[i + j]] += contributions[j];
+        }
+    }
+    for (; i < count; ++i) {
+        scores[document_ids[i]] += static_cast<float>(impacts[i]) * factor;
+    }
+}
+
+}
+
+ImpactIndex::ImpactIndex(int bits, std::pmr::memory_resource* resource)
+    : bits_(bits)
+    , max_impact_(bits == 0 ? 0 : (uint32_t{ 1 } << bits) - 1)
+    , postings_(resource)
+{
+    if (bits != 0 && bits != 8 && bits != 16) {
+        throw std::invalid_argument("Impact bits must be 0, 8 or 16");
+    }
+}
+
+uint32_t ImpactIndex::Quantize(double term_freq, double max_term_freq) const {
+    const double impact = std::round(term_freq / max_term_freq * max_impact_);
+    return std::clamp(static_cast<uint32_t>(impact), uint32_t{ 1 }, max_impact_);
+}
+
+void ImpactIndex::AddPosting(std::string_view word, const std::pmr::map<int, double>& document_freqs, int document_id) {
+    Postings& postings = postings_.try_emplace(word, postings_.get_allocator().resource()).first->second;
+    const double term_freq = document_freqs.at(document_id);
+
+    if (term_freq > postings.max_term_freq) {
+        postings.max_term_freq = term_freq;
+        postings.document_ids.clear();
+        postings.impacts8.clear();
+        postings.impacts16.clear();
+        for (const auto& [id, freq] : document_freqs) {
+            postings.document_ids.push_back(id);
+            if (bits_ == 8) {
+                postings.impacts8.push_back(static_cast<uint8_t>(Quantize(freq, term_freq)));
+            }
+            else {
+                postings.impacts16.push_back(static_cast<uint16_t>(Quantize(freq, term_freq)));
+            }
+        }
+        return;
+    }
+
+    const auto it = std::lower_bound(postings.document_ids.begin(), postings.document_ids.end(), document_id);
+    const size_t index = it - postings.document_ids.begin();
+    postings.document_ids.insert(it, document_id);
+    if (bits_ == 8) {
+        postings.impacts8.insert(postings.impacts8.begin() + index, static_cast<uint8_t>(Quantize(term_freq, postings.max_term_freq)));
+    }
+    else {
+        postings.impacts16.insert(postings.impacts16.begin() + index, static_cast<uint16_t>(Quantize(term_freq, postings.max_term_freq)));
+    }
+}
+
+void ImpactIndex::RemovePosting(std::string_view word, int document_id) {
+    const auto postings_it = postings_.find(word);
+    if (postings_it == postings_.end()) {
+        return;
+    }
+    Postings& postings = postings_it->second;
+    const auto it = std::lower_bound(postings.document_ids.begin(), postings.document_ids.end(), document_id);
+    if (it == postings.document_ids.end() || *it != document_id) {
+        return;
+    }
+    const size_t index = it - postings.document_ids.begin();
+    postings.document_ids.erase(it);
+    if (bits_ == 8) {
+        postings.impacts8.erase(postings.impacts8.begin() + index);
+    }
+    else {
+        postings.impacts16.erase(postings.impacts16.begin() + index);
+    }
+}
+
+void ImpactIndex::RemoveWord(std::string_view word) {
+    postings_.erase(word);
+}
+
+size_t ImpactIndex::Accumulate(std::string_view word, double inverse_document_freq, float* scores) const {
+    const auto it = postings_.find(word);
+    if (it == postings_.end()) {
+        return 0;
+    }
+    const Postings& postings = it->second;
+    const float factor = static_cast<float>(postings.max_term_freq / max_impact_ * inverse_document_freq);
+    const size_t count = postings.document_ids.size();
+    if (bits_ == 8) {
+        AccumulateImpacts(postings.document_ids.data(), postings.impacts8.data(), count, factor, scores);
+    }
+    else {
+        AccumulateImpacts(postings.document_ids.data(), postings.impacts16.data(), count, factor, scores);
+    }
+    return count;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+//      (impact)    .
+//      bits    : tf ~ impact * scale, scale = max_tf / (2^bits - 1).
+//      ,     (, )   scale,
+//    -  scale * idf   .
+//   -   id  ,   
+class ImpactIndex {
+public:
+    // bits - 0 (  ), 8  16;  std::invalid_argument
+    explicit ImpactIndex(int bits, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    //   document_id   document_freqs  word.   
+    //  ,          document_freqs.
+    // string_view  ,      
+    void AddPosting(std::string_view word, const std::pmr::map<int, double>& document_freqs, int document_id);
+
+    //    .        
+    void RemovePosting(std::string_view word, int document_id);
+
+    void RemoveWord(std::string_view word);
+
+    // scores[id] += tf * inverse_document_freq    ; scores    id.
+    //  -  
+    size_t Accumulate(std::string_view word, double inverse_document_freq, float* scores) const;
+
+private:
+    struct Postings {
+        explicit Postings(std::pmr::memory_resource* resource)
+            : document_ids(resource), impacts8(resource), impacts16(resource)
+        {}
+
+        std::pmr::vector<int> document_ids; //  
+        std::pmr::vector<uint8_t> impacts8;  //   bits == 8
+        std::pmr::vector<uint16_t> impacts16; //   bits == 16
+        double max_term_freq = 0.0;
+    };
+
+    uint32_t Quantize(double term_freq, double max_term_freq) const;
+
+    const int bits_;
+    const uint32_t max_impact_;
+    std::pmr::map<std::string_view, Postings> postings_;
+};
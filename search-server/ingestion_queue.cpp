@@ -0,0 +1,134 @@
+#include "ingestion_queue.h"
+
+#include <algorithm>
+#include <exception>
+#include <execution>
+#include <memory>
+#include <utility>
+
+IngestionQueue::IngestionQueue(SearchServer& search_server)
+    : IngestionQueue(search_server, Options{})
+{}
+
+IngestionQueue::IngestionQueue(SearchServer& search_server, const Options& options)
+    : search_server_(search_server)
+    , options_(options)
+{
+    indexer_ = std::thread([this] { RunIndexer(); });
+}
+
+IngestionQueue::~IngestionQueue() {
+    {
+        std::lock_guard lock(wake_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    indexer_.join();
+}
+
+std::future<void> IngestionQueue::AddDocument(int document_id, std::string document, DocumentStatus status, std::vector<int> ratings) {
+    auto entry = std::make_unique<Entry>();
+    entry->id = document_id;
+    entry->text = std::move(document);
+    entry->status = status;
+    entry->ratings = std::move(ratings);
+    std::future<void> result = entry->done.get_future();
+
+    enqueued_count_.fetch_add(1);
+    Entry* const pushed = entry.release();
+    pushed->next = head_.load();
+    while (!head_.compare_exchange_weak(pushed->next, pushed)) {
+    }
+    //       head_,     ,   - 
+    if (indexer_waiting_.load()) {
+        std::lock_guard lock(wake_mutex_);
+        wake_.notify_one();
+    }
+    return result;
+}
+
+void IngestionQueue::Flush() {
+    const size_t target = enqueued_count_.load();
+    std::unique_lock lock(done_mutex_);
+    done_.wait(lock, [this, target] { return processed_count_ >= target; });
+}
+
+IngestionQueue::Stats IngestionQueue::GetStats() const {
+    std::lock_guard lock(done_mutex_);
+    return { processed_count_, group_count_ };
+}
+
+void IngestionQueue::RunIndexer() {
+    std::vector<Entry*> pending;
+    std::vector<Entry*> group;
+    while (true) {
+        //     : ,   ,   
+        const bool stopping = stopping_.load();
+        Entry* stack = head_.exchange(nullptr);
+        if (stack == nullptr) {
+            if (stopping) {
+                return;
+            }
+            std::unique_lock lock(wake_mutex_);
+            indexer_waiting_ = true;
+            wake_.wait(lock, [this] { return head_.load() != nullptr || stopping_.load(); });
+            indexer_waiting_ = false;
+            continue;
+        }
+
+        //       
+        pending.clear();
+        for (; stack != nullptr; stack = stack->next) {
+            pending.push_back(stack);
+        }
+        std::reverse(pending.begin(), pending.end());
+        const size_t group_size = std::max<size_t>(options_.max_group_size, 1);
+        for (size_t begin = 0; begin < pending.size(); begin += group_size) {
+            group.assign(pending.begin() + begin, pending.begin() + std::min(pending.size(), begin + group_size));
+            ProcessGroup(group);
+        }
+    }
+}
+
+void IngestionQueue::ProcessGroup(std::vector<Entry*>& group) {
+    // PrepareDocument   ,     ,
+    //       
+    std::vector<PreparedDocument> documents(group.size());
+    std::vector<std::exception_ptr> errors(group.size());
+    std::transform(std::execution::par, group.begin(), group.end(), documents.begin(),
+        [this, &group, &errors](Entry* const& entry) {
+            try {
+                return search_server_.PrepareDocument(entry->id, entry->text, entry->status, entry->ratings);
+            }
+            catch (...) {
+                errors[&entry - group.data()] = std::current_exception();
+                return PreparedDocument{};
+            }
+        });
+    for (size_t i = 0; i < group.size(); ++i) {
+        if (!errors[i]) {
+            try {
+                search_server_.AddPreparedDocument(documents[i]);
+            }
+            catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    }
+
+    for (size_t i = 0; i < group.size(); ++i) {
+        const std::unique_ptr<Entry> entry(group[i]);
+        if (errors[i]) {
+            entry->done.set_exception(errors[i]);
+        }
+        else {
+            entry->done.set_value();
+        }
+    }
+    {
+        std::lock_guard lock(done_mutex_);
+        processed_count_ += group.size();
+        ++group_count_;
+    }
+    done_.notify_all();
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "search_server.h"
+
+//      .     
+//   (CAS  ),  -     ,
+//    (PrepareDocument)   ,   .
+//    ;    ,    ( Flush)
+class IngestionQueue {
+public:
+    struct Options {
+        //  - ,     
+        size_t max_group_size = 4096;
+    };
+
+    struct Stats {
+        size_t documents = 0; //  ,   
+        size_t groups = 0;
+    };
+
+    explicit IngestionQueue(SearchServer& search_server);
+    IngestionQueue(SearchServer& search_server, const Options& options);
+    //     
+    ~IngestionQueue();
+
+    IngestionQueue(const IngestionQueue&) = delete;
+    IngestionQueue& operator=(const IngestionQueue&) = delete;
+
+    //      .        .
+    // future  ,   ,   ,     
+    std::future<void> AddDocument(int document_id, std::string document, DocumentStatus status, std::vector<int> ratings);
+
+    // ,     ,     
+    void Flush();
+
+    Stats GetStats() const;
+
+private:
+    struct Entry {
+        int id = 0;
+        std::string text;
+        DocumentStatus status = DocumentStatus::ACTUAL;
+        std::vector<int> ratings;
+        std::promise<void> done;
+        Entry* next = nullptr;
+    };
+
+    void RunIndexer();
+    void ProcessGroup(std::vector<Entry*>& group);
+
+    SearchServer& search_server_;
+    const Options options_;
+
+    std::atomic<Entry*> head_ = nullptr;   //   , next - 
+    std::atomic<size_t> enqueued_count_ = 0;
+    std::atomic<bool> indexer_waiting_ = false;
+    std::atomic<bool> stopping_ = false;
+    std::mutex wake_mutex_;                //    
+    std::condition_variable wake_;
+
+    mutable std::mutex done_mutex_;
+    std::condition_variable done_;
+    size_t processed_count_ = 0;
+    size_t group_count_ = 0;
+
+    std::thread indexer_;
+};
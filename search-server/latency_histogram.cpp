@@ -0,0 +1,82 @@
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+int LatencyHistogram::GetBucketIndex(uint64_t value) {
+    //   SUB_BUCKET_COUNT       
+    if (value < static_cast<uint64_t>(SUB_BUCKET_COUNT)) {
+        return static_cast<int>(value);
+    }
+    //  range >= 1 -  [2^(range + SUB_BUCKET_BITS - 1), 2^(range + SUB_BUCKET_BITS)),
+    //   SUB_BUCKET_BITS   
+    const int range = 63 - __builtin_clzll(value) - SUB_BUCKET_BITS + 1;
+    const int sub_bucket = static_cast<int>(value >> (range - 1)) - SUB_BUCKET_COUNT;
+    return range * SUB_BUCKET_COUNT + sub_bucket;
+}
+
+uint64_t LatencyHistogram::GetBucketUpperBound(int index) {
+    const int range = index / SUB_BUCKET_COUNT;
+    const uint64_t sub_bucket = static_cast<uint64_t>(index % SUB_BUCKET_COUNT);
+    if (range == 0) {
+        return sub_bucket;
+    }
+    const uint64_t lower = (SUB_BUCKET_COUNT + sub_bucket) << (range - 1);
+    return lower + ((uint64_t{ 1 } << (range - 1)) - 1);
+}
+
+void LatencyHistogram::Record(uint64_t value) {
+    counts_[GetBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t curr_max = max_value_.load(std::memory_order_relaxed);
+    while (value > curr_max && !max_value_.compare_exchange_weak(curr_max, value, std::memory_order_relaxed)) {
+    }
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::GetSnapshot() const {
+    Snapshot snapshot;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        snapshot.counts[i] = counts_[i].load(std::memory_order_relaxed);
+        snapshot.total_count += snapshot.counts[i];
+    }
+    snapshot.max_value = max_value_.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+void LatencyHistogram::Reset() {
+    for (auto& count : counts_) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    max_value_.store(0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::Snapshot::Record(uint64_t value) {
+    ++counts[GetBucketIndex(value)];
+    ++total_count;
+    max_value = std::max(max_value, value);
+}
+
+void LatencyHistogram::Snapshot::Merge(const Snapshot& other) {
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        counts[i] += other.counts[i];
+    }
+    total_count += other.total_count;
+    max_value = std::max(max_value, other.max_value);
+}
+
+uint64_t LatencyHistogram::Snapshot::GetValueAtPercentile(double percentile) const {
+    if (total_count == 0) {
+        return 0;
+    }
+    percentile = std::clamp(percentile, 0.0, 100.0);
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * total_count)));
+
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return std::min(GetBucketUpperBound(i), max_value);
+        }
+    }
+    return max_value;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+//     HDR:   SUB_BUCKET_COUNT  ,  
+//   [2^k, 2^(k+1))     SUB_BUCKET_COUNT  .
+//      1 / SUB_BUCKET_COUNT.
+//  - O(1)   ,          .
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 4;
+    static const int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static const int RANGE_COUNT = 64 - SUB_BUCKET_BITS + 1;
+    static const int BUCKET_COUNT = RANGE_COUNT * SUB_BUCKET_COUNT;
+
+    //   ,       
+    struct Snapshot {
+        std::array<uint64_t, BUCKET_COUNT> counts = {};
+        uint64_t total_count = 0;
+        uint64_t max_value = 0;
+
+        void Record(uint64_t value);
+        void Merge(const Snapshot& other);
+        // percentile   [0, 100];     0
+        uint64_t GetValueAtPercentile(double percentile) const;
+    };
+
+    LatencyHistogram() = default;
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void Record(uint64_t value);
+
+    Snapshot GetSnapshot() const;
+
+    void Reset();
+
+    static int GetBucketIndex(uint64_t value);
+    //   ,   
+    static uint64_t GetBucketUpperBound(int index);
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> counts_ = {};
+    std::atomic<uint64_t> max_value_ = 0;
+};
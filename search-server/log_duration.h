@@ -3,6 +3,8 @@
 #include <chrono>
 #include <iostream>
 
+#include "trace_recorder.h"
+
 #define PROFILE_CONCAT_INTERNAL(X, Y) X##Y
 #define PROFILE_CONCAT(X, Y) PROFILE_CONCAT_INTERNAL(X, Y)
 #define UNIQUE_VAR_NAME_PROFILE PROFILE_CONCAT(profileGuard, __LINE__)
@@ -10,6 +12,9 @@
 
 #define LOG_DURATION_STREAM(x, out) LogDuration UNIQUE_VAR_NAME_PROFILE(x, out)
 
+//    TraceRecorder    , x -  
+#define TRACE_DURATION(x) TraceSpan UNIQUE_VAR_NAME_PROFILE(x)
+
 class LogDuration {
 public:
     //    std::chrono::steady_clock
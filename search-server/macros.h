@@ -47,7 +47,8 @@ void AssertImpl(bool value, const string& expr_str, const string& file, const st
 #define ASSERT_HINT(expr, hint) AssertImpl((expr), #expr, __FILE__, __FUNCTION__, __LINE__, (hint))
 
 template <typename T>
-void RunTestImpl(const T&, const string& t_str) {
+void RunTestImpl(const T& func, const string& t_str) {
+    func();
     cerr << t_str << " OK"s << endl;
 }
 
@@ -0,0 +1,85 @@
+#include "memory_stats.h"
+
+#include <sstream>
+
+CountingResource::CountingResource(std::pmr::memory_resource* upstream)
+    : upstream_(upstream)
+{}
+
+size_t CountingResource::GetAllocatedBytes() const {
+    return allocated_bytes_.load(std::memory_order_relaxed);
+}
+
+size_t CountingResource::GetBlockCount() const {
+    return block_count_.load(std::memory_order_relaxed);
+}
+
+void* CountingResource::do_allocate(size_t bytes, size_t alignment) {
+    void* p = upstream_->allocate(bytes, alignment);
+    allocated_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    block_count_.fetch_add(1, std::memory_order_relaxed);
+    return p;
+}
+
+void CountingResource::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    upstream_->deallocate(p, bytes, alignment);
+    allocated_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+    block_count_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+const char* GetMemoryStructureName(MemoryStructure structure) {
+    switch (structure) {
+    case MemoryStructure::TERM_DICTIONARY:
+        return "term_dictionary";
+    case MemoryStructure::INVERTED_POSTINGS:
+        return "inverted_postings";
+    case MemoryStructure::FORWARD_INDEX:
+        return "forward_index";
+    case MemoryStructure::DOCUMENT_METADATA:
+        return "document_metadata";
+    case MemoryStructure::STOP_WORDS:
+        return "stop_words";
+    case MemoryStructure::POSITIONS:
+        return "positions";
+    case MemoryStructure::TRIGRAMS:
+        return "trigrams";
+    case MemoryStructure::IMPACTS:
+        return "impacts";
+    case MemoryStructure::TERM_BITMAPS:
+        return "term_bitmaps";
+    default:
+        return "unknown";
+    }
+}
+
+std::string MemoryStats::ToText() const {
+    std::ostringstream os;
+    for (size_t i = 0; i < structures.size(); ++i) {
+        os << GetMemoryStructureName(static_cast<MemoryStructure>(i)) << ": " << structures[i].bytes
+            << " bytes, " << structures[i].entries << " entries\n";
+    }
+    os << "used: " << used_bytes << " bytes, reserved: " << reserved_bytes
+        << " bytes, allocator overhead: " << allocator_overhead_bytes
+        << " bytes, fragmentation: " << fragmentation << '\n';
+    return os.str();
+}
+
+std::string MemoryStats::ToJson() const {
+    std::ostringstream os;
+    os << "{\"structures\": {";
+    for (size_t i = 0; i < structures.size(); ++i) {
+        if (i != 0) {
+            os << ", ";
+        }
+        os << '"' << GetMemoryStructureName(static_cast<MemoryStructure>(i)) << "\": {\"bytes\": "
+            << structures[i].bytes << ", \"entries\": " << structures[i].entries << '}';
+    }
+    os << "}, \"used_bytes\": " << used_bytes << ", \"reserved_bytes\": " << reserved_bytes
+        << ", \"allocator_overhead_bytes\": " << allocator_overhead_bytes
+        << ", \"fragmentation\": " << fragmentation << '}';
+    return os.str();
+}
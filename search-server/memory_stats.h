@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+
+// ,       .  ,
+//       ,    upstream
+class CountingResource : public std::pmr::memory_resource {
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream);
+
+    size_t GetAllocatedBytes() const;
+    size_t GetBlockCount() const;
+
+private:
+    std::pmr::memory_resource* upstream_;
+    std::atomic<size_t> allocated_bytes_ = 0;
+    std::atomic<size_t> block_count_ = 0;
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+//  SearchServer,    
+enum class MemoryStructure {
+    TERM_DICTIONARY,    //   (buffer_),  - 
+    INVERTED_POSTINGS,  //   ,  -  (, )
+    FORWARD_INDEX,      //    ,  -  (, )
+    DOCUMENT_METADATA,  // ,    id,  - 
+    STOP_WORDS,         //  - -;     
+    POSITIONS,          //  ,  - 
+    TRIGRAMS,           //   ,  -  (, )
+    IMPACTS,            //  ,  -  (, )
+    TERM_BITMAPS,       //     ,  -  (, )
+    COUNT
+};
+
+const char* GetMemoryStructureName(MemoryStructure structure);
+
+struct MemoryUsage {
+    size_t bytes = 0;
+    size_t entries = 0;
+};
+
+struct MemoryStats {
+    std::array<MemoryUsage, static_cast<size_t>(MemoryStructure::COUNT)> structures;
+    size_t used_bytes = 0;               //   
+    size_t reserved_bytes = 0;           //     
+    size_t allocator_overhead_bytes = 0; //  ,   :       
+    double fragmentation = 0.0;          //   ,   
+
+    const MemoryUsage& operator[](MemoryStructure structure) const {
+        return structures[static_cast<size_t>(structure)];
+    }
+
+    std::string ToText() const;
+    std::string ToJson() const;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
-#include <vector>
+#include <iterator>
+#include <stdexcept>
 
 template <typename Iterator>
 class IteratorRange {
@@ -26,56 +27,99 @@ private:
     size_t size_;
 };
 
+//   :      ,
+//   Paginator          
 template <typename Iterator>
 class Paginator {
 public:
-    explicit Paginator(Iterator range_begin, Iterator range_end, size_t page_size)
-        : pages_()
-    {
+    class PageIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = IteratorRange<Iterator>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = IteratorRange<Iterator>;
+
+        PageIterator(Iterator page_begin, Iterator range_end, size_t page_size)
+            : page_begin_(page_begin), page_end_(page_begin), range_end_(range_end), page_size_(page_size)
+        {
+            page_end_ = AdvanceBounded(page_begin_);
+        }
 
-        size_t count_items = distance(range_begin, range_end);
-        int count_of_pages = count_items / page_size;
+        IteratorRange<Iterator> operator*() const {
+            return IteratorRange<Iterator>(page_begin_, page_end_);
+        }
 
-        //  ,    
-        if (count_items % page_size != 0) {
-            ++count_of_pages;
+        PageIterator& operator++() {
+            page_begin_ = page_end_;
+            page_end_ = AdvanceBounded(page_begin_);
+            return *this;
         }
 
-        for (int i = 0; i < count_of_pages; ++i) {
-            //   ,    ,  
-            if (i == count_of_pages - 1) {
-                AddPage(range_begin, range_end);
-                continue;
-            }
+        PageIterator operator++(int) {
+            PageIterator prev = *this;
+            ++(*this);
+            return prev;
+        }
+
+        bool operator==(const PageIterator& other) const {
+            return page_begin_ == other.page_begin_;
+        }
+
+        bool operator!=(const PageIterator& other) const {
+            return !(*this == other);
+        }
 
-            AddPage(range_begin, range_begin + page_size);
-            advance(range_begin, page_size);
+    private:
+        Iterator page_begin_;
+        Iterator page_end_;
+        Iterator range_end_;
+        size_t page_size_;
+
+        //    ,     
+        Iterator AdvanceBounded(Iterator it) const {
+            const size_t left = static_cast<size_t>(distance(it, range_end_));
+            advance(it, left < page_size_ ? left : page_size_);
+            return it;
         }
+    };
 
+    explicit Paginator(Iterator range_begin, Iterator range_end, size_t page_size)
+        : range_begin_(range_begin), range_end_(range_end), page_size_(page_size)
+    {
+        if (page_size_ == 0) {
+            throw std::invalid_argument("Page size must be positive");
+        }
+
+        size_t count_items = distance(range_begin, range_end);
+        count_of_pages_ = count_items / page_size;
+
+        //  ,   
+        if (count_items % page_size != 0) {
+            ++count_of_pages_;
+        }
     }
 
-    typename std::vector<IteratorRange<Iterator>>::const_iterator begin() const {
-        return pages_.begin();
+    PageIterator begin() const {
+        return PageIterator(range_begin_, range_end_, page_size_);
     }
 
-    typename std::vector<IteratorRange<Iterator>>::const_iterator end() const {
-        return pages_.end();
+    PageIterator end() const {
+        return PageIterator(range_end_, range_end_, page_size_);
     }
 
     size_t size() const {
-        return pages_.size();
+        return count_of_pages_;
     }
 
 private:
-    std::vector<IteratorRange<Iterator>> pages_;
-
-    void AddPage(Iterator range_begin, Iterator range_end) {
-        IteratorRange<Iterator> page(range_begin, range_end);
-        pages_.push_back(page);
-    }
+    Iterator range_begin_;
+    Iterator range_end_;
+    size_t page_size_;
+    size_t count_of_pages_ = 0;
 };
 
 template <typename Container>
 auto Paginate(const Container& c, size_t page_size) {
     return Paginator(begin(c), end(c), page_size);
-}
\ No newline at end of file
+}
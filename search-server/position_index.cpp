@@ -0,0 +1,98 @@
+#include "position_index.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+void EncodeVarint(uint32_t value, std::pmr::vector<uint8_t>& out) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+}
+
+PositionIndex::PositionIndex(std::pmr::memory_resource* resource)
+    : documents_(resource)
+{}
+
+void PositionIndex::AddDocument(int document_id, const std::pmr::vector<std::string_view>& words, const std::pmr::vector<uint32_t>& positions) {
+    //   (, ):        
+    std::vector<uint32_t> order(words.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) {
+        return words[lhs] != words[rhs] ? words[lhs] < words[rhs] : positions[lhs] < positions[rhs];
+        });
+
+    DocumentPositions document(documents_.get_allocator().resource());
+    document.data.reserve(words.size());
+    uint32_t previous = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        const std::string_view word = words[order[i]];
+        if (i == 0 || word != document.words.back()) {
+            document.words.push_back(word);
+            document.offsets.push_back(static_cast<uint32_t>(document.data.size()));
+            previous = 0;
+        }
+        const uint32_t position = positions[order[i]];
+        EncodeVarint(position - previous, document.data);
+        previous = position;
+    }
+    document.offsets.push_back(static_cast<uint32_t>(document.data.size()));
+    document.data.shrink_to_fit();
+    document.position_count = positions.size();
+
+    encoded_size_ += document.data.size();
+    position_count_ += document.position_count;
+    documents_.emplace(document_id, std::move(document));
+}
+
+void PositionIndex::RemoveDocument(int document_id) {
+    const auto it = documents_.find(document_id);
+    if (it != documents_.end()) {
+        encoded_size_ -= it->second.data.size();
+        position_count_ -= it->second.position_count;
+        documents_.erase(it);
+    }
+}
+
+bool PositionIndex::GetPositions(int document_id, std::string_view word, std::pmr::vector<uint32_t>& positions) const {
+    positions.clear();
+    const auto document_it = documents_.find(document_id);
+    if (document_it == documents_.end()) {
+        return false;
+    }
+    const DocumentPositions& document = document_it->second;
+    const auto word_it = std::lower_bound(document.words.begin(), document.words.end(), word);
+    if (word_it == document.words.end() || *word_it != word) {
+        return false;
+    }
+
+    const size_t index = word_it - document.words.begin();
+    uint32_t position = 0;
+    uint32_t value = 0;
+    int shift = 0;
+    for (uint32_t i = document.offsets[index]; i < document.offsets[index + 1]; ++i) {
+        value |= static_cast<uint32_t>(document.data[i] & 0x7F) << shift;
+        if ((document.data[i] & 0x80) != 0) {
+            shift += 7;
+            continue;
+        }
+        position += value;
+        positions.push_back(position);
+        value = 0;
+        shift = 0;
+    }
+    return true;
+}
+
+size_t PositionIndex::GetEncodedSize() const {
+    return encoded_size_;
+}
+
+size_t PositionIndex::GetPositionCount() const {
+    return position_count_;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+//    .    ,       .
+//           varint (7   ),
+//       
+class PositionIndex {
+public:
+    explicit PositionIndex(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // words  positions -   ( -)        ;
+    // string_view     
+    void AddDocument(int document_id, const std::pmr::vector<std::string_view>& words, const std::pmr::vector<uint32_t>& positions);
+
+    void RemoveDocument(int document_id);
+
+    //   positions     .
+    //  false,         
+    bool GetPositions(int document_id, std::string_view word, std::pmr::vector<uint32_t>& positions) const;
+
+    //       
+    size_t GetEncodedSize() const;
+
+    // -   
+    size_t GetPositionCount() const;
+
+private:
+    struct DocumentPositions {
+        explicit DocumentPositions(std::pmr::memory_resource* resource)
+            : words(resource), offsets(resource), data(resource)
+        {}
+
+        std::pmr::vector<std::string_view> words; //    
+        std::pmr::vector<uint32_t> offsets;       //   words[i]   data[offsets[i], offsets[i + 1])
+        std::pmr::vector<uint8_t> data;
+        size_t position_count = 0;
+    };
+
+    std::pmr::map<int, DocumentPositions> documents_;
+    size_t encoded_size_ = 0;
+    size_t position_count_ = 0;
+};
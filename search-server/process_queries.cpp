@@ -3,14 +3,40 @@
 #include <numeric>
 #include <execution>
 
+#include "log_duration.h"
+
 std::vector<std::vector<Document>> ProcessQueries(const SearchServer& search_server, const std::vector<std::string>& queries) {
     std::vector<std::vector<Document>> v_results(queries.size());
+    //  - ,     ,   
+    const TraceContext trace_context = TraceSpan::GetCurrentContext();
+
+    std::transform(
+        std::execution::par,
+        queries.begin(), queries.end(),
+        v_results.begin(),
+        [&search_server, &trace_context](const std::string& query) {
+            const TraceContextScope trace_scope(trace_context);
+            TRACE_DURATION("ProcessQueries query");
+            return search_server.FindTopDocuments(query);
+        }
+    );
+
+    return v_results;
+}
+
+std::vector<TopDocumentsResult> ProcessQueries(const SearchServer& search_server, const std::vector<std::string>& queries, const QueryDeadline& deadline) {
+    std::vector<TopDocumentsResult> v_results(queries.size());
+    const TraceContext trace_context = TraceSpan::GetCurrentContext();
 
     std::transform(
         std::execution::par,
         queries.begin(), queries.end(),
         v_results.begin(),
-        [&search_server](const std::string& query) { return search_server.FindTopDocuments(query); }
+        [&search_server, &deadline, &trace_context](const std::string& query) {
+            const TraceContextScope trace_scope(trace_context);
+            TRACE_DURATION("ProcessQueries query");
+            return search_server.FindTopDocuments(query, deadline);
+        }
     );
 
     return v_results;
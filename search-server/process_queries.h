@@ -6,4 +6,8 @@
 
 std::vector<std::vector<Document>> ProcessQueries(const SearchServer& search_server, const std::vector<std::string>& queries);
 
+//     : ,    ,   ,
+//     - ,   is_complete == false
+std::vector<TopDocumentsResult> ProcessQueries(const SearchServer& search_server, const std::vector<std::string>& queries, const QueryDeadline& deadline);
+
 std::vector<Document> ProcessQueriesJoined(const SearchServer& search_server, const std::vector<std::string>& queries);
\ No newline at end of file
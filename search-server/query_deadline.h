@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+//   ; Cancel     
+class CancellationToken {
+public:
+    void Cancel() {
+        cancelled_.store(true, std::memory_order_relaxed);
+    }
+
+    bool IsCancelled() const {
+        return cancelled_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<bool> cancelled_ = false;
+};
+
+//     ()  .    .
+//   ,      
+class QueryDeadline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    QueryDeadline() = default;
+    explicit QueryDeadline(Clock::time_point deadline, const CancellationToken* token = nullptr)
+        : deadline_(deadline)
+        , token_(token)
+    {}
+    explicit QueryDeadline(const CancellationToken& token)
+        : token_(&token)
+    {}
+
+    //   timeout   
+    static QueryDeadline After(Clock::duration timeout, const CancellationToken* token = nullptr) {
+        return QueryDeadline(Clock::now() + timeout, token);
+    }
+
+    bool IsUnlimited() const {
+        return deadline_ == Clock::time_point::max() && token_ == nullptr;
+    }
+
+    //  ,   
+    bool IsExpired() const {
+        return (token_ != nullptr && token_->IsCancelled())
+            || (deadline_ != Clock::time_point::max() && Clock::now() >= deadline_);
+    }
+
+private:
+    Clock::time_point deadline_ = Clock::time_point::max();
+    const CancellationToken* token_ = nullptr;
+};
+
+//        . ShouldStop    
+// (, ),      CHECK_INTERVAL   ,  
+//      .       
+class DeadlineCheck {
+public:
+    static constexpr uint32_t CHECK_INTERVAL = 1024;
+
+    explicit DeadlineCheck(const QueryDeadline& deadline)
+        : deadline_(deadline)
+    {}
+
+    DeadlineCheck(const DeadlineCheck&) = delete;
+    DeadlineCheck& operator=(const DeadlineCheck&) = delete;
+
+    bool ShouldStop() {
+        if (stopped_.load(std::memory_order_relaxed)) {
+            return true;
+        }
+        if (++calls_since_check_ < CHECK_INTERVAL) {
+            return false;
+        }
+        return CheckNow();
+    }
+
+    //    ,    
+    bool CheckNow() {
+        calls_since_check_ = 0;
+        if (deadline_.IsExpired()) {
+            stopped_.store(true, std::memory_order_relaxed);
+        }
+        return stopped_.load(std::memory_order_relaxed);
+    }
+
+    //   ,   -  
+    bool IsStopped() const {
+        return stopped_.load(std::memory_order_relaxed);
+    }
+
+private:
+    const QueryDeadline& deadline_;
+    std::atomic<bool> stopped_ = false;
+    //     :     
+    static inline thread_local uint32_t calls_since_check_ = 0;
+};
@@ -0,0 +1,50 @@
+#include "query_plan.h"
+
+#include <sstream>
+
+namespace {
+
+void PrintTerms(std::ostream& os, const char* name, const std::pmr::vector<QueryPlan::Term>& terms) {
+    os << name << ":";
+    for (const QueryPlan::Term& term : terms) {
+        os << ' ' << term.word << "(df = " << term.document_freq << ", idf = " << term.inverse_document_freq;
+        if (term.weight != 1.0) {
+            os << ", weight = " << term.weight;
+        }
+        os << ')';
+    }
+    os << '\n';
+}
+
+}
+
+const char* GetQueryStrategyName(QueryStrategy strategy) {
+    switch (strategy) {
+    case QueryStrategy::TERM_AT_A_TIME:
+        return "term-at-a-time";
+    case QueryStrategy::DOCUMENT_AT_A_TIME:
+        return "document-at-a-time";
+    case QueryStrategy::BITMAP:
+        return "bitmap";
+    case QueryStrategy::CONJUNCTIVE:
+        return "conjunctive";
+    default:
+        return "unknown";
+    }
+}
+
+std::string QueryPlan::ToString() const {
+    std::ostringstream os;
+    os << "strategy: " << GetQueryStrategyName(strategy) << ", estimated cost: " << estimated_cost
+        << (matches_all_documents ? ", matches all documents" : "")
+        << (phrase_count != 0 ? ", phrases: " + std::to_string(phrase_count) : "") << '\n';
+    PrintTerms(os, "plus", plus_terms);
+    PrintTerms(os, "required", required_terms);
+    PrintTerms(os, "minus", minus_terms);
+    os << "dropped:";
+    for (const std::string_view word : dropped_words) {
+        os << ' ' << word;
+    }
+    os << '\n';
+    return os.str();
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//   ,   SearchServer
+enum class QueryStrategy {
+    TERM_AT_A_TIME,     //     ,    
+    DOCUMENT_AT_A_TIME, //    id ,     
+    BITMAP,             //     ,      
+    CONJUNCTIVE,        //     (+),    
+};
+
+const char* GetQueryStrategyName(QueryStrategy strategy);
+
+struct QueryPlan {
+    QueryPlan() = default;
+
+    //      resource; SearchServer   
+    explicit QueryPlan(std::pmr::memory_resource* resource)
+        : plus_terms(resource), minus_terms(resource), required_terms(resource), dropped_words(resource)
+    {}
+
+    struct Term {
+        std::string_view word;
+        size_t document_freq = 0;
+        double inverse_document_freq = 0.0; //    weight
+        double weight = 1.0;                //  1  ,     
+    };
+
+    std::pmr::vector<Term> plus_terms;     //      ,    
+    std::pmr::vector<Term> minus_terms;    // -,    ,    
+    std::pmr::vector<Term> required_terms; //  ,    
+    // -    :         (IDF = 0)
+    std::pmr::vector<std::string_view> dropped_words;
+    //   -    ,    ,     
+    bool matches_all_documents = false;
+    //            
+    size_t phrase_count = 0;
+    QueryStrategy strategy = QueryStrategy::TERM_AT_A_TIME;
+    //  -  (, ),   
+    size_t estimated_cost = 0;
+
+    std::string ToString() const;
+};
@@ -0,0 +1,87 @@
+#include "query_protocol.h"
+
+#include <charconv>
+
+namespace {
+
+template <typename Number>
+void AppendNumber(std::string& output, Number value) {
+    char buffer[32];
+    const std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    output.append(buffer, result.ptr);
+}
+
+//          text  
+template <typename Number>
+bool ParseNumber(std::string_view& text, Number& value) {
+    const size_t space = text.find(' ');
+    const std::string_view token = text.substr(0, space);
+    const std::from_chars_result result = std::from_chars(token.data(), token.data() + token.size(), value);
+    if (result.ec != std::errc() || result.ptr != token.data() + token.size()) {
+        return false;
+    }
+    text.remove_prefix(space == std::string_view::npos ? text.size() : space + 1);
+    return true;
+}
+
+}
+
+bool ExtractLine(std::string_view& input, std::string_view& line) {
+    const size_t end = input.find('\n');
+    if (end == std::string_view::npos) {
+        return false;
+    }
+    line = input.substr(0, end);
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    input.remove_prefix(end + 1);
+    return true;
+}
+
+void AppendResponse(std::string& output, const std::vector<Document>& documents) {
+    output += "OK ";
+    AppendNumber(output, documents.size());
+    for (const Document& document : documents) {
+        output += ' ';
+        AppendNumber(output, document.id);
+        output += ' ';
+        AppendNumber(output, document.relevance);
+        output += ' ';
+        AppendNumber(output, document.rating);
+    }
+    output += '\n';
+}
+
+void AppendErrorResponse(std::string& output, std::string_view message) {
+    output += "ERR ";
+    const size_t begin = output.size();
+    output += message;
+    //      
+    for (size_t i = begin; i < output.size(); ++i) {
+        if (output[i] == '\n' || output[i] == '\r') {
+            output[i] = ' ';
+        }
+    }
+    output += '\n';
+}
+
+bool ParseResponse(std::string_view line, std::vector<Document>& documents) {
+    documents.clear();
+    if (line.substr(0, 3) != "OK ") {
+        return false;
+    }
+    line.remove_prefix(3);
+
+    size_t count = 0;
+    if (!ParseNumber(line, count)) {
+        return false;
+    }
+    documents.resize(count);
+    for (Document& document : documents) {
+        if (!ParseNumber(line, document.id) || !ParseNumber(line, document.relevance) || !ParseNumber(line, document.rating)) {
+            return false;
+        }
+    }
+    return line.empty();
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "document.h"
+
+//   QueryService.  -  ,  '\n'.
+//    ,   ;        :
+//   OK <-> <id> <> <> ...\n
+//   ERR <>\n
+
+//    input   '\n' (    '\r'  ).
+//      ,  false    input
+bool ExtractLine(std::string_view& input, std::string_view& line);
+
+//    output   
+void AppendResponse(std::string& output, const std::vector<Document>& documents);
+
+void AppendErrorResponse(std::string& output, std::string_view message);
+
+//     '\n'.   ERR     false
+bool ParseResponse(std::string_view line, std::vector<Document>& documents);
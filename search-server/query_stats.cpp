@@ -0,0 +1,125 @@
+#include "query_stats.h"
+
+#include <sstream>
+
+namespace {
+
+const double EXPORTED_PERCENTILES[] = { 50.0, 90.0, 99.0, 99.9 };
+
+void PrintTextLine(std::ostream& os, const char* name, const LatencyHistogram::Snapshot& histogram) {
+    os << name << ": count = " << histogram.total_count;
+    for (const double percentile : EXPORTED_PERCENTILES) {
+        os << ", p" << percentile << " = " << histogram.GetValueAtPercentile(percentile);
+    }
+    os << ", max = " << histogram.max_value << '\n';
+}
+
+void PrintJsonObject(std::ostream& os, const char* name, const LatencyHistogram::Snapshot& histogram) {
+    os << '"' << name << "\": {\"count\": " << histogram.total_count;
+    for (const double percentile : EXPORTED_PERCENTILES) {
+        os << ", \"p" << percentile << "\": " << histogram.GetValueAtPercentile(percentile);
+    }
+    os << ", \"max\": " << histogram.max_value << '}';
+}
+
+}
+
+const char* GetQueryStageName(QueryStage stage) {
+    switch (stage) {
+    case QueryStage::PARSE:
+        return "parse";
+    case QueryStage::TRAVERSAL:
+        return "traversal";
+    case QueryStage::FILTERING:
+        return "filtering";
+    case QueryStage::TOP_K:
+        return "top_k";
+    default:
+        return "unknown";
+    }
+}
+
+const char* GetQueryCounterName(QueryCounter counter) {
+    switch (counter) {
+    case QueryCounter::POSTINGS_VISITED:
+        return "postings_visited";
+    case QueryCounter::DOCUMENTS_SCORED:
+        return "documents_scored";
+    case QueryCounter::MINUS_EXCLUSIONS:
+        return "minus_exclusions";
+    default:
+        return "unknown";
+    }
+}
+
+std::string QueryStatsSnapshot::ToText() const {
+    std::ostringstream os;
+    for (size_t i = 0; i < stages.size(); ++i) {
+        PrintTextLine(os, GetQueryStageName(static_cast<QueryStage>(i)), stages[i]);
+    }
+    for (size_t i = 0; i < counters.size(); ++i) {
+        PrintTextLine(os, GetQueryCounterName(static_cast<QueryCounter>(i)), counters[i]);
+    }
+    return os.str();
+}
+
+std::string QueryStatsSnapshot::ToJson() const {
+    std::ostringstream os;
+    os << "{\"stages_ns\": {";
+    for (size_t i = 0; i < stages.size(); ++i) {
+        if (i != 0) {
+            os << ", ";
+        }
+        PrintJsonObject(os, GetQueryStageName(static_cast<QueryStage>(i)), stages[i]);
+    }
+    os << "}, \"counters\": {";
+    for (size_t i = 0; i < counters.size(); ++i) {
+        if (i != 0) {
+            os << ", ";
+        }
+        PrintJsonObject(os, GetQueryCounterName(static_cast<QueryCounter>(i)), counters[i]);
+    }
+    os << "}}";
+    return os.str();
+}
+
+QueryStats::QueryStats() {
+    if constexpr (QUERY_STATS_ENABLED) {
+        data_ = std::make_unique<Data>();
+    }
+}
+
+QueryStats::QueryStats(const QueryStats&)
+    : QueryStats()
+{}
+
+QueryStats& QueryStats::operator=(const QueryStats&) {
+    Reset();
+    return *this;
+}
+
+QueryStatsSnapshot QueryStats::GetSnapshot() const {
+    QueryStatsSnapshot snapshot;
+    if (!data_) {
+        return snapshot;
+    }
+    for (size_t i = 0; i < snapshot.stages.size(); ++i) {
+        snapshot.stages[i] = data_->stages[i].GetSnapshot();
+    }
+    for (size_t i = 0; i < snapshot.counters.size(); ++i) {
+        snapshot.counters[i] = data_->counters[i].GetSnapshot();
+    }
+    return snapshot;
+}
+
+void QueryStats::Reset() {
+    if (!data_) {
+        return;
+    }
+    for (LatencyHistogram& histogram : data_->stages) {
+        histogram.Reset();
+    }
+    for (LatencyHistogram& histogram : data_->counters) {
+        histogram.Reset();
+    }
+}
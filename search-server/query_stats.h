@@ -0,0 +1,143 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include "latency_histogram.h"
+
+//       -DSEARCH_SERVER_ENABLE_STATS.
+//       ,    ,    .
+#ifdef SEARCH_SERVER_ENABLE_STATS
+inline constexpr bool QUERY_STATS_ENABLED = true;
+#else
+inline constexpr bool QUERY_STATS_ENABLED = false;
+#endif
+
+//   ,     
+enum class QueryStage {
+    PARSE,      //  
+    TRAVERSAL,  //    -   
+    FILTERING,  //    -
+    TOP_K,      //     
+    COUNT
+};
+
+// ,      
+enum class QueryCounter {
+    POSTINGS_VISITED,   //   (, )
+    DOCUMENTS_SCORED,   // ,    
+    MINUS_EXCLUSIONS,   // ,  -
+    COUNT
+};
+
+const char* GetQueryStageName(QueryStage stage);
+const char* GetQueryCounterName(QueryCounter counter);
+
+struct QueryStatsSnapshot {
+    std::array<LatencyHistogram::Snapshot, static_cast<size_t>(QueryStage::COUNT)> stages;
+    std::array<LatencyHistogram::Snapshot, static_cast<size_t>(QueryCounter::COUNT)> counters;
+
+    std::string ToText() const;
+    std::string ToJson() const;
+};
+
+class QueryStats {
+public:
+    QueryStats();
+    //            
+    QueryStats(const QueryStats& other);
+    QueryStats& operator=(const QueryStats& other);
+    QueryStats(QueryStats&& other) = default;
+    QueryStats& operator=(QueryStats&& other) = default;
+
+    void RecordStage(QueryStage stage, uint64_t duration_ns) const {
+        if constexpr (QUERY_STATS_ENABLED) {
+            data_->stages[static_cast<size_t>(stage)].Record(duration_ns);
+        }
+    }
+
+    void RecordCounter(QueryCounter counter, uint64_t value) const {
+        if constexpr (QUERY_STATS_ENABLED) {
+            data_->counters[static_cast<size_t>(counter)].Record(value);
+        }
+    }
+
+    //      
+    QueryStatsSnapshot GetSnapshot() const;
+
+    void Reset();
+
+private:
+    struct Data {
+        std::array<LatencyHistogram, static_cast<size_t>(QueryStage::COUNT)> stages;
+        std::array<LatencyHistogram, static_cast<size_t>(QueryCounter::COUNT)> counters;
+    };
+    std::unique_ptr<Data> data_;
+};
+
+//      QueryStats::RecordCounter.  SEARCH_SERVER_ENABLE_STATS
+// ,    ,  ,        
+template <typename Value>
+class QueryCounterValue {
+public:
+    void Add(uint64_t delta) {
+        if constexpr (QUERY_STATS_ENABLED) {
+            if constexpr (std::is_integral_v<Value>) {
+                value_ += delta;
+            }
+            else {
+                value_.fetch_add(delta, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    uint64_t Get() const {
+        if constexpr (QUERY_STATS_ENABLED) {
+            return value_;
+        }
+        else {
+            return 0;
+        }
+    }
+
+private:
+    Value value_ = 0;
+};
+
+using QueryCount = QueryCounterValue<uint64_t>;
+using AtomicQueryCount = QueryCounterValue<std::atomic<uint64_t>>;
+
+//        
+class QueryStageTimer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    QueryStageTimer(const QueryStats& stats, QueryStage stage)
+        : stats_(stats)
+        , stage_(stage)
+    {
+        if constexpr (QUERY_STATS_ENABLED) {
+            start_time_ = Clock::now();
+        }
+    }
+
+    QueryStageTimer(const QueryStageTimer&) = delete;
+    QueryStageTimer& operator=(const QueryStageTimer&) = delete;
+
+    ~QueryStageTimer() {
+        if constexpr (QUERY_STATS_ENABLED) {
+            const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_time_);
+            stats_.RecordStage(stage_, static_cast<uint64_t>(duration.count()));
+        }
+    }
+
+private:
+    const QueryStats& stats_;
+    const QueryStage stage_;
+    Clock::time_point start_time_;
+};
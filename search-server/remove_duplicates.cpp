@@ -5,7 +5,7 @@
 #include <string>
 #include <string_view>
 
-std::set<std::string_view> ConvertMapToSet(const std::map<std::string_view, double>& map_words) {
+std::set<std::string_view> ConvertMapToSet(const WordFrequencies& map_words) {
     std::set<std::string_view> result;
 
     for (auto it = map_words.begin(); it != map_words.end(); ++it) {
@@ -20,7 +20,7 @@ void RemoveDuplicates(SearchServer& search_server) {
     std::set<std::set<std::string_view>> unique_words;
 
     for (const int document_id : search_server) {
-        const std::map<std::string_view, double>& map_words = search_server.GetWordFrequencies(document_id);
+        const WordFrequencies map_words = search_server.GetWordFrequencies(document_id);
         const std::set<std::string_view> set_words = ConvertMapToSet(map_words);
 
         if (unique_words.count(set_words) != 0) {
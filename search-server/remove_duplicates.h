@@ -2,6 +2,6 @@
 
 #include "search_server.h"
 
-std::set<std::string> ConvertMapToSet(const std::map<std::string, double>& map_words);
+std::set<std::string_view> ConvertMapToSet(const WordFrequencies& map_words);
 
 void RemoveDuplicates(SearchServer& search_server);
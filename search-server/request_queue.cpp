@@ -1,45 +1,118 @@
 #include "request_queue.h"
 
+#include <algorithm>
+#include <functional>
+#include <thread>
+
 RequestQueue::RequestQueue(const SearchServer& search_server)
-    : requests_()
-    , search_server_(search_server)
-    , count_requests_without_result(0)
-    , curr_time_(0) {
+    : RequestQueue(search_server, Options{})
+{}
+
+RequestQueue::RequestQueue(const SearchServer& search_server, const Options& options)
+    : search_server_(search_server)
+    , options_(options)
+    , start_time_(Clock::now())
+    , shards_(std::make_unique<Shard[]>(options.shard_count))
+{
+    if (options_.shard_count == 0 || options_.shard_capacity == 0) {
+        throw std::invalid_argument("RequestQueue needs at least one shard with non-zero capacity");
+    }
+    for (size_t i = 0; i < options_.shard_count; ++i) {
+        shards_[i].slots = std::make_unique<Slot[]>(options_.shard_capacity);
+    }
 }
 
-std::vector<Document> RequestQueue::AddFindRequest(const std::string& raw_query, DocumentStatus status) {
-    return AddFindRequest(raw_query, [status](int document_id, DocumentStatus document_status, int rating) {
+std::vector<Document> RequestQueue::AddFindRequest(const std::string_view& raw_query, DocumentStatus status) {
+    return AddFindRequest(raw_query, [status](int, DocumentStatus document_status, int) {
         return document_status == status;
         });
 }
 
-std::vector<Document> RequestQueue::AddFindRequest(const std::string& raw_query) {
+std::vector<Document> RequestQueue::AddFindRequest(const std::string_view& raw_query) {
     return AddFindRequest(raw_query, DocumentStatus::ACTUAL);
 }
 
 int RequestQueue::GetNoResultRequests() const {
+    int count_requests_without_result = 0;
+    ForEachInWindow([&count_requests_without_result](const SlotData& data) {
+        if (data.count_docs == 0) {
+            ++count_requests_without_result;
+        }
+        });
     return count_requests_without_result;
 }
 
-void RequestQueue::AddRequest(const std::string& raw_query, int count_of_docs) {
-    //  
-    ++curr_time_;
+double RequestQueue::GetQueriesPerSecond() const {
+    uint64_t count_requests = 0;
+    ForEachInWindow([&count_requests](const SlotData&) { ++count_requests; });
 
-    //   ,   
-    while (!requests_.empty() && min_in_day_ <= (curr_time_ - requests_.front().time)) {
-        //  -    
-        if (requests_.front().count_docs == 0) {
-            --count_requests_without_result;
+    const Clock::duration elapsed = std::min(options_.window, Clock::now() - start_time_);
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    return seconds > 0 ? count_requests / seconds : 0.0;
+}
+
+RequestQueue::Clock::duration RequestQueue::GetLatencyPercentile(double percentile) const {
+    LatencyHistogram::Snapshot histogram;
+    ForEachInWindow([&histogram](const SlotData& data) { histogram.Record(data.latency_ns); });
+
+    return std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(histogram.GetValueAtPercentile(percentile)));
+}
+
+std::vector<uint64_t> RequestQueue::GetNoResultQueryHashes() const {
+    std::vector<uint64_t> hashes;
+    if (!options_.hash_queries) {
+        return hashes;
+    }
+    ForEachInWindow([&hashes](const SlotData& data) {
+        if (data.count_docs == 0) {
+            hashes.push_back(data.query_hash);
         }
-        //   
-        requests_.pop_front();
+        });
+    return hashes;
+}
+
+LatencyHistogram::Snapshot RequestQueue::GetTotalLatencyHistogram() const {
+    return total_latency_.GetSnapshot();
+}
+
+uint64_t RequestQueue::GetEvictedRequestCount() const {
+    uint64_t evicted = 0;
+    for (size_t shard_index = 0; shard_index < options_.shard_count; ++shard_index) {
+        evicted += shards_[shard_index].evicted.load(std::memory_order_relaxed);
     }
+    return evicted;
+}
 
-    //     
-    if (count_of_docs == 0) {
-        ++count_requests_without_result;
+void RequestQueue::AddRequest(const std::string_view& raw_query, int count_of_docs, Clock::time_point start, Clock::time_point finish) {
+    const uint64_t latency_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start).count());
+    total_latency_.Record(latency_ns);
+
+    Shard& shard = GetShardForCurrentThread();
+    const uint64_t ticket = shard.next_ticket.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = shard.slots[ticket % options_.shard_capacity];
+    const int64_t finish_ns = ToNanoseconds(finish);
+
+    //      -     
+    if (ticket >= options_.shard_capacity
+        && slot.time_ns.load(std::memory_order_relaxed) >= ToNanoseconds(finish - options_.window)) {
+        shard.evicted.fetch_add(1, std::memory_order_relaxed);
     }
 
-    requests_.push_back({ raw_query, count_of_docs, curr_time_ });
+    //   -  ,  - 
+    slot.seq.store(2 * ticket + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.time_ns.store(finish_ns, std::memory_order_relaxed);
+    slot.latency_ns.store(latency_ns, std::memory_order_relaxed);
+    slot.query_hash.store(options_.hash_queries ? std::hash<std::string_view>{}(raw_query) : 0, std::memory_order_relaxed);
+    slot.count_docs.store(count_of_docs, std::memory_order_relaxed);
+    slot.seq.store(2 * ticket + 2, std::memory_order_release);
+}
+
+RequestQueue::Shard& RequestQueue::GetShardForCurrentThread() {
+    static thread_local const size_t thread_hash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    return shards_[thread_hash % options_.shard_count];
+}
 
-}
\ No newline at end of file
+int64_t RequestQueue::ToNanoseconds(Clock::time_point time) const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time - start_time_).count();
+}
@@ -1,41 +1,135 @@
 #pragma once
 
-#include <deque>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "search_server.h"
+#include "latency_histogram.h"
 
+//       .
+//  AddFindRequest      :   
+//    -    ,   O(1)    .
+//     shard_count * shard_capacity  (  65536,  0.76 
+//    24 );          ,
+//  -      GetEvictedRequestCount.
+//    ,      .
 class RequestQueue {
 public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        Clock::duration window = std::chrono::hours(24);
+        //      ,  shard_count * shard_capacity,   .
+        //   window   Q     shard_capacity >= Q * window / shard_count
+        size_t shard_count = 16;
+        size_t shard_capacity = 4096;
+        bool hash_queries = false;
+    };
+
     explicit RequestQueue(const SearchServer& search_server);
+    RequestQueue(const SearchServer& search_server, const Options& options);
+
     //  ""    ,      
     template <typename DocumentPredicate>
-    std::vector<Document> AddFindRequest(const std::string& raw_query, DocumentPredicate document_predicate);
-    std::vector<Document> AddFindRequest(const std::string& raw_query, DocumentStatus status);
-    std::vector<Document> AddFindRequest(const std::string& raw_query);
+    std::vector<Document> AddFindRequest(const std::string_view& raw_query, DocumentPredicate document_predicate);
+    std::vector<Document> AddFindRequest(const std::string_view& raw_query, DocumentStatus status);
+    std::vector<Document> AddFindRequest(const std::string_view& raw_query);
+
+    // -      
     int GetNoResultRequests() const;
+    // -       (   ,     )
+    double GetQueriesPerSecond() const;
+    //      , percentile   [0, 100]
+    Clock::duration GetLatencyPercentile(double percentile) const;
+    //       ,    Options::hash_queries
+    std::vector<uint64_t> GetNoResultQueryHashes() const;
+    //      
+    LatencyHistogram::Snapshot GetTotalLatencyHistogram() const;
+    // - ,     ,     .
+    //   ,        
+    uint64_t GetEvictedRequestCount() const;
+
 private:
-    struct QueryResult {
-        QueryResult() = default;
+    //     (seqlock):   seq ,    
+    struct Slot {
+        std::atomic<uint64_t> seq = 0;
+        std::atomic<int64_t> time_ns = 0;
+        std::atomic<uint64_t> latency_ns = 0;
+        std::atomic<uint64_t> query_hash = 0;
+        std::atomic<int> count_docs = 0;
+    };
+
+    struct alignas(64) Shard {
+        std::unique_ptr<Slot[]> slots;
+        std::atomic<uint64_t> next_ticket = 0;
+        std::atomic<uint64_t> evicted = 0;
+    };
 
-        std::string query = "";
+    struct SlotData {
+        int64_t time_ns = 0;
+        uint64_t latency_ns = 0;
+        uint64_t query_hash = 0;
         int count_docs = 0;
-        int time = 0;
     };
-    std::deque<QueryResult> requests_;
+
     const SearchServer& search_server_;
-    int count_requests_without_result;
-    int curr_time_;
-    const static int min_in_day_ = 1440;
+    const Options options_;
+    const Clock::time_point start_time_;
+    std::unique_ptr<Shard[]> shards_;
+    LatencyHistogram total_latency_;
+
+    void AddRequest(const std::string_view& raw_query, int count_of_docs, Clock::time_point start, Clock::time_point finish);
 
-    void AddRequest(const std::string& raw_query, int count_of_docs);
+    Shard& GetShardForCurrentThread();
 
+    int64_t ToNanoseconds(Clock::time_point time) const;
+
+    //  action(const SlotData&)    ,   
+    template <typename Action>
+    void ForEachInWindow(Action action) const;
 };
 
 template <typename DocumentPredicate>
-std::vector<Document> RequestQueue::AddFindRequest(const std::string& raw_query, DocumentPredicate document_predicate) {
-
+std::vector<Document> RequestQueue::AddFindRequest(const std::string_view& raw_query, DocumentPredicate document_predicate) {
+    const Clock::time_point start = Clock::now();
     const std::vector<Document> result_docs = search_server_.FindTopDocuments(raw_query, document_predicate);
-    RequestQueue::AddRequest(raw_query, static_cast<int>(result_docs.size()));
+    RequestQueue::AddRequest(raw_query, static_cast<int>(result_docs.size()), start, Clock::now());
 
     return result_docs;
-}
\ No newline at end of file
+}
+
+template <typename Action>
+void RequestQueue::ForEachInWindow(Action action) const {
+    const int64_t window_begin = ToNanoseconds(Clock::now() - options_.window);
+
+    for (size_t shard_index = 0; shard_index < options_.shard_count; ++shard_index) {
+        const Shard& shard = shards_[shard_index];
+        for (size_t i = 0; i < options_.shard_capacity; ++i) {
+            const Slot& slot = shard.slots[i];
+
+            const uint64_t seq_before = slot.seq.load(std::memory_order_acquire);
+            //      
+            if (seq_before == 0 || seq_before % 2 != 0) {
+                continue;
+            }
+            SlotData data;
+            data.time_ns = slot.time_ns.load(std::memory_order_relaxed);
+            data.latency_ns = slot.latency_ns.load(std::memory_order_relaxed);
+            data.query_hash = slot.query_hash.load(std::memory_order_relaxed);
+            data.count_docs = slot.count_docs.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            //  ,    
+            if (slot.seq.load(std::memory_order_relaxed) != seq_before) {
+                continue;
+            }
+
+            if (data.time_ns >= window_begin) {
+                action(data);
+            }
+        }
+    }
+}
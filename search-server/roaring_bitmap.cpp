@@ -0,0 +1,370 @@
+#include "roaring_bitmap.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+int PopCount(uint64_t word) {
+    word = word - ((word >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((word * 0x0101010101010101ULL) >> 56);
+}
+
+bool TestBit(const std::pmr::vector<uint64_t>& bits, uint16_t value) {
+    return (bits[value / 64] & (uint64_t{ 1 } << (value % 64))) != 0;
+}
+
+}
+
+RoaringBitmap::RoaringBitmap(std::pmr::memory_resource* resource)
+    : containers_(resource)
+{}
+
+std::pmr::vector<RoaringBitmap::Container>::iterator RoaringBitmap::FindContainer(uint16_t key) {
+    return std::lower_bound(containers_.begin(), containers_.end(), key,
+        [](const Container& container, uint16_t key) { return container.key < key; });
+}
+
+std::pmr::vector<RoaringBitmap::Container>::const_iterator RoaringBitmap::FindContainer(uint16_t key) const {
+    return std::lower_bound(containers_.begin(), containers_.end(), key,
+        [](const Container& container, uint16_t key) { return container.key < key; });
+}
+
+void RoaringBitmap::Add(uint32_t value) {
+    const uint16_t key = static_cast<uint16_t>(value >> 16);
+    const uint16_t low = static_cast<uint16_t>(value);
+    auto it = FindContainer(key);
+    if (it == containers_.end() || it->key != key) {
+        it = containers_.emplace(it, key, containers_.get_allocator().resource());
+    }
+    Container& container = *it;
+    if (container.IsBitmap()) {
+        uint64_t& word = container.bits[low / 64];
+        const uint64_t mask = uint64_t{ 1 } << (low % 64);
+        if ((word & mask) != 0) {
+            return;
+        }
+        word |= mask;
+    }
+    else {
+        const auto value_it = std::lower_bound(container.values.begin(), container.values.end(), low);
+        if (value_it != container.values.end() && *value_it == low) {
+            return;
+        }
+        container.values.insert(value_it, low);
+    }
+    ++container.cardinality;
+    ++cardinality_;
+    Normalize(container);
+}
+
+void RoaringBitmap::Remove(uint32_t value) {
+    const uint16_t key = static_cast<uint16_t>(value >> 16);
+    const uint16_t low = static_cast<uint16_t>(value);
+    const auto it = FindContainer(key);
+    if (it == containers_.end() || it->key != key) {
+        return;
+    }
+    Container& container = *it;
+    if (container.IsBitmap()) {
+        uint64_t& word = container.bits[low / 64];
+        const uint64_t mask = uint64_t{ 1 } << (low % 64);
+        if ((word & mask) == 0) {
+            return;
+        }
+        word &= ~mask;
+    }
+    else {
+        const auto value_it = std::lower_bound(container.values.begin(), container.values.end(), low);
+        if (value_it == container.values.end() || *value_it != low) {
+            return;
+        }
+        container.values.erase(value_it);
+    }
+    --container.cardinality;
+    --cardinality_;
+    if (container.cardinality == 0) {
+        containers_.erase(it);
+        if (containers_.empty()) {
+            containers_.shrink_to_fit();
+        }
+    }
+    else {
+        Normalize(container);
+    }
+}
+
+bool RoaringBitmap::Contains(uint32_t value) const {
+    const uint16_t key = static_cast<uint16_t>(value >> 16);
+    const uint16_t low = static_cast<uint16_t>(value);
+    const auto it = FindContainer(key);
+    if (it == containers_.end() || it->key != key) {
+        return false;
+    }
+    if (it->IsBitmap()) {
+        return TestBit(it->bits, low);
+    }
+    return std::binary_search(it->values.begin(), it->values.end(), low);
+}
+
+void RoaringBitmap::ToBitmap(Container& container) {
+    if (container.IsBitmap()) {
+        return;
+    }
+    container.bits.assign(BITMAP_WORD_COUNT, 0);
+    for (const uint16_t low : container.values) {
+        container.bits[low / 64] |= uint64_t{ 1 } << (low % 64);
+    }
+    container.values.clear();
+    container.values.shrink_to_fit();
+}
+
+void RoaringBitmap::Normalize(Container& container) {
+    if (!container.IsBitmap() && container.cardinality > ARRAY_MAX_SIZE) {
+        ToBitmap(container);
+    }
+    else if (container.IsBitmap() && container.cardinality <= ARRAY_MAX_SIZE) {
+        container.values.reserve(container.cardinality);
+        for (size_t i = 0; i < BITMAP_WORD_COUNT; ++i) {
+            uint64_t word = container.bits[i];
+            while (word != 0) {
+                const uint64_t lowest = word & (~word + 1);
+                container.values.push_back(static_cast<uint16_t>(i * 64 + PopCount(lowest - 1)));
+                word &= word - 1;
+            }
+        }
+        container.bits.clear();
+        container.bits.shrink_to_fit();
+    }
+}
+
+size_t RoaringBitmap::CountBits(const Container& container) {
+    if (!container.IsBitmap()) {
+        return container.values.size();
+    }
+    size_t count = 0;
+    for (const uint64_t word : container.bits) {
+        count += PopCount(word);
+    }
+    return count;
+}
+
+template <typename Operation>
+void RoaringBitmap::CombineMatching(const RoaringBitmap& other, Operation operation) {
+    auto other_it = other.containers_.begin();
+    for (Container& container : containers_) {
+        while (other_it != other.containers_.end() && other_it->key < container.key) {
+            ++other_it;
+        }
+        const Container* matching = other_it != other.containers_.end() && other_it->key == container.key ? &*other_it : nullptr;
+        operation(container, matching);
+    }
+    RemoveEmptyContainers();
+}
+
+void RoaringBitmap::RemoveEmptyContainers() {
+    cardinality_ = 0;
+    for (Container& container : containers_) {
+        container.cardinality = CountBits(container);
+        cardinality_ += container.cardinality;
+    }
+    containers_.erase(
+        std::remove_if(containers_.begin(), containers_.end(), [](const Container& container) { return container.cardinality == 0; }),
+        containers_.end());
+    for (Container& container : containers_) {
+        Normalize(container);
+    }
+}
+
+void RoaringBitmap::Union(const RoaringBitmap& other) {
+    // ,    this,   ,    
+    for (const Container& other_container : other.containers_) {
+        const auto it = FindContainer(other_container.key);
+        if (it == containers_.end() || it->key != other_container.key) {
+            containers_.emplace(it, other_container.key, containers_.get_allocator().resource());
+        }
+    }
+    CombineMatching(other, [](Container& container, const Container* matching) {
+        if (matching == nullptr) {
+            return;
+        }
+        if (matching->IsBitmap()) {
+            ToBitmap(container);
+        }
+        if (container.IsBitmap()) {
+            if (matching->IsBitmap()) {
+                for (size_t i = 0; i < BITMAP_WORD_COUNT; ++i) {
+                    container.bits[i] |= matching->bits[i];
+                }
+            }
+            else {
+                for (const uint16_t low : matching->values) {
+                    container.bits[low / 64] |= uint64_t{ 1 } << (low % 64);
+                }
+            }
+            return;
+        }
+        std::pmr::vector<uint16_t> merged(container.values.get_allocator());
+        merged.reserve(container.values.size() + matching->values.size());
+        std::set_union(container.values.begin(), container.values.end(), matching->values.begin(), matching->values.end(), std::back_inserter(merged));
+        container.values.swap(merged);
+        if (container.values.size() > ARRAY_MAX_SIZE) {
+            container.cardinality = container.values.size();
+            ToBitmap(container);
+        }
+        });
+}
+
+void RoaringBitmap::Intersect(const RoaringBitmap& other) {
+    CombineMatching(other, [](Container& container, const Container* matching) {
+        if (matching == nullptr) {
+            container.values.clear();
+            container.bits.clear();
+            return;
+        }
+        if (container.IsBitmap() && matching->IsBitmap()) {
+            for (size_t i = 0; i < BITMAP_WORD_COUNT; ++i) {
+                container.bits[i] &= matching->bits[i];
+            }
+            return;
+        }
+        //     - ,    
+        std::pmr::vector<uint16_t> intersection(container.values.get_allocator());
+        if (container.IsBitmap()) {
+            std::copy_if(matching->values.begin(), matching->values.end(), std::back_inserter(intersection),
+                [&container](uint16_t low) { return TestBit(container.bits, low); });
+            container.bits.clear();
+        }
+        else if (matching->IsBitmap()) {
+            std::copy_if(container.values.begin(), container.values.end(), std::back_inserter(intersection),
+                [matching](uint16_t low) { return TestBit(matching->bits, low); });
+        }
+        else {
+            std::set_intersection(container.values.begin(), container.values.end(), matching->values.begin(), matching->values.end(), std::back_inserter(intersection));
+        }
+        container.values.swap(intersection);
+        });
+}
+
+void RoaringBitmap::Subtract(const RoaringBitmap& other) {
+    CombineMatching(other, [](Container& container, const Container* matching) {
+        if (matching == nullptr) {
+            return;
+        }
+        if (container.IsBitmap()) {
+            if (matching->IsBitmap()) {
+                for (size_t i = 0; i < BITMAP_WORD_COUNT; ++i) {
+                    container.bits[i] &= ~matching->bits[i];
+                }
+            }
+            else {
+                for (const uint16_t low : matching->values) {
+                    container.bits[low / 64] &= ~(uint64_t{ 1 } << (low % 64));
+                }
+            }
+            return;
+        }
+        if (matching->IsBitmap()) {
+            container.values.erase(
+                std::remove_if(container.values.begin(), container.values.end(),
+                    [matching](uint16_t low) { return TestBit(matching->bits, low); }),
+                container.values.end());
+            return;
+        }
+        std::pmr::vector<uint16_t> difference(container.values.get_allocator());
+        std::set_difference(container.values.begin(), container.values.end(), matching->values.begin(), matching->values.end(), std::back_inserter(difference));
+        container.values.swap(difference);
+        });
+}
+
+template <typename Operation>
+size_t RoaringBitmap::ForEachFlatWord(uint64_t* words, size_t word_count, Operation operation) const {
+    size_t result = 0;
+    for (const Container& container : containers_) {
+        const size_t first_word = size_t{ container.key } * BITMAP_WORD_COUNT;
+        if (first_word >= word_count) {
+            break;
+        }
+        if (container.IsBitmap()) {
+            const size_t count = std::min(BITMAP_WORD_COUNT, word_count - first_word);
+            for (size_t i = 0; i < count; ++i) {
+                result += operation(words[first_word + i], container.bits[i]);
+            }
+            continue;
+        }
+        auto value_it = container.values.begin();
+        while (value_it != container.values.end()) {
+            const size_t index = *value_it / 64;
+            uint64_t bits = 0;
+            for (; value_it != container.values.end() && *value_it / 64 == index; ++value_it) {
+                bits |= uint64_t{ 1 } << (*value_it % 64);
+            }
+            if (first_word + index >= word_count) {
+                break;
+            }
+            result += operation(words[first_word + index], bits);
+        }
+    }
+    return result;
+}
+
+void RoaringBitmap::OrInto(uint64_t* words, size_t word_count) const {
+    ForEachFlatWord(words, word_count, [](uint64_t& word, uint64_t bits) { word |= bits; return 0; });
+}
+
+void RoaringBitmap::AndInto(uint64_t* words, size_t word_count) const {
+    //        
+    size_t next_word = 0;
+    for (const Container& container : containers_) {
+        const size_t first_word = size_t{ container.key } * BITMAP_WORD_COUNT;
+        if (first_word >= word_count) {
+            break;
+        }
+        std::fill(words + next_word, words + first_word, 0);
+        const size_t count = std::min(BITMAP_WORD_COUNT, word_count - first_word);
+        if (container.IsBitmap()) {
+            for (size_t i = 0; i < count; ++i) {
+                words[first_word + i] &= container.bits[i];
+            }
+        }
+        else {
+            //       ,  
+            auto value_it = container.values.begin();
+            for (size_t i = 0; i < count; ++i) {
+                uint64_t mask = 0;
+                while (value_it != container.values.end() && *value_it / 64 == i) {
+                    mask |= uint64_t{ 1 } << (*value_it % 64);
+                    ++value_it;
+                }
+                words[first_word + i] &= mask;
+            }
+        }
+        next_word = first_word + count;
+    }
+    std::fill(words + std::min(next_word, word_count), words + word_count, 0);
+}
+
+size_t RoaringBitmap::AndNotInto(uint64_t* words, size_t word_count) const {
+    return ForEachFlatWord(words, word_count, [](uint64_t& word, uint64_t bits) {
+        const int cleared = PopCount(word & bits);
+        word &= ~bits;
+        return cleared;
+        });
+}
+
+bool RoaringBitmap::operator==(const RoaringBitmap& other) const {
+    if (cardinality_ != other.cardinality_ || containers_.size() != other.containers_.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < containers_.size(); ++i) {
+        const Container& lhs = containers_[i];
+        const Container& rhs = other.containers_[i];
+        //      
+        if (lhs.key != rhs.key || lhs.values != rhs.values || lhs.bits != rhs.bits) {
+            return false;
+        }
+    }
+    return true;
+}
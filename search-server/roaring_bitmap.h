@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+//   32-    Roaring.       16 ;
+//   ARRAY_MAX_SIZE      ,
+//   -    1024 . ,     
+//   64   
+class RoaringBitmap {
+public:
+    static constexpr size_t ARRAY_MAX_SIZE = 4096;
+
+    explicit RoaringBitmap(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    void Add(uint32_t value);
+    void Remove(uint32_t value);
+    bool Contains(uint32_t value) const;
+
+    size_t GetCardinality() const {
+        return cardinality_;
+    }
+
+    bool IsEmpty() const {
+        return cardinality_ == 0;
+    }
+
+    void Union(const RoaringBitmap& other);
+    void Intersect(const RoaringBitmap& other);
+    void Subtract(const RoaringBitmap& other);
+
+    //      words  word_count :  v -  v % 64  v / 64.
+    //      
+    void OrInto(uint64_t* words, size_t word_count) const;
+    void AndInto(uint64_t* words, size_t word_count) const;
+    //  -  
+    size_t AndNotInto(uint64_t* words, size_t word_count) const;
+
+    //  action     
+    template <typename Action>
+    void ForEach(Action action) const;
+
+    bool operator==(const RoaringBitmap& other) const;
+
+private:
+    static constexpr size_t BITMAP_WORD_COUNT = (1 << 16) / 64;
+
+    struct Container {
+        explicit Container(uint16_t key, std::pmr::memory_resource* resource)
+            : key(key), values(resource), bits(resource)
+        {}
+
+        uint16_t key;                     //  16   
+        std::pmr::vector<uint16_t> values; // ,  bits 
+        std::pmr::vector<uint64_t> bits;   //    BITMAP_WORD_COUNT 
+        size_t cardinality = 0;
+
+        bool IsBitmap() const {
+            return !bits.empty();
+        }
+    };
+
+    std::pmr::vector<Container>::iterator FindContainer(uint16_t key);
+    std::pmr::vector<Container>::const_iterator FindContainer(uint16_t key) const;
+
+    //    ,   
+    static void Normalize(Container& container);
+    static void ToBitmap(Container& container);
+    static size_t CountBits(const Container& container);
+
+    //           
+    template <typename Operation>
+    void CombineMatching(const RoaringBitmap& other, Operation operation);
+    //  operation(  ,    )  ,     ;
+    //    operation
+    template <typename Operation>
+    size_t ForEachFlatWord(uint64_t* words, size_t word_count, Operation operation) const;
+    void RemoveEmptyContainers();
+
+    std::pmr::vector<Container> containers_; //   key
+    size_t cardinality_ = 0;
+};
+
+template <typename Action>
+void RoaringBitmap::ForEach(Action action) const {
+    for (const Container& container : containers_) {
+        const uint32_t high = uint32_t{ container.key } << 16;
+        if (!container.IsBitmap()) {
+            for (const uint16_t low : container.values) {
+                action(high | low);
+            }
+            continue;
+        }
+        for (size_t i = 0; i < BITMAP_WORD_COUNT; ++i) {
+            uint64_t word = container.bits[i];
+            while (word != 0) {
+                int bit = 0;
+                while ((word & (uint64_t{ 1 } << bit)) == 0) {
+                    ++bit;
+                }
+                word &= word - 1;
+                action(high | static_cast<uint32_t>(i * 64 + bit));
+            }
+        }
+    }
+}
@@ -0,0 +1,91 @@
+#include "scratch_arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+struct ThreadScratch {
+    ScratchArena arena;
+    int depth = 0;
+};
+
+ThreadScratch& GetThreadScratch() {
+    thread_local ThreadScratch scratch;
+    return scratch;
+}
+
+}
+
+ScratchArena::ScratchArena(size_t initial_size, size_t max_retained_size)
+    : max_retained_size_(std::max(max_retained_size, initial_size))
+{
+    blocks_.push_back({ std::make_unique<std::byte[]>(initial_size), initial_size });
+}
+
+void ScratchArena::Reset() {
+    //         
+    const size_t capacity = GetCapacity();
+    const size_t retained_size = std::min(capacity, max_retained_size_);
+    if (blocks_.size() > 1 || retained_size < capacity) {
+        blocks_.clear();
+        blocks_.push_back({ std::make_unique<std::byte[]>(retained_size), retained_size });
+    }
+    current_block_ = 0;
+    offset_ = 0;
+}
+
+size_t ScratchArena::GetCapacity() const {
+    size_t capacity = 0;
+    for (const Block& block : blocks_) {
+        capacity += block.size;
+    }
+    return capacity;
+}
+
+void* ScratchArena::do_allocate(size_t bytes, size_t alignment) {
+    while (true) {
+        Block& block = blocks_[current_block_];
+        const uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+        const size_t aligned_offset = (base + offset_ + alignment - 1) / alignment * alignment - base;
+        if (aligned_offset + bytes <= block.size) {
+            offset_ = aligned_offset + bytes;
+            return block.data.get() + aligned_offset;
+        }
+        if (current_block_ + 1 == blocks_.size()) {
+            //  alignment      
+            const size_t size = std::max(block.size * 2, bytes + alignment);
+            blocks_.push_back({ std::make_unique<std::byte[]>(size), size });
+        }
+        ++current_block_;
+        offset_ = 0;
+    }
+}
+
+void ScratchArena::do_deallocate(void*, size_t, size_t) {
+    //     Reset
+}
+
+bool ScratchArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+QueryScratch::QueryScratch() {
+    ++GetThreadScratch().depth;
+}
+
+QueryScratch::~QueryScratch() {
+    ThreadScratch& scratch = GetThreadScratch();
+    if (--scratch.depth == 0) {
+        scratch.arena.Reset();
+    }
+}
+
+std::pmr::memory_resource* QueryScratch::GetResource() {
+    ThreadScratch& scratch = GetThreadScratch();
+    return scratch.depth > 0 ? &scratch.arena : std::pmr::new_delete_resource();
+}
+
+size_t QueryScratch::GetCapacity() {
+    return GetThreadScratch().arena.GetCapacity();
+}
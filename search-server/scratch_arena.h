@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+//    :          Reset.
+//    ,        .
+//       max_retained_size  (   initial_size)
+class ScratchArena : public std::pmr::memory_resource {
+public:
+    static constexpr size_t DEFAULT_MAX_RETAINED_SIZE = 16 * 1024 * 1024;
+
+    explicit ScratchArena(size_t initial_size = 64 * 1024, size_t max_retained_size = DEFAULT_MAX_RETAINED_SIZE);
+
+    //     .    ,
+    //      ;    max_retained_size,
+    //     ,     max_retained_size
+    void Reset();
+
+    //     
+    size_t GetCapacity() const;
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size = 0;
+    };
+
+    const size_t max_retained_size_;
+    std::vector<Block> blocks_;
+    size_t current_block_ = 0;
+    size_t offset_ = 0;
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+// ,             .
+//    (,      ),
+//       
+class QueryScratch {
+public:
+    QueryScratch();
+    ~QueryScratch();
+
+    QueryScratch(const QueryScratch&) = delete;
+    QueryScratch& operator=(const QueryScratch&) = delete;
+
+    //   ,    ,   .
+    //       
+    static std::pmr::memory_resource* GetResource();
+
+    //      
+    static size_t GetCapacity();
+};
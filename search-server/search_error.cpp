@@ -0,0 +1,41 @@
+#include "search_error.h"
+
+#include <stdexcept>
+
+const char* GetSearchErrorMessage(SearchError error) {
+    switch (error) {
+    case SearchError::NONE:
+        return "No error";
+    case SearchError::NEGATIVE_DOCUMENT_ID:
+        return "Id of a document cannot be lower than zero";
+    case SearchError::DUPLICATE_DOCUMENT_ID:
+        return "Document with this id is already exists";
+    case SearchError::INVALID_DOCUMENT_CHARACTERS:
+        return "The document text contains invalid characters";
+    case SearchError::INVALID_QUERY_CHARACTERS:
+        return "The query text contains invalid characters";
+    case SearchError::EMPTY_SIGNED_WORD:
+        return "The query text hasn't word after character minus or plus";
+    case SearchError::MULTIPLE_SIGNS:
+        return "The query text contains word which has more than one minus or plus before it";
+    case SearchError::EMPTY_PREFIX:
+        return "The query text hasn't word before asterisk";
+    case SearchError::REQUIRED_PREFIX:
+        return "The query text contains required word with asterisk";
+    case SearchError::PHRASES_NOT_INDEXED:
+        return "Phrase queries require an index with word positions";
+    case SearchError::SIGNED_PHRASE_WORD:
+        return "The phrase contains word with minus or plus before it";
+    case SearchError::INVALID_PHRASE_SUFFIX:
+        return "The phrase has invalid text after closing quote";
+    case SearchError::UNCLOSED_PHRASE:
+        return "The query text has a phrase without closing quote";
+    }
+    return "Unknown error";
+}
+
+void ThrowIfSearchError(SearchError error) {
+    if (error != SearchError::NONE) {
+        throw std::invalid_argument(GetSearchErrorMessage(error));
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <utility>
+#include <variant>
+
+//    SearchServer.  Try*   ,  
+//  std::invalid_argument   GetSearchErrorMessage
+enum class SearchError {
+    NONE,
+    NEGATIVE_DOCUMENT_ID,
+    DUPLICATE_DOCUMENT_ID,
+    INVALID_DOCUMENT_CHARACTERS, //   ( 0-31)   
+    INVALID_QUERY_CHARACTERS,    //     
+    EMPTY_SIGNED_WORD,           // "-"  "+"  
+    MULTIPLE_SIGNS,              // "--word", "+-word"
+    EMPTY_PREFIX,                // "*"   
+    REQUIRED_PREFIX,             // "+word*"
+    PHRASES_NOT_INDEXED,         //        
+    SIGNED_PHRASE_WORD,          // "-"  "+"   
+    INVALID_PHRASE_SUFFIX,       //     ~N
+    UNCLOSED_PHRASE,
+};
+
+const char* GetSearchErrorMessage(SearchError error);
+
+//  std::invalid_argument,  error -  NONE
+void ThrowIfSearchError(SearchError error);
+
+//    ,   std::expected
+template <typename T>
+class Expected {
+public:
+    Expected(T value)
+        : value_(std::move(value))
+    {}
+    // error    NONE
+    Expected(SearchError error)
+        : value_(error)
+    {}
+
+    bool HasValue() const {
+        return value_.index() == 0;
+    }
+
+    explicit operator bool() const {
+        return HasValue();
+    }
+
+    // NONE,   
+    SearchError GetError() const {
+        return HasValue() ? SearchError::NONE : std::get<1>(value_);
+    }
+
+    //  std::invalid_argument,   
+    T& Value() & {
+        ThrowIfSearchError(GetError());
+        return std::get<0>(value_);
+    }
+
+    const T& Value() const& {
+        ThrowIfSearchError(GetError());
+        return std::get<0>(value_);
+    }
+
+    T&& Value() && {
+        ThrowIfSearchError(GetError());
+        return std::get<0>(std::move(value_));
+    }
+
+private:
+    std::variant<T, SearchError> value_;
+};
+
+template <>
+class Expected<void> {
+public:
+    Expected(SearchError error = SearchError::NONE)
+        : error_(error)
+    {}
+
+    bool HasValue() const {
+        return error_ == SearchError::NONE;
+    }
+
+    explicit operator bool() const {
+        return HasValue();
+    }
+
+    SearchError GetError() const {
+        return error_;
+    }
+
+    //  std::invalid_argument  
+    void Value() const {
+        ThrowIfSearchError(error_);
+    }
+
+private:
+    SearchError error_;
+};
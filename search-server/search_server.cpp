@@ -1,47 +1,249 @@
 #include "search_server.h"
 
 #include <cmath>
-#include <numeric>
 #include <iterator>
+#include <limits>
+#include <numeric>
 
+bool StandingQuerySet::IsEmpty() const {
+    return queries_.empty();
+}
 
-SearchServer::SearchServer(const std::string_view& stop_words_text)
-    : SearchServer::SearchServer(SplitIntoWords(stop_words_text))  // Invoke delegating constructor from string container
+void StandingQuerySet::Remove(size_t query_id) {
+    const auto query_it = queries_.find(query_id);
+    if (query_it == queries_.end()) {
+        return;
+    }
+    const auto unlink = [query_id](auto& index, const std::vector<std::string>& keys) {
+        for (const std::string& key : keys) {
+            const auto it = index.find(key);
+            std::vector<size_t>& query_ids = it->second;
+            query_ids.erase(std::find(query_ids.begin(), query_ids.end(), query_id));
+            if (query_ids.empty()) {
+                index.erase(it);
+            }
+        }
+    };
+    unlink(words_, query_it->second.plus_words);
+    unlink(prefixes_, query_it->second.plus_prefixes);
+    queries_.erase(query_it);
+}
+
+size_t StandingQuerySet::Add(Query query) {
+    const size_t query_id = next_query_id_++;
+    for (const std::string& word : query.plus_words) {
+        words_[word].push_back(query_id);
+    }
+    for (const std::string& prefix : query.plus_prefixes) {
+        prefixes_[prefix].push_back(query_id);
+    }
+    queries_.emplace(query_id, std::move(query));
+    return query_id;
+}
+
+SearchServer::SearchServer(const std::string_view& stop_words_text, const IndexOptions& options)
+    : SearchServer::SearchServer(SplitIntoWords(stop_words_text), options)  // Invoke delegating constructor from string container
 {}
 
-SearchServer::SearchServer(const std::string& stop_words_text)
-    : SearchServer::SearchServer(std::string_view{ stop_words_text })
+SearchServer::SearchServer(const std::string& stop_words_text, const IndexOptions& options)
+    : SearchServer::SearchServer(std::string_view{ stop_words_text }, options)
 {}
 
+SearchServer::SearchServer(const SearchServer& other)
+    : stop_words_(other.stop_words_)
+    , stop_words_bytes_(other.stop_words_bytes_)
+    , options_(other.options_)
+    , standing_queries_(other.standing_queries_)
+    , collection_statistics_(other.collection_statistics_)
+    , query_stats_(other.query_stats_)
+{
+    const QueryScratch scratch;
+    std::pmr::memory_resource* scratch_resource = QueryScratch::GetResource();
+    std::pmr::vector<std::pair<uint32_t, double>> terms(scratch_resource);
+    std::pmr::vector<std::pair<uint32_t, std::string_view>> word_positions(scratch_resource);
+    std::pmr::vector<uint32_t> positions(scratch_resource);
+    std::pmr::vector<std::string_view> stored_words(scratch_resource);
+    for (const auto& [document_id, document_data] : other.documents_) {
+        //    ,    IndexDocument
+        terms.clear();
+        word_positions.clear();
+        for (const auto& [word, term_freq] : other.forward_index_.GetWordFrequencies(document_id)) {
+            const auto [stored_word, term_id] = AddDictionaryWord(word);
+            terms.emplace_back(term_id, term_freq);
+            if (options_.store_positions) {
+                other.positions_.GetPositions(document_id, word, positions);
+                for (const uint32_t position : positions) {
+                    word_positions.emplace_back(position, stored_word);
+                }
+            }
+        }
+        IndexDocument(document_id, document_data, terms);
+
+        if (options_.store_positions) {
+            //      
+            std::sort(word_positions.begin(), word_positions.end());
+            stored_words.clear();
+            positions.clear();
+            for (const auto& [position, word] : word_positions) {
+                positions.push_back(position);
+                stored_words.push_back(word);
+            }
+            positions_.AddDocument(document_id, stored_words, positions);
+        }
+    }
+}
+
 void SearchServer::AddDocument(int document_id, const std::string_view& document, DocumentStatus status, const std::vector<int>& ratings) {
+    TryAddDocument(document_id, document, status, ratings).Value();
+}
 
+Expected<void> SearchServer::TryAddDocument(int document_id, const std::string_view& document, DocumentStatus status, const std::vector<int>& ratings) {
+    return TryAddDocumentWithRating(document_id, document, status, ComputeAverageRating(ratings.begin(), ratings.end()));
+}
+
+SearchError SearchServer::TryAddDocumentWithRating(int document_id, const std::string_view& document, DocumentStatus status, int rating) {
+    if (document_id < 0) {
+        return SearchError::NEGATIVE_DOCUMENT_ID;
+    }
+    const QueryScratch scratch;
+    PreparedDocument prepared(QueryScratch::GetResource());
+    prepared.id = document_id;
+    prepared.status = status;
+    prepared.rating = rating;
+    if (const SearchError error = PrepareDocumentWords(document, prepared); error != SearchError::NONE) {
+        return error;
+    }
+    return TryAddPreparedDocument(prepared);
+}
+
+PreparedDocument SearchServer::PrepareDocument(int document_id, const std::string_view& document, DocumentStatus status, const std::vector<int>& ratings) const {
     if (document_id < 0) {
-        throw std::invalid_argument("Id of a document cannot be lower than zero");
+        ThrowIfSearchError(SearchError::NEGATIVE_DOCUMENT_ID);
     }
 
+    PreparedDocument prepared;
+    prepared.id = document_id;
+    prepared.status = status;
+    prepared.rating = ComputeAverageRating(ratings.begin(), ratings.end());
+    ThrowIfSearchError(PrepareDocumentWords(document, prepared));
+    return prepared;
+}
+
+SearchError SearchServer::PrepareDocumentWords(const std::string_view& document, PreparedDocument& prepared) const {
+    prepared.words.clear();
+    prepared.positions.clear();
+    //  -       -,   "cat in city"    "cat city"
+    uint32_t position = 0;
+    //      ,     
+    const bool is_valid = ForEachValidWord(document, [&](std::string_view word) {
+        if (!IsStopWord(word)) {
+            prepared.words.push_back(word);
+            if (options_.store_positions) {
+                prepared.positions.push_back(position);
+            }
+        }
+        ++position;
+        return true;
+        });
+    return is_valid ? SearchError::NONE : SearchError::INVALID_DOCUMENT_CHARACTERS;
+}
+
+void SearchServer::AddPreparedDocument(const PreparedDocument& document) {
+    ThrowIfSearchError(TryAddPreparedDocument(document));
+}
+
+SearchError SearchServer::TryAddPreparedDocument(const PreparedDocument& document) {
+    const int document_id = document.id;
     if (documents_.count(document_id) != 0) {
-        throw std::invalid_argument("Document with this id is already exists");
+        return SearchError::DUPLICATE_DOCUMENT_ID;
     }
 
-    const std::vector<std::string_view> words = SplitIntoWordsNoStop(document);
-    //     
-    for (const std::string_view& word : words) {
-        if (!IsValidWord(word)) {
-            throw std::invalid_argument("The document text contains invalid characters");
+    //    -    
+    const QueryScratch scratch;
+    std::pmr::memory_resource* scratch_resource = QueryScratch::GetResource();
+
+    //       ;     
+    std::pmr::vector<std::pair<std::string_view, uint32_t>> terms(scratch_resource);
+    terms.reserve(document.words.size());
+    std::pmr::vector<std::string_view> stored_words(scratch_resource);
+    if (options_.store_positions) {
+        stored_words.reserve(document.words.size());
+    }
+    for (const std::string_view& word : document.words) {
+        terms.push_back(AddDictionaryWord(word));
+        if (options_.store_positions) {
+            stored_words.push_back(terms.back().first);
         }
     }
+    std::sort(terms.begin(), terms.end());
 
-    std::map<std::string_view, double> words_freqs;
+    std::pmr::vector<std::pair<uint32_t, double>> forward_terms(scratch_resource);
+    forward_terms.reserve(terms.size());
+    const double inv_word_count = 1.0 / document.words.size();
+    for (auto it = terms.begin(); it != terms.end();) {
+        //  -  1 / (- )  ,      
+        double term_freq = 0.0;
+        const auto run_begin = it;
+        for (; it != terms.end() && it->first == run_begin->first; ++it) {
+            term_freq += inv_word_count;
+        }
+        forward_terms.emplace_back(run_begin->second, term_freq);
+    }
+    IndexDocument(document_id, DocumentData{ document.rating, document.status }, forward_terms);
 
-    const double inv_word_count = 1.0 / words.size();
-    for (const std::string_view& word : words) {
-        const auto curr_elem = buffer_.emplace(std::string{ word }); // pair(iterator, bool)
-        word_to_document_freqs_[*(curr_elem.first)][document_id] += inv_word_count;
-        words_freqs[*(curr_elem.first)] += inv_word_count;
+    if (options_.store_positions) {
+        positions_.AddDocument(document_id, stored_words, document.positions);
     }
-    documents_.emplace(document_id, DocumentData{ ComputeAverageRating(ratings), status });
+
+    MatchStandingQueries(standing_queries_, document_id);
+    return SearchError::NONE;
+}
+
+std::pair<std::string_view, uint32_t> SearchServer::AddDictionaryWord(std::string_view word) {
+    auto word_it = buffer_.lower_bound(word);
+    if (word_it == buffer_.end() || std::string_view(word_it->first) != word) {
+        word_it = buffer_.emplace_hint(word_it, word, 0);
+        word_it->second = forward_index_.AddTerm(word_it->first);
+        if (options_.max_typo_distance > 0) {
+            trigrams_.AddWord(word_it->first);
+        }
+    }
+    return { word_it->first, word_it->second };
+}
+
+void SearchServer::IndexDocument(int document_id, const DocumentData& document_data, const std::pmr::vector<std::pair<uint32_t, double>>& terms) {
+    forward_index_.AddDocument(document_id, terms);
+    for (const auto& [word, term_freq] : forward_index_.GetWordFrequencies(document_id)) {
+        word_to_document_freqs_[word].emplace(document_id, term_freq);
+    }
+    documents_.emplace(document_id, document_data);
     ids_of_documents_.insert(document_id);
-    words_with_frequency_by_doc_id_.emplace(document_id, words_freqs);
+    status_bitmaps_[static_cast<size_t>(document_data.status)].Add(document_id);
+    posting_count_ += terms.size();
+
+    if (options_.impact_bits > 0 || options_.bitmap_min_document_freq > 0) {
+        for (const auto& [word, _] : forward_index_.GetWordFrequencies(document_id)) {
+            const std::pmr::map<int, double>& document_freqs = word_to_document_freqs_.at(word);
+            if (options_.impact_bits > 0) {
+                impacts_.AddPosting(word, document_freqs, document_id);
+            }
+            if (options_.bitmap_min_document_freq == 0) {
+                continue;
+            }
+            //      ,       
+            const auto bitmap_it = term_bitmaps_.find(word);
+            if (bitmap_it != term_bitmaps_.end()) {
+                bitmap_it->second.Add(document_id);
+            }
+            else if (document_freqs.size() >= options_.bitmap_min_document_freq) {
+                //   :     
+                RoaringBitmap& bitmap = term_bitmaps_.try_emplace(word, &index_resources_->bitmaps).first->second;
+                for (const auto& [id, _] : document_freqs) {
+                    bitmap.Add(id);
+                }
+            }
+        }
+    }
 }
 
 std::vector<Document> SearchServer::FindTopDocuments(const std::string_view& raw_query, DocumentStatus status) const {
@@ -52,12 +254,44 @@ std::vector<Document> SearchServer::FindTopDocuments(const std::string_view& raw
     return SearchServer::FindTopDocuments(std::execution::seq, raw_query);
 }
 
+TopDocumentsResult SearchServer::FindTopDocuments(const std::string_view& raw_query, const QueryDeadline& deadline) const {
+    return SearchServer::FindTopDocuments(std::execution::seq, raw_query, DocumentStatus::ACTUAL, deadline);
+}
+
+Expected<std::vector<Document>> SearchServer::TryFindTopDocuments(const std::string_view& raw_query, DocumentStatus status) const {
+    return SearchServer::TryFindTopDocuments(std::execution::seq, raw_query, status);
+}
+
+Expected<std::vector<Document>> SearchServer::TryFindTopDocuments(const std::string_view& raw_query) const {
+    return SearchServer::TryFindTopDocuments(std::execution::seq, raw_query);
+}
+
+SearchPage SearchServer::FindPage(const std::string_view& raw_query, size_t page_size, const PageCursor& cursor) const {
+    return SearchServer::FindPage(std::execution::seq, raw_query, page_size, cursor,
+        [](int, DocumentStatus document_status, int) { return document_status == DocumentStatus::ACTUAL; });
+}
+
+SearchPage SearchServer::FindPageAt(const std::string_view& raw_query, size_t page_size, size_t page_index) const {
+    return SearchServer::FindPageAt(std::execution::seq, raw_query, page_size, page_index,
+        [](int, DocumentStatus document_status, int) { return document_status == DocumentStatus::ACTUAL; });
+}
+
 int SearchServer::GetDocumentCount() const {
     return static_cast<int>(documents_.size());
 }
 
+size_t SearchServer::GetDocumentFreq(std::string_view word) const {
+    const auto it = word_to_document_freqs_.find(word);
+    return it == word_to_document_freqs_.end() ? 0 : it->second.size();
+}
+
+void SearchServer::SetCollectionStatistics(const CollectionStatistics* statistics) {
+    collection_statistics_ = statistics;
+}
+
  std::tuple<std::vector<std::string_view>, DocumentStatus> SearchServer::MatchDocument(const std::string_view& raw_query, int document_id) const {
 
+    const QueryScratch scratch;
     const Query query = ParseQuery(raw_query);
         
     std::vector<std::string_view> matched_words;
@@ -72,6 +306,17 @@ int SearchServer::GetDocumentCount() const {
         }
         
     }
+
+    //          
+    for (const std::string_view& word : query.required_words) {
+        const auto it = word_to_document_freqs_.find(word);
+        if (it == word_to_document_freqs_.end() || it->second.count(document_id) == 0) {
+            return std::tuple{ matched_words, documents_.at(document_id).status };
+        }
+    }
+    if (!MatchesPhrases(query, document_id)) {
+        return std::tuple{ matched_words, documents_.at(document_id).status };
+    }
     
     for (const std::string_view& word : query.plus_words) {
         if (word_to_document_freqs_.count(word) == 0) {
@@ -85,7 +330,7 @@ int SearchServer::GetDocumentCount() const {
     return std::tuple{ matched_words, documents_.at(document_id).status };
  }
 
- std::tuple<std::vector<std::string_view>, DocumentStatus> SearchServer::MatchDocument(std::execution::sequenced_policy policy, const std::string_view& raw_query, int document_id) const {
+ std::tuple<std::vector<std::string_view>, DocumentStatus> SearchServer::MatchDocument(std::execution::sequenced_policy, const std::string_view& raw_query, int document_id) const {
 
      return SearchServer::MatchDocument(raw_query, document_id);
 
@@ -93,9 +338,10 @@ int SearchServer::GetDocumentCount() const {
 
  std::tuple<std::vector<std::string_view>, DocumentStatus> SearchServer::MatchDocument(std::execution::parallel_policy policy, const std::string_view& raw_query, int document_id) const {
      
+     const QueryScratch scratch;
      const Query query = ParseQuery(raw_query, false);
 
-     const std::map<std::string_view, double>& word_freq_in_doc = words_with_frequency_by_doc_id_.at(document_id);
+     const WordFrequencies word_freq_in_doc = forward_index_.GetWordFrequencies(document_id);
 
      if (std::any_of(policy,
          query.minus_words.begin(), query.minus_words.end(),
@@ -107,6 +353,16 @@ int SearchServer::GetDocumentCount() const {
          return std::tuple{ std::vector<std::string_view>{}, documents_.at(document_id).status };
      }
 
+     if (!std::all_of(policy,
+         query.required_words.begin(), query.required_words.end(),
+         [&word_freq_in_doc](const std::string_view& word) {
+             return word_freq_in_doc.count(word) != 0;
+         })
+         || !MatchesPhrases(query, document_id))
+     {
+         return std::tuple{ std::vector<std::string_view>{}, documents_.at(document_id).status };
+     }
+
      std::vector<std::string_view> matched_words(query.plus_words.size());
 
      const auto last_it = std::copy_if(policy,
@@ -125,27 +381,113 @@ int SearchServer::GetDocumentCount() const {
 
  }
 
- std::set<int>::const_iterator SearchServer::begin() const {
+ void SearchServer::MatchDocuments(std::execution::sequenced_policy, const std::string_view& raw_query, const std::vector<int>& document_ids, MatchedDocuments& result) const {
+     CheckDocumentIds(document_ids);
+     const QueryScratch scratch;
+     const Query query = ParseQuery(raw_query);
+
+     result.words_.clear();
+     result.offsets_.assign(1, 0);
+     result.statuses_.clear();
+
+     for (const int document_id : document_ids) {
+         const WordFrequencies word_freqs = forward_index_.GetWordFrequencies(document_id);
+         const size_t words_begin = result.words_.size();
+         if (!ForEachMatchedWord(query, word_freqs, [&result](std::string_view word) { result.words_.push_back(word); })
+             || !MatchesPhrases(query, document_id)) {
+             result.words_.resize(words_begin);
+         }
+         result.offsets_.push_back(result.words_.size());
+         result.statuses_.push_back(documents_.at(document_id).status);
+     }
+ }
+
+ void SearchServer::MatchDocuments(std::execution::parallel_policy policy, const std::string_view& raw_query, const std::vector<int>& document_ids, MatchedDocuments& result) const {
+     //      ,  id  
+     CheckDocumentIds(document_ids);
+     const QueryScratch scratch;
+     const Query query = ParseQuery(raw_query);
+
+     //    - ,          
+     result.offsets_.resize(document_ids.size() + 1);
+     result.offsets_[0] = 0;
+     result.statuses_.resize(document_ids.size());
+     std::transform(policy,
+         document_ids.begin(), document_ids.end(),
+         result.offsets_.begin() + 1,
+         [&](int document_id) {
+             const size_t count = CountMatchedWords(query, forward_index_.GetWordFrequencies(document_id));
+             return count != 0 && MatchesPhrases(query, document_id) ? count : 0;
+         });
+     std::inclusive_scan(result.offsets_.begin() + 1, result.offsets_.end(), result.offsets_.begin() + 1);
+
+     result.words_.resize(result.offsets_.back());
+     //        ,   ,    id
+     std::vector<size_t> indexes(document_ids.size());
+     std::iota(indexes.begin(), indexes.end(), 0);
+     std::for_each(policy,
+         indexes.begin(), indexes.end(),
+         [&](size_t index) {
+             const int document_id = document_ids[index];
+             size_t position = result.offsets_[index];
+             if (position != result.offsets_[index + 1]) {
+                 ForEachMatchedWord(query, forward_index_.GetWordFrequencies(document_id),
+                     [&result, &position](std::string_view word) { result.words_[position++] = word; });
+             }
+             result.statuses_[index] = documents_.at(document_id).status;
+         });
+ }
+
+ MatchedDocuments SearchServer::MatchDocuments(const std::string_view& raw_query, const std::vector<int>& document_ids) const {
+     MatchedDocuments result;
+     SearchServer::MatchDocuments(std::execution::seq, raw_query, document_ids, result);
+     return result;
+ }
+
+ std::pmr::set<int>::const_iterator SearchServer::begin() const {
      return ids_of_documents_.begin();
  }
 
- std::set<int>::const_iterator SearchServer::end() const {
+ std::pmr::set<int>::const_iterator SearchServer::end() const {
      return ids_of_documents_.end();
  }
 
- const std::map<std::string_view, double>& SearchServer::GetWordFrequencies(int document_id) const {
-     const auto iter = words_with_frequency_by_doc_id_.find(document_id);
-     if (iter == words_with_frequency_by_doc_id_.end()) { return EMPTY_MAP_WORDS_FREQS_; }
-
-     return iter->second;
+ WordFrequencies SearchServer::GetWordFrequencies(int document_id) const {
+     return forward_index_.GetWordFrequencies(document_id);
  }
 
  void SearchServer::RemoveDocument(int document_id) {
      {
-         auto iter = words_with_frequency_by_doc_id_.find(document_id);
+         //      ,     ,   
+         const WordFrequencies word_freqs = forward_index_.GetWordFrequencies(document_id);
+         std::vector<std::string_view> words_for_erase;
+         words_for_erase.reserve(word_freqs.size());
+         for (const auto& word_freq : word_freqs) {
+             words_for_erase.push_back(word_freq.first);
+         }
+         posting_count_ -= words_for_erase.size();
+         forward_index_.RemoveDocument(document_id);
+
+         for (const std::string_view word : words_for_erase) {
+             const auto it = word_to_document_freqs_.find(word);
+             it->second.erase(document_id);
+             if (options_.impact_bits > 0) {
+                 impacts_.RemovePosting(word, document_id);
+             }
+             const auto bitmap_it = term_bitmaps_.find(word);
+             if (bitmap_it != term_bitmaps_.end()) {
+                 bitmap_it->second.Remove(document_id);
+                 if (it->second.size() * 2 < options_.bitmap_min_document_freq) {
+                     term_bitmaps_.erase(bitmap_it);
+                 }
+             }
 
-         if (iter != words_with_frequency_by_doc_id_.end()) {
-             words_with_frequency_by_doc_id_.erase(iter);
+             //         ,  
+             if (it->second.empty()) {
+                 const std::string_view buffered_word = it->first;
+                 word_to_document_freqs_.erase(it);
+                 EraseWordFromBuffer(buffered_word);
+             }
          }
      }
 
@@ -153,10 +495,13 @@ int SearchServer::GetDocumentCount() const {
          auto iter = documents_.find(document_id);
 
          if (iter != documents_.end()) {
+             status_bitmaps_[static_cast<size_t>(iter->second.status)].Remove(document_id);
              documents_.erase(iter);
          }
      }
 
+     positions_.RemoveDocument(document_id);
+
      {
          for (auto iter = ids_of_documents_.begin(); iter != ids_of_documents_.end(); ++iter) {
             if (*iter == document_id) {
@@ -165,64 +510,59 @@ int SearchServer::GetDocumentCount() const {
             }
          }
      }
-
-     {
-         for (auto it = word_to_document_freqs_.begin(); it != word_to_document_freqs_.end();) {
-                          
-             auto iter = it->second.find(document_id);
-             if (iter != it->second.end()) {
-                 it->second.erase(iter);
-             }
-
-             //         ,  
-             if (0 == it->second.size()) {
-                 EraseWordFromBuffer(it->first);
-                 it = word_to_document_freqs_.erase(it);
-             }
-             else {
-                 ++it;
-             }
-
-         }
-     }
-     
  }
 
- void SearchServer::RemoveDocument(std::execution::sequenced_policy policy, int document_id) {
+ void SearchServer::RemoveDocument(std::execution::sequenced_policy, int document_id) {
      SearchServer::RemoveDocument(document_id);
  }
 
  void SearchServer::RemoveDocument(std::execution::parallel_policy policy, int document_id) {
-     
+     TRACE_DURATION("RemoveDocument(par)");
      {
-         auto iter = words_with_frequency_by_doc_id_.find(document_id);
-
-         if (iter == words_with_frequency_by_doc_id_.end()) { return; }
-         else {             
-             std::vector<const std::string_view*> words_for_erase(iter->second.size());
-                          
-             std::transform(policy,
-                 iter->second.begin(),
-                 iter->second.end(),
-                 words_for_erase.begin(),
-                 [](auto& word_freq) { return &(word_freq).first; } //&const_cast<std::string&>(word_freq.first);
-             );
+         if (documents_.count(document_id) == 0) { return; }
+         else {
+             const WordFrequencies word_freqs = forward_index_.GetWordFrequencies(document_id);
+             std::vector<std::string_view> words_for_erase;
+             words_for_erase.reserve(word_freqs.size());
+             for (const auto& word_freq : word_freqs) {
+                 words_for_erase.push_back(word_freq.first);
+             }
              
+             const TraceContext trace_context = TraceSpan::GetCurrentContext();
              std::for_each(policy, 
                            words_for_erase.begin(), 
                            words_for_erase.end(), 
-                           [&](auto& word) {
-                                                                
-                                auto& elem = word_to_document_freqs_.at(*word);
-                                elem.erase(document_id);
-                                //        ,    
-                                if (0 == elem.size()) {
-                                    EraseWordFromBuffer(*word);
+                           [&](std::string_view word) {
+                                const TraceContextScope trace_scope(trace_context);
+                                TRACE_DURATION("RemoveDocument(par) word");
+                                word_to_document_freqs_.at(word).erase(document_id);
+                                if (options_.impact_bits > 0) {
+                                    impacts_.RemovePosting(word, document_id);
+                                }
+                                //    ;    , 
+                                const auto bitmap_it = term_bitmaps_.find(word);
+                                if (bitmap_it != term_bitmaps_.end()) {
+                                    bitmap_it->second.Remove(document_id);
                                 }
                            }
              );
+
+             //       ,     :
+             //  ,  string_view     ,   
+             for (const std::string_view word : words_for_erase) {
+                 const auto it = word_to_document_freqs_.find(word);
+                 if (it->second.size() * 2 < options_.bitmap_min_document_freq) {
+                     term_bitmaps_.erase(word);
+                 }
+                 if (it->second.empty()) {
+                     const std::string_view buffered_word = it->first;
+                     word_to_document_freqs_.erase(it);
+                     EraseWordFromBuffer(buffered_word);
+                 }
+             }
              
-             words_with_frequency_by_doc_id_.erase(iter);
+             posting_count_ -= words_for_erase.size();
+             forward_index_.RemoveDocument(document_id);
          }
      }
 
@@ -231,31 +571,103 @@ int SearchServer::GetDocumentCount() const {
 
          if (iter == documents_.end()) { return; }
          else {
+             status_bitmaps_[static_cast<size_t>(iter->second.status)].Remove(document_id);
              documents_.erase(iter);
          }
      }
 
+     positions_.RemoveDocument(document_id);
+
      {        
          ids_of_documents_.erase(std::find(policy, ids_of_documents_.begin(), ids_of_documents_.end(), document_id));
      }
 
  }
-  
+
+ QueryStatsSnapshot SearchServer::GetQueryStats() const {
+     return query_stats_.GetSnapshot();
+ }
+
+ void SearchServer::ResetQueryStats() {
+     query_stats_.Reset();
+ }
+
+ MemoryStats SearchServer::GetMemoryStats() const {
+     MemoryStats stats;
+     const auto set_usage = [&stats](MemoryStructure structure, size_t bytes, size_t entries) {
+         stats.structures[static_cast<size_t>(structure)] = { bytes, entries };
+     };
+     set_usage(MemoryStructure::TERM_DICTIONARY, index_resources_->dictionary.GetAllocatedBytes(), buffer_.size());
+     set_usage(MemoryStructure::INVERTED_POSTINGS, index_resources_->postings.GetAllocatedBytes(), posting_count_);
+     set_usage(MemoryStructure::FORWARD_INDEX, index_resources_->forward_index.GetAllocatedBytes(), forward_index_.GetEntryCount());
+     set_usage(MemoryStructure::DOCUMENT_METADATA, index_resources_->documents.GetAllocatedBytes(), documents_.size());
+     set_usage(MemoryStructure::STOP_WORDS, stop_words_bytes_, stop_words_.size());
+     set_usage(MemoryStructure::POSITIONS, index_resources_->positions.GetAllocatedBytes(), positions_.GetPositionCount());
+     set_usage(MemoryStructure::TRIGRAMS, index_resources_->trigrams.GetAllocatedBytes(), trigrams_.GetEntryCount());
+     size_t bitmap_entries = 0;
+     for (const auto& [_, bitmap] : term_bitmaps_) {
+         bitmap_entries += bitmap.GetCardinality();
+     }
+     set_usage(MemoryStructure::TERM_BITMAPS, index_resources_->bitmaps.GetAllocatedBytes(), bitmap_entries);
+     set_usage(MemoryStructure::IMPACTS, index_resources_->impacts.GetAllocatedBytes(), options_.impact_bits > 0 ? posting_count_ : 0);
+
+     for (const MemoryUsage& usage : stats.structures) {
+         stats.used_bytes += usage.bytes;
+     }
+     // -          
+     const size_t pooled_bytes = stats.used_bytes - stop_words_bytes_;
+     stats.reserved_bytes = index_resources_->heap.GetAllocatedBytes();
+     stats.allocator_overhead_bytes = stats.reserved_bytes > pooled_bytes ? stats.reserved_bytes - pooled_bytes : 0;
+     if (stats.reserved_bytes > 0) {
+         stats.fragmentation = static_cast<double>(stats.allocator_overhead_bytes) / stats.reserved_bytes;
+     }
+     return stats;
+ }
+
+ size_t SearchServer::EstimateStopWordsBytes(const std::set<std::string, std::less<>>& stop_words) {
+     //  - :      
+     const size_t node_size = 4 * sizeof(void*) + sizeof(std::string);
+     const size_t inline_capacity = std::string().capacity();
+     size_t bytes = 0;
+     for (const std::string& word : stop_words) {
+         bytes += node_size;
+         if (word.size() > inline_capacity) {
+             bytes += word.capacity() + 1;
+         }
+     }
+     return bytes;
+ }
+
+ std::vector<std::string_view> SearchServer::GetCompletions(std::string_view prefix, size_t max_count) const {
+     std::vector<std::pair<size_t, std::string_view>> candidates;
+     for (auto it = word_to_document_freqs_.lower_bound(prefix);
+         it != word_to_document_freqs_.end() && it->first.substr(0, prefix.size()) == prefix; ++it) {
+         candidates.emplace_back(it->second.size(), it->first);
+     }
+
+     const size_t count = std::min(max_count, candidates.size());
+     std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+         [](const auto& lhs, const auto& rhs) {
+             return lhs.first != rhs.first ? lhs.first > rhs.first : lhs.second < rhs.second;
+         });
+
+     std::vector<std::string_view> completions(count);
+     std::transform(candidates.begin(), candidates.begin() + count, completions.begin(),
+         [](const auto& candidate) { return candidate.second; });
+     return completions;
+ }
+
+ QueryPlan SearchServer::ExplainQuery(const std::string_view& raw_query) const {
+     const QueryScratch scratch;
+     //   ,       ,    
+     return PlanQuery(ParseQuery(raw_query), std::pmr::get_default_resource());
+ }
+
 // private
 bool SearchServer::IsStopWord(const std::string_view& word) const {
     return stop_words_.count(word) > 0;
 }
 
-std::vector<std::string_view> SearchServer::SplitIntoWordsNoStop(const std::string_view& text) const {
-    std::vector<std::string_view> words;
-    for (const std::string_view& word : SplitIntoWords(text)) {
-        if (!IsStopWord(word)) {
-            words.push_back(word);
-        }
-    }
-    return words;
-}
-
 bool SearchServer::IsValidWord(const std::string_view& word) {
     // A valid word must not contain special characters
     return std::none_of(word.begin(), word.end(), [](char c) {
@@ -263,38 +675,81 @@ bool SearchServer::IsValidWord(const std::string_view& word) {
         });
 }
 
-int SearchServer::ComputeAverageRating(const std::vector<int>& ratings) {
-    if (ratings.empty()) {
-        return 0;
-    }
-    int rating_sum = std::accumulate(ratings.begin(), ratings.end(), 0);
-
-    return rating_sum / static_cast<int>(ratings.size());
-}
-
 SearchServer::QueryWord SearchServer::ParseQueryWord(std::string_view text) const {
     bool is_minus = false;
+    bool is_required = false;
     // Word shouldn't be empty
     if (text[0] == '-') {
         is_minus = true;
         text = text.substr(1);
     }
-    return { text, is_minus, IsStopWord(text) };
+    else if (text[0] == '+') {
+        is_required = true;
+        text = text.substr(1);
+    }
+    return { text, is_minus, is_required, IsStopWord(text) };
 }
 
-SearchServer::Query SearchServer::ParseQuery(const std::string_view& text, const bool is_remove_duplicates) const {
-    SearchServer::Query query;
-    for (const std::string_view& word : SplitIntoWords(text)) {
+SearchError SearchServer::TryParseQuery(const std::string_view& text, Query& query, const bool is_remove_duplicates) const {
+    SearchError error = SearchError::NONE;
+    Phrase phrase;
+    uint32_t phrase_offset = 0;
+    bool is_in_phrase = false;
+    //     ,      ;
+    //      ,     
+    const bool is_valid_text = ForEachValidWord(text, [&](const std::string_view& word) {
+        //       "...",        
+        if (!is_in_phrase && word[0] == '"' && !options_.store_positions) {
+            const size_t rest_begin = static_cast<size_t>(word.data() - text.data()) + 1;
+            if (text.find('"', rest_begin) != std::string_view::npos) {
+                error = SearchError::PHRASES_NOT_INDEXED;
+                return false;
+            }
+        }
+        else if (!is_in_phrase && word[0] == '"') {
+            phrase = {};
+            phrase_offset = 0;
+            bool is_closed = false;
+            error = ParsePhraseWord(word.substr(1), phrase, phrase_offset, query, is_closed);
+            is_in_phrase = !is_closed;
+            return error == SearchError::NONE;
+        }
+        if (is_in_phrase) {
+            bool is_closed = false;
+            error = ParsePhraseWord(word, phrase, phrase_offset, query, is_closed);
+            is_in_phrase = !is_closed;
+            return error == SearchError::NONE;
+        }
+
         const QueryWord query_word = ParseQueryWord(word);
 
-        if (!IsValidWord(word)) {
-            throw std::invalid_argument("The query text contains invalid characters");
+        if (query_word.data.size() == 0) {
+            error = SearchError::EMPTY_SIGNED_WORD;
+            return false;
         }
-        if (query_word.data[0] == '-') {
-            throw std::invalid_argument("The query text contains word which has more than one minus before it");
+        if (query_word.data[0] == '-' || query_word.data[0] == '+') {
+            error = SearchError::MULTIPLE_SIGNS;
+            return false;
         }
-        if (query_word.data.size() == 0) {
-            throw std::invalid_argument("The query text hasn't word after character minus");
+
+        //   "*"        
+        if (query_word.data.back() == '*') {
+            const std::string_view prefix = query_word.data.substr(0, query_word.data.size() - 1);
+            if (prefix.empty()) {
+                error = SearchError::EMPTY_PREFIX;
+                return false;
+            }
+            if (query_word.is_required) {
+                error = SearchError::REQUIRED_PREFIX;
+                return false;
+            }
+            if (query_word.is_minus) {
+                ExpandPrefix(prefix, std::numeric_limits<size_t>::max(), query.minus_words);
+            }
+            else {
+                ExpandPrefix(prefix, options_.max_prefix_expansions, query.plus_words);
+            }
+            return true;
         }
 
         if (!query_word.is_stop) {
@@ -303,8 +758,26 @@ SearchServer::Query SearchServer::ParseQuery(const std::string_view& text, const
             }
             else {
                 query.plus_words.push_back(query_word.data);
+                if (query_word.is_required) {
+                    query.required_words.push_back(query_word.data);
+                }
             }
         }
+        return true;
+        });
+
+    if (!is_valid_text) {
+        return SearchError::INVALID_QUERY_CHARACTERS;
+    }
+    if (error != SearchError::NONE) {
+        return error;
+    }
+    if (is_in_phrase) {
+        return SearchError::UNCLOSED_PHRASE;
+    }
+
+    if (options_.max_typo_distance > 0) {
+        CorrectTypos(query);
     }
 
     //   
@@ -312,23 +785,476 @@ SearchServer::Query SearchServer::ParseQuery(const std::string_view& text, const
         RemoveDublicatesFromVector(query.minus_words);
         RemoveDublicatesFromVector(query.plus_words);
     }
+    RemoveDublicatesFromVector(query.required_words);
+
+    return SearchError::NONE;
+}
 
+SearchServer::Query SearchServer::ParseQuery(const std::string_view& text, const bool is_remove_duplicates) const {
+    Query query;
+    ThrowIfSearchError(TryParseQuery(text, query, is_remove_duplicates));
     return query;
 }
 
-void SearchServer::RemoveDublicatesFromVector(std::vector<std::string_view>& v_words) const {
-    std::sort(v_words.begin(), v_words.end());
-    v_words.erase(std::unique(v_words.begin(), v_words.end()), v_words.end());
+SearchError SearchServer::TryParseQueryTimed(const std::string_view& text, Query& query) const {
+    const QueryStageTimer parse_timer(query_stats_, QueryStage::PARSE);
+    return TryParseQuery(text, query);
+}
+
+SearchServer::Query SearchServer::ParseQueryTimed(const std::string_view& text) const {
+    Query query;
+    ThrowIfSearchError(TryParseQueryTimed(text, query));
+    return query;
+}
+
+bool SearchServer::IsBetterDocument(const Document& lhs, const Document& rhs) {
+    const double EPSILON = 1e-6; // 
+
+    if (std::abs(lhs.relevance - rhs.relevance) >= EPSILON) {
+        return lhs.relevance > rhs.relevance;
+    }
+    if (lhs.rating != rhs.rating) {
+        return lhs.rating > rhs.rating;
+    }
+    return lhs.id < rhs.id;
+}
+
+std::pmr::vector<int> SearchServer::IntersectRequiredWords(const std::pmr::vector<std::string_view>& required_words) const {
+    std::pmr::memory_resource* scratch = QueryScratch::GetResource();
+    std::pmr::vector<const std::pmr::map<int, double>*> document_lists(scratch);
+    for (const std::string_view& word : required_words) {
+        const auto it = word_to_document_freqs_.find(word);
+        if (it == word_to_document_freqs_.end()) {
+            return std::pmr::vector<int>(scratch);
+        }
+        document_lists.push_back(&it->second);
+    }
+
+    //     ,        
+    std::sort(document_lists.begin(), document_lists.end(),
+        [](const auto* lhs, const auto* rhs) { return lhs->size() < rhs->size(); });
+
+    std::pmr::vector<int> candidates(scratch);
+    candidates.reserve(document_lists.front()->size());
+    for (const auto& [document_id, _] : *document_lists.front()) {
+        candidates.push_back(document_id);
+    }
+
+    for (size_t i = 1; i < document_lists.size() && !candidates.empty(); ++i) {
+        const std::pmr::map<int, double>& documents = *document_lists[i];
+        auto last_it = candidates.begin();
+        //    ,    ,    ,
+        //   .       
+        if (candidates.size() * 16 < documents.size()) {
+            last_it = std::remove_if(candidates.begin(), candidates.end(),
+                [&documents](int document_id) { return documents.count(document_id) == 0; });
+        }
+        else {
+            auto doc_it = documents.begin();
+            for (const int document_id : candidates) {
+                while (doc_it != documents.end() && doc_it->first < document_id) {
+                    ++doc_it;
+                }
+                if (doc_it == documents.end()) {
+                    break;
+                }
+                if (doc_it->first == document_id) {
+                    *last_it++ = document_id;
+                }
+            }
+        }
+        candidates.erase(last_it, candidates.end());
+    }
+    return candidates;
+}
+
+void SearchServer::CorrectTypos(Query& query) const {
+    const size_t literal_count = query.plus_words.size();
+    for (size_t i = 0; i < literal_count; ++i) {
+        const std::string_view word = query.plus_words[i];
+        //          
+        if (GetCollectionDocumentFreq(word, GetDocumentFreq(word)) != 0) {
+            continue;
+        }
+
+        std::vector<std::pair<std::string_view, int>> similar_words = trigrams_.FindSimilarWords(word, options_.max_typo_distance);
+        const size_t count = std::min(similar_words.size(), options_.max_typo_expansions);
+        std::partial_sort(similar_words.begin(), similar_words.begin() + count, similar_words.end(),
+            [](const auto& lhs, const auto& rhs) {
+                return lhs.second != rhs.second ? lhs.second < rhs.second : lhs.first < rhs.first;
+            });
+
+        for (size_t j = 0; j < count; ++j) {
+            const auto [similar_word, distance] = similar_words[j];
+            const double weight = std::pow(options_.typo_penalty, distance);
+            const auto [it, is_inserted] = query.word_weights.emplace(similar_word, weight);
+            if (!is_inserted) {
+                it->second = std::max(it->second, weight);
+            }
+            query.plus_words.push_back(similar_word);
+        }
+    }
+
+    // ,       ,    
+    for (size_t i = 0; i < literal_count; ++i) {
+        query.word_weights.erase(query.plus_words[i]);
+    }
+}
+
+double SearchServer::GetWordWeight(const Query& query, std::string_view word) {
+    if (query.word_weights.empty()) {
+        return 1.0;
+    }
+    const auto it = query.word_weights.find(word);
+    return it == query.word_weights.end() ? 1.0 : it->second;
+}
+
+void SearchServer::ExpandPrefix(std::string_view prefix, size_t max_count, std::pmr::vector<std::string_view>& words) const {
+    //  word_to_document_freqs_ ,       
+    size_t count = 0;
+    for (auto it = word_to_document_freqs_.lower_bound(prefix);
+        it != word_to_document_freqs_.end() && count < max_count
+        && it->first.substr(0, prefix.size()) == prefix; ++it, ++count) {
+        words.push_back(it->first);
+    }
+}
+
+SearchError SearchServer::ParsePhraseWord(std::string_view text, Phrase& phrase, uint32_t& offset, Query& query, bool& is_closed) const {
+    const size_t quote = text.find('"');
+    const std::string_view word = text.substr(0, quote);
+    if (!word.empty()) {
+        if (word[0] == '-' || word[0] == '+') {
+            return SearchError::SIGNED_PHRASE_WORD;
+        }
+        if (!IsStopWord(word)) {
+            phrase.words.push_back(word);
+            phrase.offsets.push_back(offset);
+            query.plus_words.push_back(word);
+            query.required_words.push_back(word);
+        }
+        ++offset;
+    }
+    if (quote == std::string_view::npos) {
+        is_closed = false;
+        return SearchError::NONE;
+    }
+    is_closed = true;
+
+    //      ~N -  -     
+    const std::string_view suffix = text.substr(quote + 1);
+    if (!suffix.empty()) {
+        if (suffix[0] != '~' || suffix.size() < 2 || suffix.size() > 10
+            || !std::all_of(suffix.begin() + 1, suffix.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            return SearchError::INVALID_PHRASE_SUFFIX;
+        }
+        uint32_t words_between = 0;
+        for (const char c : suffix.substr(1)) {
+            words_between = words_between * 10 + static_cast<uint32_t>(c - '0');
+        }
+        phrase.max_gap = words_between + 1;
+    }
+
+    //     -   
+    if (phrase.words.size() > 1) {
+        query.phrases.push_back(std::move(phrase));
+    }
+    return SearchError::NONE;
+}
+
+bool SearchServer::MatchesPhrases(const Query& query, int document_id) const {
+    std::pmr::memory_resource* scratch = QueryScratch::GetResource();
+    std::pmr::vector<std::pmr::vector<uint32_t>> positions(scratch);
+    std::pmr::vector<uint32_t> reachable(scratch);
+    std::pmr::vector<uint32_t> next_reachable(scratch);
+    for (const Phrase& phrase : query.phrases) {
+        positions.resize(phrase.words.size());
+        for (size_t i = 0; i < phrase.words.size(); ++i) {
+            if (!positions_.GetPositions(document_id, phrase.words[i], positions[i])) {
+                return false;
+            }
+        }
+
+        if (phrase.max_gap == 0) {
+            const bool is_found = std::any_of(positions[0].begin(), positions[0].end(), [&](uint32_t first_position) {
+                for (size_t i = 1; i < positions.size(); ++i) {
+                    const uint32_t expected = first_position + phrase.offsets[i] - phrase.offsets[0];
+                    if (!std::binary_search(positions[i].begin(), positions[i].end(), expected)) {
+                        return false;
+                    }
+                }
+                return true;
+                });
+            if (!is_found) {
+                return false;
+            }
+            continue;
+        }
+
+        // reachable -   ,        
+        reachable = positions[0];
+        for (size_t i = 1; i < positions.size() && !reachable.empty(); ++i) {
+            next_reachable.clear();
+            auto it = reachable.begin();
+            for (const uint32_t position : positions[i]) {
+                while (it != reachable.end() && *it < position) {
+                    ++it;
+                }
+                if (it != reachable.begin() && *std::prev(it) + phrase.max_gap >= position) {
+                    next_reachable.push_back(position);
+                }
+            }
+            reachable.swap(next_reachable);
+        }
+        if (reachable.empty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t SearchServer::CountMatchedWords(const Query& query, const WordFrequencies& word_freqs) {
+    size_t count = 0;
+    if (!ForEachMatchedWord(query, word_freqs, [&count](std::string_view) { ++count; })) {
+        return 0;
+    }
+    return count;
+}
+
+QueryPlan SearchServer::PlanQuery(const Query& query, std::pmr::memory_resource* resource) const {
+    QueryPlan plan(resource);
+    plan.phrase_count = query.phrases.size();
+    const size_t document_count = documents_.size();
+    const size_t collection_document_count = GetCollectionDocumentCount();
+
+    const auto make_term = [this, &query](const std::string_view word, const std::pmr::map<int, double>& documents) {
+        const double weight = GetWordWeight(query, word);
+        return QueryPlan::Term{ word, documents.size(), ComputeWordInverseDocumentFreq(word) * weight, weight };
+    };
+    const auto by_document_freq = [](const QueryPlan::Term& lhs, const QueryPlan::Term& rhs) {
+        return lhs.document_freq < rhs.document_freq;
+    };
+
+    for (const std::string_view& word : query.plus_words) {
+        const auto it = word_to_document_freqs_.find(word);
+        if (it == word_to_document_freqs_.end()) {
+            plan.dropped_words.push_back(word);
+        }
+        else if (GetCollectionDocumentFreq(word, it->second.size()) == collection_document_count) {
+            // IDF = 0:    ,          
+            plan.dropped_words.push_back(word);
+            plan.matches_all_documents = true;
+        }
+        else {
+            plan.plus_terms.push_back(make_term(it->first, it->second));
+        }
+    }
+    for (const std::string_view& word : query.minus_words) {
+        const auto it = word_to_document_freqs_.find(word);
+        if (it != word_to_document_freqs_.end()) {
+            plan.minus_terms.push_back(make_term(it->first, it->second));
+        }
+    }
+    for (const std::string_view& word : query.required_words) {
+        const auto it = word_to_document_freqs_.find(word);
+        plan.required_terms.push_back(it == word_to_document_freqs_.end()
+            ? QueryPlan::Term{ word, 0, 0.0, 1.0 }
+            : make_term(it->first, it->second));
+    }
+    std::sort(plan.plus_terms.begin(), plan.plus_terms.end(), by_document_freq);
+    std::sort(plan.minus_terms.begin(), plan.minus_terms.end(), by_document_freq);
+    std::sort(plan.required_terms.begin(), plan.required_terms.end(), by_document_freq);
+
+    size_t plus_postings = 0;
+    for (const QueryPlan::Term& term : plan.plus_terms) {
+        plus_postings += term.document_freq;
+    }
+    size_t minus_postings = 0;
+    for (const QueryPlan::Term& term : plan.minus_terms) {
+        //      64   
+        minus_postings += FindTermBitmap(term.word) != nullptr ? term.document_freq / 64 : term.document_freq;
+    }
+
+    if (!plan.required_terms.empty()) {
+        plan.strategy = QueryStrategy::CONJUNCTIVE;
+        plan.estimated_cost = plan.required_terms.front().document_freq * plan.required_terms.size() + minus_postings;
+        return plan;
+    }
+
+    //      ,   id    
+    const size_t universe = ids_of_documents_.empty() ? 0 : static_cast<size_t>(*ids_of_documents_.rbegin()) + 1;
+    const bool is_dense = universe <= 4 * document_count + 64;
+
+    if (is_dense && (plan.matches_all_documents || plus_postings * 8 >= universe)) {
+        plan.strategy = QueryStrategy::BITMAP;
+        plan.estimated_cost = plus_postings + minus_postings + universe / 64;
+    }
+    else if (plan.matches_all_documents || plan.plus_terms.size() <= 1) {
+        plan.strategy = QueryStrategy::TERM_AT_A_TIME;
+        plan.estimated_cost = plus_postings + minus_postings + (plan.matches_all_documents ? document_count : 0);
+    }
+    else {
+        plan.strategy = QueryStrategy::DOCUMENT_AT_A_TIME;
+        plan.estimated_cost = plus_postings + minus_postings;
+    }
+    return plan;
 }
 
 // Existence required
 double SearchServer::ComputeWordInverseDocumentFreq(const std::string_view& word) const {
-    return std::log(GetDocumentCount() * 1.0 / word_to_document_freqs_.at(word).size());
+    const size_t local_freq = word_to_document_freqs_.at(word).size();
+    return std::log(GetCollectionDocumentCount() * 1.0 / GetCollectionDocumentFreq(word, local_freq));
+}
+
+size_t SearchServer::RegisterStandingQuery(const std::string_view& raw_query, StandingQueryCallback callback) {
+    return RegisterStandingQuery(standing_queries_, raw_query, std::move(callback));
+}
+
+void SearchServer::UnregisterStandingQuery(size_t query_id) {
+    standing_queries_.Remove(query_id);
+}
+
+size_t SearchServer::RegisterStandingQuery(StandingQuerySet& queries, const std::string_view& raw_query, StandingQueryCallback callback) const {
+    StandingQuerySet::Query query = ParseStandingQuery(raw_query);
+    query.callback = std::move(callback);
+    return queries.Add(std::move(query));
+}
+
+StandingQuerySet::Query SearchServer::ParseStandingQuery(const std::string_view& raw_query) const {
+    StandingQuerySet::Query query;
+    ForEachWord(raw_query, [&](const std::string_view& word) {
+        if (word[0] == '"') {
+            throw std::invalid_argument("Standing queries do not support phrases");
+        }
+        const QueryWord query_word = ParseQueryWord(word);
+        if (!IsValidWord(word)) {
+            ThrowIfSearchError(SearchError::INVALID_QUERY_CHARACTERS);
+        }
+        if (query_word.data.size() == 0) {
+            ThrowIfSearchError(SearchError::EMPTY_SIGNED_WORD);
+        }
+        if (query_word.data[0] == '-' || query_word.data[0] == '+') {
+            ThrowIfSearchError(SearchError::MULTIPLE_SIGNS);
+        }
+
+        if (query_word.data.back() == '*') {
+            const std::string_view prefix = query_word.data.substr(0, query_word.data.size() - 1);
+            if (prefix.empty()) {
+                ThrowIfSearchError(SearchError::EMPTY_PREFIX);
+            }
+            if (query_word.is_required) {
+                ThrowIfSearchError(SearchError::REQUIRED_PREFIX);
+            }
+            (query_word.is_minus ? query.minus_prefixes : query.plus_prefixes).emplace_back(prefix);
+            return;
+        }
+        if (query_word.is_stop) {
+            return;
+        }
+        if (query_word.is_minus) {
+            query.minus_words.emplace_back(query_word.data);
+        }
+        else {
+            query.plus_words.emplace_back(query_word.data);
+            if (query_word.is_required) {
+                query.required_words.emplace_back(query_word.data);
+            }
+        }
+        });
+
+    for (std::vector<std::string>* words : { &query.plus_words, &query.required_words, &query.minus_words, &query.plus_prefixes, &query.minus_prefixes }) {
+        std::sort(words->begin(), words->end());
+        words->erase(std::unique(words->begin(), words->end()), words->end());
+    }
+    return query;
+}
+
+void SearchServer::MatchStandingQueries(const StandingQuerySet& queries, int document_id) const {
+    const DocumentData& document = documents_.at(document_id);
+    if (queries.IsEmpty() || document.status != DocumentStatus::ACTUAL) {
+        return;
+    }
+    const WordFrequencies word_freqs = forward_index_.GetWordFrequencies(document_id);
+
+    //  - ,   -     "*"    
+    std::pmr::vector<size_t> candidates(QueryScratch::GetResource());
+    for (const auto& [word, _] : word_freqs) {
+        const auto word_it = queries.words_.find(word);
+        if (word_it != queries.words_.end()) {
+            candidates.insert(candidates.end(), word_it->second.begin(), word_it->second.end());
+        }
+        if (!queries.prefixes_.empty()) {
+            for (size_t size = 1; size <= word.size(); ++size) {
+                const auto prefix_it = queries.prefixes_.find(word.substr(0, size));
+                if (prefix_it != queries.prefixes_.end()) {
+                    candidates.insert(candidates.end(), prefix_it->second.begin(), prefix_it->second.end());
+                }
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    const auto has_prefix = [](const std::vector<std::string>& prefixes, std::string_view word) {
+        return std::any_of(prefixes.begin(), prefixes.end(),
+            [word](const std::string& prefix) { return word.substr(0, prefix.size()) == prefix; });
+    };
+    for (const size_t query_id : candidates) {
+        const StandingQuerySet::Query& query = queries.queries_.at(query_id);
+        const bool has_required_words = std::all_of(query.required_words.begin(), query.required_words.end(),
+            [&word_freqs](const std::string& word) { return word_freqs.count(word) != 0; });
+        if (!has_required_words) {
+            continue;
+        }
+        // ,    -,      "*",   ,   FindTopDocuments
+        double relevance = 0.0;
+        bool is_excluded = false;
+        for (const auto& [word, term_freq] : word_freqs) {
+            if (std::binary_search(query.minus_words.begin(), query.minus_words.end(), word) || has_prefix(query.minus_prefixes, word)) {
+                is_excluded = true;
+                break;
+            }
+            if (std::binary_search(query.plus_words.begin(), query.plus_words.end(), word) || has_prefix(query.plus_prefixes, word)) {
+                relevance += term_freq * ComputeWordInverseDocumentFreq(word);
+            }
+        }
+        if (!is_excluded) {
+            query.callback({ document_id, relevance, document.rating });
+        }
+    }
+}
+
+const RoaringBitmap* SearchServer::FindTermBitmap(std::string_view word) const {
+    const auto it = term_bitmaps_.find(word);
+    return it == term_bitmaps_.end() ? nullptr : &it->second;
+}
+
+void SearchServer::CheckDocumentIds(const std::vector<int>& document_ids) const {
+    for (const int document_id : document_ids) {
+        if (documents_.count(document_id) == 0) {
+            throw std::out_of_range("Document with this id is not found");
+        }
+    }
+}
+
+size_t SearchServer::GetCollectionDocumentCount() const {
+    return collection_statistics_ == nullptr ? documents_.size() : collection_statistics_->GetDocumentCount();
+}
+
+size_t SearchServer::GetCollectionDocumentFreq(std::string_view word, size_t local_freq) const {
+    return collection_statistics_ == nullptr ? local_freq : collection_statistics_->GetDocumentFreq(word);
 }
 
 void SearchServer::EraseWordFromBuffer(std::string_view sv_word) {
-    const auto it_word = buffer_.find(std::string{ sv_word });
+    if (options_.max_typo_distance > 0) {
+        trigrams_.RemoveWord(sv_word);
+    }
+    if (options_.impact_bits > 0) {
+        impacts_.RemoveWord(sv_word);
+    }
+    term_bitmaps_.erase(sv_word);
+    const auto it_word = buffer_.find(sv_word);
     if (it_word != buffer_.end()) {
+        forward_index_.RemoveTerm(it_word->second);
         buffer_.erase(it_word);
     }
 }
\ No newline at end of file
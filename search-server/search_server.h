@@ -1,6 +1,8 @@
 #pragma once
 
+#include <array>
 #include <string>
+#include <type_traits>
 #include <vector>
 #include <map>
 #include <set>
@@ -9,10 +11,150 @@
 #include <typeinfo>
 #include <execution>
 #include <string_view>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <memory_resource>
 
 #include "document.h"
 #include "string_processing.h"
 #include "concurrent_map.h"
+#include "query_stats.h"
+#include "log_duration.h"
+#include "paginator.h"
+#include "query_plan.h"
+#include "position_index.h"
+#include "trigram_index.h"
+#include "impact_index.h"
+#include "roaring_bitmap.h"
+#include "forward_index.h"
+#include "scratch_arena.h"
+#include "memory_stats.h"
+#include "query_deadline.h"
+#include "search_error.h"
+
+//   ,     SearchServer
+struct IndexOptions {
+    //   :    "curly cat"     "curly tail"~2.
+    //       ,         
+    bool store_positions = false;
+    //  -  ,      "*"   (cat* - cat, catalog, ...).
+    // -  "*"  ,         
+    size_t max_prefix_expansions = 64;
+    //   ,      -,    .
+    // 0 -   ;      
+    int max_typo_distance = 0;
+    //   -   
+    double typo_penalty = 0.5;
+    //  -   ,   
+    size_t max_typo_expansions = 16;
+    //       : 0 -  , 8  16 -  BITMAP
+    //      (. ImpactIndex,    ).
+    //        ,    
+    //   :    (, )  5 (8 )  6 (16 ) 
+    //   .    GetMemoryStats  MemoryStructure::IMPACTS
+    int impact_bits = 0;
+    // -  ,          :
+    //   -     .  ,  
+    //   . 0 -    
+    size_t bitmap_min_document_freq = 256;
+};
+
+//    . SearchServer      
+//    ,     
+struct DocumentStatusPredicate {
+    DocumentStatus status;
+
+    bool operator()(int, DocumentStatus document_status, int) const {
+        return document_status == status;
+    }
+};
+
+// ,  SearchServer::PrepareDocument.    ,  
+//           AddPreparedDocument.
+//     ,     
+struct PreparedDocument {
+    explicit PreparedDocument(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : words(resource), positions(resource)
+    {}
+
+    int id = 0;
+    DocumentStatus status = DocumentStatus::ACTUAL;
+    int rating = 0;
+    std::pmr::vector<std::string_view> words; //   -   
+    std::pmr::vector<uint32_t> positions;     //      -,   store_positions
+};
+
+//    ,     (SearchServer::RegisterStandingQuery)
+using StandingQueryCallback = std::function<void(const Document& document)>;
+
+//  ,  SearchServer,    -     "*" -> .
+//   ,  ShardedSearchServer      
+class StandingQuerySet {
+public:
+    bool IsEmpty() const;
+
+    void Remove(size_t query_id);
+
+private:
+    friend class SearchServer;
+
+    //   :         ,
+    //     
+    struct Query {
+        std::vector<std::string> plus_words;     //  
+        std::vector<std::string> required_words;
+        std::vector<std::string> minus_words;    //  
+        std::vector<std::string> plus_prefixes;  //   "*"  
+        std::vector<std::string> minus_prefixes;
+        StandingQueryCallback callback;
+    };
+    std::map<size_t, Query> queries_;
+    std::map<std::string, std::vector<size_t>, std::less<>> words_;
+    std::map<std::string, std::vector<size_t>, std::less<>> prefixes_;
+    size_t next_query_id_ = 0;
+
+    size_t Add(Query query);
+};
+
+// -        . ,  
+//    SearchServer: IDF      IDF   
+class CollectionStatistics {
+public:
+    virtual ~CollectionStatistics() = default;
+
+    virtual size_t GetDocumentCount() const = 0;
+    virtual size_t GetDocumentFreq(std::string_view word) const = 0;
+};
+
+//  SearchServer::MatchDocuments.       ,
+//           .
+class MatchedDocuments {
+public:
+    using WordsRange = IteratorRange<std::vector<std::string_view>::const_iterator>;
+
+    // - ,    ,      id
+    size_t size() const {
+        return statuses_.size();
+    }
+
+    //      ; ,    -
+    WordsRange GetWords(size_t index) const {
+        return WordsRange(words_.begin() + offsets_[index], words_.begin() + offsets_[index + 1]);
+    }
+
+    DocumentStatus GetStatus(size_t index) const {
+        return statuses_[index];
+    }
+
+private:
+    friend class SearchServer;
+    friend class ShardedSearchServer;
+
+    std::vector<std::string_view> words_;
+    std::vector<size_t> offsets_ = { 0 }; //   i   words_[offsets_[i], offsets_[i + 1])
+    std::vector<DocumentStatus> statuses_;
+};
 
 class SearchServer {   
 public:
@@ -20,12 +162,34 @@ public:
     SearchServer() = default;
 
     template <typename StringContainer>
-    explicit SearchServer(const StringContainer& stop_words);
-    explicit SearchServer(const std::string_view& stop_words_text);
-    explicit SearchServer(const std::string& stop_words_text);
+    explicit SearchServer(const StringContainer& stop_words, const IndexOptions& options = {});
+    explicit SearchServer(const std::string_view& stop_words_text, const IndexOptions& options = {});
+    explicit SearchServer(const std::string& stop_words_text, const IndexOptions& options = {});
+
+    //          ,    .
+    //      ,      
+    SearchServer(const SearchServer& other);
+    SearchServer(SearchServer&& other) = default;
 
     void AddDocument(int document_id, const std::string_view& document, DocumentStatus status, const std::vector<int>& ratings);
 
+    // AddDocument  :     .
+    // AddDocument -   ,  std::invalid_argument
+    Expected<void> TryAddDocument(int document_id, const std::string_view& document, DocumentStatus status, const std::vector<int>& ratings);
+
+    //  -    ,   .    
+    //    ,         .
+    //        :      
+    template <typename RatingIterator>
+    void AddDocument(int document_id, const std::string_view& document, DocumentStatus status, RatingIterator ratings_begin, RatingIterator ratings_end);
+
+    //       ;      ,
+    //      
+    PreparedDocument PrepareDocument(int document_id, const std::string_view& document, DocumentStatus status, const std::vector<int>& ratings) const;
+
+    //     ,     
+    void AddPreparedDocument(const PreparedDocument& document);
+
     //FindTopDocuments  3    
     template <typename ExecutionPolicy, typename DocumentPredicate>
     std::vector<Document> FindTopDocuments(const ExecutionPolicy& policy, const std::string_view& raw_query, DocumentPredicate document_predicate) const;
@@ -43,19 +207,98 @@ public:
     std::vector<Document> FindTopDocuments(const ExecutionPolicy& policy, const std::string_view& raw_query) const;
     std::vector<Document> FindTopDocuments(const std::string_view& raw_query) const;
 
+    //     .         ,
+    //            is_complete == false:
+    //       ,      .
+    // -  ,       
+    template <typename ExecutionPolicy, typename DocumentPredicate>
+    TopDocumentsResult FindTopDocuments(const ExecutionPolicy& policy, const std::string_view& raw_query, DocumentPredicate document_predicate, const QueryDeadline& deadline) const;
+    template <typename ExecutionPolicy>
+    TopDocumentsResult FindTopDocuments(const ExecutionPolicy& policy, const std::string_view& raw_query, DocumentStatus status, const QueryDeadline& deadline) const;
+    TopDocumentsResult FindTopDocuments(const std::string_view& raw_query, const QueryDeadline& deadline) const;
+
+    // FindTopDocuments  :     ,   std::invalid_argument.
+    //      ,      . FindTopDocuments -   
+    template <typename ExecutionPolicy, typename DocumentPredicate>
+    Expected<std::vector<Document>> TryFindTopDocuments(const ExecutionPolicy& policy, const std::string_view& raw_query, DocumentPredicate document_predicate) const;
+    template <typename DocumentPredicate>
+    Expected<std::vector<Document>> TryFindTopDocuments(const std::string_view& raw_query, DocumentPredicate document_predicate) const;
+    template <typename ExecutionPolicy>
+    Expected<std::vector<Document>> TryFindTopDocuments(const ExecutionPolicy& policy, const std::string_view& raw_query, DocumentStatus status) const;
+    Expected<std::vector<Document>> TryFindTopDocuments(const std::string_view& raw_query, DocumentStatus status) const;
+    template <typename ExecutionPolicy>
+    Expected<std::vector<Document>> TryFindTopDocuments(const ExecutionPolicy& policy, const std::string_view& raw_query) const;
+    Expected<std::vector<Document>> TryFindTopDocuments(const std::string_view& raw_query) const;
+    template <typename ExecutionPolicy, typename DocumentPredicate>
+    Expected<TopDocumentsResult> TryFindTopDocuments(const ExecutionPolicy& policy, const std::string_view& raw_query, DocumentPredicate document_predicate, const QueryDeadline& deadline) const;
+
+    //  : ,   cursor (   - ).
+    //   ,   ,    .
+    template <typename ExecutionPolicy, typename DocumentPredicate>
+    SearchPage FindPage(const ExecutionPolicy& policy, const std::string_view& raw_query, size_t page_size, const PageCursor& cursor, DocumentPredicate document_predicate) const;
+    SearchPage FindPage(const std::string_view& raw_query, size_t page_size, const PageCursor& cursor = {}) const;
+
+    //    page_index ( );    (page_index + 1) * page_size 
+    template <typename ExecutionPolicy, typename DocumentPredicate>
+    SearchPage FindPageAt(const ExecutionPolicy& policy, const std::string_view& raw_query, size_t page_size, size_t page_index, DocumentPredicate document_predicate) const;
+    SearchPage FindPageAt(const std::string_view& raw_query, size_t page_size, size_t page_index) const;
+
+    //  max_count  ,   prefix,   -   .
+    // string_view ,        
+    std::vector<std::string_view> GetCompletions(std::string_view prefix, size_t max_count) const;
+
+    // ,     :  ,     .
+    //      ,  (,  ) -  raw_query
+    QueryPlan ExplainQuery(const std::string_view& raw_query) const;
+
+    //  :      ACTUAL,     ,
+    //  callback     IDF    .   
+    //  ,       -, -     -> .
+    //  -, -       "*";   ,
+    //   . callback         .
+    //     UnregisterStandingQuery
+    size_t RegisterStandingQuery(const std::string_view& raw_query, StandingQueryCallback callback);
+    void UnregisterStandingQuery(size_t query_id);
+
+    //       :         queries
+    size_t RegisterStandingQuery(StandingQuerySet& queries, const std::string_view& raw_query, StandingQueryCallback callback) const;
+    //      . ,    , 
+    //     ShardedSearchServer;     ACTUAL 
+    void MatchStandingQueries(const StandingQuerySet& queries, int document_id) const;
+
     int GetDocumentCount() const;
 
+    // -  ,  
+    size_t GetDocumentFreq(std::string_view word) const;
+
+    //  ,    IDF; nullptr -   .
+    //   ,    
+    void SetCollectionStatistics(const CollectionStatistics* statistics);
+
+    //  :   ,  ,    id
+    static bool IsBetterDocument(const Document& lhs, const Document& rhs);
+
     std::tuple<std::vector<std::string_view>, DocumentStatus> MatchDocument(const std::string_view& raw_query, int document_id) const;
 
     std::tuple<std::vector<std::string_view>, DocumentStatus> MatchDocument(std::execution::sequenced_policy policy, const std::string_view& raw_query, int document_id) const;
 
     std::tuple<std::vector<std::string_view>, DocumentStatus> MatchDocument(std::execution::parallel_policy policy, const std::string_view& raw_query, int document_id) const;
 
-    std::set<int>::const_iterator begin() const;
+    //      :    ,
+    //           .
+    //  - id   ,    std::out_of_range
+    void MatchDocuments(std::execution::sequenced_policy policy, const std::string_view& raw_query, const std::vector<int>& document_ids, MatchedDocuments& result) const;
+
+    void MatchDocuments(std::execution::parallel_policy policy, const std::string_view& raw_query, const std::vector<int>& document_ids, MatchedDocuments& result) const;
 
-    std::set<int>::const_iterator end() const;
+    MatchedDocuments MatchDocuments(const std::string_view& raw_query, const std::vector<int>& document_ids) const;
 
-    const std::map<std::string_view, double>& GetWordFrequencies(int document_id) const;
+    std::pmr::set<int>::const_iterator begin() const;
+
+    std::pmr::set<int>::const_iterator end() const;
+
+    //    ; ,    
+    WordFrequencies GetWordFrequencies(int document_id) const;
 
     void RemoveDocument(int document_id);
 
@@ -63,95 +306,348 @@ public:
 
     void RemoveDocument(std::execution::parallel_policy policy, int document_id);
 
+    //     ,    SEARCH_SERVER_ENABLE_STATS
+    QueryStatsSnapshot GetQueryStats() const;
+
+    void ResetQueryStats();
+
+    //   .       ,
+    //          
+    MemoryStats GetMemoryStats() const;
+
 private:
     struct DocumentData {
         int rating;
         DocumentStatus status;        
     };
+    //    :      ,       .
+    //  ,   RemoveDocument(par)     .
+    //         ;  
+    //   ,     
+    struct IndexResources {
+        CountingResource heap{ std::pmr::new_delete_resource() }; // ,    
+        std::pmr::synchronized_pool_resource pool{ &heap };
+        CountingResource dictionary{ &pool };
+        CountingResource postings{ &pool };
+        CountingResource forward_index{ &pool };
+        CountingResource documents{ &pool };
+        CountingResource positions{ &pool };
+        CountingResource trigrams{ &pool };
+        CountingResource impacts{ &pool };
+        CountingResource bitmaps{ &pool };
+    };
+
     const std::set<std::string, std::less<>> stop_words_ = {}; // -
-    std::map<std::string_view, std::map<int, double>> word_to_document_freqs_; //           {<> {{<_>, <>},...}} 
-    std::map<int, DocumentData> documents_; // {<_>, {<>, <>}}
-    std::set<int> ids_of_documents_; //    
-    std::map<int, std::map<std::string_view, double>> words_with_frequency_by_doc_id_; // {doc_id {word, freq}}
-    const std::map<std::string_view, double> EMPTY_MAP_WORDS_FREQS_;
-    std::set<std::string, std::less<>> buffer_ = {}; //  , string_view     
+    const size_t stop_words_bytes_ = 0; //   stop_words_
+    const IndexOptions options_ = {};
+    //   ,    
+    std::unique_ptr<IndexResources> index_resources_ = std::make_unique<IndexResources>();
+    std::pmr::map<std::string_view, std::pmr::map<int, double>> word_to_document_freqs_{ &index_resources_->postings }; //           {<> {{<_>, <>},...}} 
+    std::pmr::map<int, DocumentData> documents_{ &index_resources_->documents }; // {<_>, {<>, <>}}
+    std::pmr::set<int> ids_of_documents_{ &index_resources_->documents }; //    
+    ForwardIndex forward_index_{ &index_resources_->forward_index }; //     
+    std::pmr::map<std::pmr::string, uint32_t, std::less<>> buffer_{ &index_resources_->dictionary }; //      forward_index_, string_view     
+    size_t posting_count_ = 0; // -  (, )
 
-    bool IsStopWord(const std::string_view& word) const;
+    StandingQuerySet standing_queries_;
+    const CollectionStatistics* collection_statistics_ = nullptr;
+    QueryStats query_stats_;
+    PositionIndex positions_{ &index_resources_->positions }; //    options_.store_positions
+    TrigramIndex trigrams_{ &index_resources_->trigrams };    //    options_.max_typo_distance > 0
+    ImpactIndex impacts_{ options_.impact_bits, &index_resources_->impacts }; //    options_.impact_bits > 0
+    //   , . IndexOptions::bitmap_min_document_freq;    word_to_document_freqs_
+    std::pmr::map<std::string_view, RoaringBitmap> term_bitmaps_{ &index_resources_->bitmaps };
+    //   ,  - static_cast<size_t>(DocumentStatus)
+    std::array<RoaringBitmap, 4> status_bitmaps_{
+        RoaringBitmap(&index_resources_->documents), RoaringBitmap(&index_resources_->documents),
+        RoaringBitmap(&index_resources_->documents), RoaringBitmap(&index_resources_->documents) };
 
-    std::vector<std::string_view> SplitIntoWordsNoStop(const std::string_view& text) const;
+    //    ,     
+    static size_t EstimateStopWordsBytes(const std::set<std::string, std::less<>>& stop_words);
+
+    bool IsStopWord(const std::string_view& word) const;
 
     static bool IsValidWord(const std::string_view& word);
 
-    static int ComputeAverageRating(const std::vector<int>& ratings);
+    template <typename RatingIterator>
+    static int ComputeAverageRating(RatingIterator ratings_begin, RatingIterator ratings_end);
+
+    SearchError TryAddDocumentWithRating(int document_id, const std::string_view& document, DocumentStatus status, int rating);
+    //  prepared,    
+    SearchError PrepareDocumentWords(const std::string_view& document, PreparedDocument& prepared) const;
+    SearchError TryAddPreparedDocument(const PreparedDocument& document);
+    //        ;  ,       
+    std::pair<std::string_view, uint32_t> AddDictionaryWord(std::string_view word);
+    //     ,  . terms -  ( , ),   
+    void IndexDocument(int document_id, const DocumentData& document_data, const std::pmr::vector<std::pair<uint32_t, double>>& terms);
+
+    //      nullptr,   
+    const RoaringBitmap* FindTermBitmap(std::string_view word) const;
+
+    //  std::out_of_range,  -    
+    void CheckDocumentIds(const std::vector<int>& document_ids) const;
+
+    StandingQuerySet::Query ParseStandingQuery(const std::string_view& raw_query) const;
 
     struct QueryWord {
         std::string_view data;
         bool is_minus;
+        bool is_required; //   "+":    
         bool is_stop;
     };
 
     QueryWord ParseQueryWord(std::string_view text) const;
 
+    //   . Ÿ    plus_words  required_words,
+    //      ,   
+    struct Phrase {
+        std::vector<std::string_view> words;
+        std::vector<uint32_t> offsets; //      , -  
+        uint32_t max_gap = 0;          // 0 -  ,       max_gap - 1  
+    };
+
+    //        ,     QueryScratch
     struct Query {
-        std::vector<std::string_view> plus_words;
-        std::vector<std::string_view> minus_words;
+        std::pmr::vector<std::string_view> plus_words{ QueryScratch::GetResource() };
+        std::pmr::vector<std::string_view> minus_words{ QueryScratch::GetResource() };
+        std::pmr::vector<std::string_view> required_words{ QueryScratch::GetResource() }; //    plus_words
+        std::vector<Phrase> phrases;
+        std::pmr::map<std::string_view, double> word_weights{ QueryScratch::GetResource() }; //   ,     
     };
         
+    //  text  query;        
+    SearchError TryParseQuery(const std::string_view& text, Query& query, const bool is_remove_duplicates = true) const;
     Query ParseQuery(const std::string_view& text, const bool is_remove_duplicates = true) const;
 
+    SearchError TryParseQueryTimed(const std::string_view& text, Query& query) const;
+    Query ParseQueryTimed(const std::string_view& text) const;
+
+    //   -,    ,     
+    void CorrectTypos(Query& query) const;
+
+    //    : 1  ,   
+    static double GetWordWeight(const Query& query, std::string_view word);
+
+    //   words  ,   prefix,   max_count
+    void ExpandPrefix(std::string_view prefix, size_t max_count, std::pmr::vector<std::string_view>& words) const;
+
+    //   ; is_closed -   
+    SearchError ParsePhraseWord(std::string_view text, Phrase& phrase, uint32_t& offset, Query& query, bool& is_closed) const;
+
+    //     
+    bool MatchesPhrases(const Query& query, int document_id) const;
+
+    //   count ,  
+    template <typename ExecutionPolicy>
+    static void SelectTopDocuments(const ExecutionPolicy& policy, std::pmr::vector<Document>& documents, size_t count);
+
+    template <typename ExecutionPolicy>
+    SearchPage MakePage(const ExecutionPolicy& policy, std::pmr::vector<Document> documents, size_t offset, size_t page_size) const;
+
     // Existence required
     double ComputeWordInverseDocumentFreq(const std::string_view& word) const;
 
+    // -       ,   ;
+    // local_freq -     
+    size_t GetCollectionDocumentCount() const;
+    size_t GetCollectionDocumentFreq(std::string_view word, size_t local_freq) const;
+
+    // deadline_check -  ; nullptr -  
+    template <typename DocumentPredicate>
+    std::pmr::vector<Document> FindAllDocuments(const std::execution::parallel_policy& policy, const Query& query,
+        DocumentPredicate document_predicate, DeadlineCheck* deadline_check = nullptr) const;
+
+    template <typename DocumentPredicate>
+    std::pmr::vector<Document> FindAllDocuments(const std::execution::sequenced_policy& policy, const Query& query,
+        DocumentPredicate document_predicate, DeadlineCheck* deadline_check = nullptr) const;
+
+    template <typename DocumentPredicate>
+    std::pmr::vector<Document> FindAllDocuments(const Query& query,
+        DocumentPredicate document_predicate, DeadlineCheck* deadline_check = nullptr) const;
+
+    //         ,    
+    //    
+    QueryPlan PlanQuery(const Query& query, std::pmr::memory_resource* resource) const;
+
     template <typename DocumentPredicate>
-    std::vector<Document> FindAllDocuments(const std::execution::parallel_policy& policy, const Query& query,
-        DocumentPredicate document_predicate) const;
+    std::pmr::vector<Document> FindDocumentsTermAtATime(const QueryPlan& plan, DocumentPredicate document_predicate, DeadlineCheck* deadline_check) const;
 
     template <typename DocumentPredicate>
-    std::vector<Document> FindAllDocuments(const std::execution::sequenced_policy& policy, const Query& query,
-        DocumentPredicate document_predicate) const;
+    std::pmr::vector<Document> FindDocumentsDocumentAtATime(const QueryPlan& plan, DocumentPredicate document_predicate, DeadlineCheck* deadline_check) const;
 
     template <typename DocumentPredicate>
-    std::vector<Document> FindAllDocuments(const Query& query,
-        DocumentPredicate document_predicate) const;
+    std::pmr::vector<Document> FindDocumentsBitmap(const QueryPlan& plan, DocumentPredicate document_predicate, DeadlineCheck* deadline_check) const;
+
+    template <typename Words>
+    void RemoveDublicatesFromVector(Words& v_words) const;
+
+    //  id ,    
+    std::pmr::vector<int> IntersectRequiredWords(const std::pmr::vector<std::string_view>& required_words) const;
+
+    //      :       
+    template <typename ExecutionPolicy, typename DocumentPredicate>
+    std::pmr::vector<Document> FindRequiredDocuments(const ExecutionPolicy& policy, const Query& query, DocumentPredicate document_predicate, DeadlineCheck* deadline_check) const;
 
-    void RemoveDublicatesFromVector(std::vector<std::string_view>& v_words) const;
+    //    ,    ;   .
+    //  false,    -
+    template <typename Action>
+    static bool ForEachMatchedWord(const Query& query, const WordFrequencies& word_freqs, Action action);
+
+    // -   , 0 -    -
+    static size_t CountMatchedWords(const Query& query, const WordFrequencies& word_freqs);
 
     void EraseWordFromBuffer(std::string_view sv_word);
    
 };
 
+template <typename Action>
+bool SearchServer::ForEachMatchedWord(const Query& query, const WordFrequencies& word_freqs, Action action) {
+    //   ,       ,
+    //        
+    const auto intersect = [&word_freqs](const std::pmr::vector<std::string_view>& words, auto on_match) {
+        if (words.size() * 8 < word_freqs.size()) {
+            for (const std::string_view& word : words) {
+                const auto it = word_freqs.find(word);
+                if (it != word_freqs.end() && !on_match(it->first)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        auto doc_it = word_freqs.begin();
+        auto query_it = words.begin();
+        while (doc_it != word_freqs.end() && query_it != words.end()) {
+            if (doc_it->first < *query_it) {
+                ++doc_it;
+            }
+            else if (*query_it < doc_it->first) {
+                ++query_it;
+            }
+            else {
+                if (!on_match(doc_it->first)) {
+                    return false;
+                }
+                ++doc_it;
+                ++query_it;
+            }
+        }
+        return true;
+    };
+
+    if (!intersect(query.minus_words, [](std::string_view) { return false; })) {
+        return false;
+    }
+    size_t required_found = 0;
+    intersect(query.required_words, [&required_found](std::string_view) {
+        ++required_found;
+        return true;
+        });
+    if (required_found != query.required_words.size()) {
+        return false;
+    }
+    intersect(query.plus_words, [&action](std::string_view word) {
+        action(word);
+        return true;
+        });
+    return true;
+}
+
+template <typename Words>
+void SearchServer::RemoveDublicatesFromVector(Words& v_words) const {
+    std::sort(v_words.begin(), v_words.end());
+    v_words.erase(std::unique(v_words.begin(), v_words.end()), v_words.end());
+}
+
 template <typename StringContainer>
-SearchServer::SearchServer(const StringContainer& stop_words)
+SearchServer::SearchServer(const StringContainer& stop_words, const IndexOptions& options)
     : stop_words_(MakeUniqueNonEmptyStrings(stop_words))
+    , stop_words_bytes_(EstimateStopWordsBytes(stop_words_))
+    , options_(options)
 {
     for (const std::string_view& word : stop_words) {
         if (!IsValidWord(word)) { throw std::invalid_argument("The stop-words contain invalid characters"); }
     }
 }
 
+template <typename RatingIterator>
+void SearchServer::AddDocument(int document_id, const std::string_view& document, DocumentStatus status, RatingIterator ratings_begin, RatingIterator ratings_end) {
+    ThrowIfSearchError(TryAddDocumentWithRating(document_id, document, status, ComputeAverageRating(ratings_begin, ratings_end)));
+}
+
+template <typename RatingIterator>
+int SearchServer::ComputeAverageRating(RatingIterator ratings_begin, RatingIterator ratings_end) {
+    //  ,     
+    int rating_sum = 0;
+    int rating_count = 0;
+    for (; ratings_begin != ratings_end; ++ratings_begin) {
+        rating_sum += *ratings_begin;
+        ++rating_count;
+    }
+    return rating_count == 0 ? 0 : rating_sum / rating_count;
+}
+
 template <typename ExecutionPolicy, typename DocumentPredicate>
 std::vector<Document> SearchServer::FindTopDocuments(const ExecutionPolicy& policy, const std::string_view& raw_query, DocumentPredicate document_predicate) const {
-    const int MAX_RESULT_DOCUMENT_COUNT = 5;
-    const double EPSILON = 1e-6; // 
+    return SearchServer::TryFindTopDocuments(policy, raw_query, document_predicate).Value();
+}
 
-    const Query query = ParseQuery(raw_query);
+template <typename ExecutionPolicy, typename DocumentPredicate>
+TopDocumentsResult SearchServer::FindTopDocuments(const ExecutionPolicy& policy, const std::string_view& raw_query, DocumentPredicate document_predicate, const QueryDeadline& deadline) const {
+    return SearchServer::TryFindTopDocuments(policy, raw_query, document_predicate, deadline).Value();
+}
 
-    std::vector<Document> result = FindAllDocuments(policy, query, document_predicate);
+template <typename ExecutionPolicy, typename DocumentPredicate>
+Expected<std::vector<Document>> SearchServer::TryFindTopDocuments(const ExecutionPolicy& policy, const std::string_view& raw_query, DocumentPredicate document_predicate) const {
+    Expected<TopDocumentsResult> result = SearchServer::TryFindTopDocuments(policy, raw_query, document_predicate, QueryDeadline{});
+    if (!result) {
+        return result.GetError();
+    }
+    return std::move(result).Value().documents;
+}
 
-    std::sort(policy,
-        result.begin(), result.end(),
-        [&EPSILON](const Document& lhs, const Document& rhs) {
-            if (std::abs(lhs.relevance - rhs.relevance) < EPSILON) {
-                return lhs.rating > rhs.rating;
-            }
-            else {
-                return lhs.relevance > rhs.relevance;
-            }
-        });
-    if (result.size() > MAX_RESULT_DOCUMENT_COUNT) {
-        result.resize(MAX_RESULT_DOCUMENT_COUNT);
+template <typename DocumentPredicate>
+Expected<std::vector<Document>> SearchServer::TryFindTopDocuments(const std::string_view& raw_query, DocumentPredicate document_predicate) const {
+    return SearchServer::TryFindTopDocuments(std::execution::seq, raw_query, document_predicate);
+}
+
+template <typename ExecutionPolicy>
+Expected<std::vector<Document>> SearchServer::TryFindTopDocuments(const ExecutionPolicy& policy, const std::string_view& raw_query, DocumentStatus status) const {
+    return SearchServer::TryFindTopDocuments(policy, raw_query, DocumentStatusPredicate{ status });
+}
+
+template <typename ExecutionPolicy>
+Expected<std::vector<Document>> SearchServer::TryFindTopDocuments(const ExecutionPolicy& policy, const std::string_view& raw_query) const {
+    return SearchServer::TryFindTopDocuments(policy, raw_query, DocumentStatus::ACTUAL);
+}
+
+template <typename ExecutionPolicy, typename DocumentPredicate>
+Expected<TopDocumentsResult> SearchServer::TryFindTopDocuments(const ExecutionPolicy& policy, const std::string_view& raw_query, DocumentPredicate document_predicate, const QueryDeadline& deadline) const {
+    const int MAX_RESULT_DOCUMENT_COUNT = 5;
+    TRACE_DURATION("FindTopDocuments");
+
+    const QueryScratch scratch;
+    Query query;
+    if (const SearchError error = TryParseQueryTimed(raw_query, query); error != SearchError::NONE) {
+        return error;
     }
-    return result;   
+
+    TopDocumentsResult result;
+    DeadlineCheck deadline_check(deadline);
+    //   ,     
+    if (deadline_check.CheckNow()) {
+        result.is_complete = false;
+        return result;
+    }
+
+    //      
+    std::pmr::vector<Document> matched_documents = FindAllDocuments(policy, query, document_predicate,
+        deadline.IsUnlimited() ? nullptr : &deadline_check);
+
+    const QueryStageTimer top_k_timer(query_stats_, QueryStage::TOP_K);
+    SelectTopDocuments(policy, matched_documents, MAX_RESULT_DOCUMENT_COUNT);
+    result.documents.assign(matched_documents.begin(), matched_documents.end());
+    result.is_complete = !deadline_check.IsStopped();
+    return result;
 }
 
 template <typename DocumentPredicate>
@@ -161,7 +657,7 @@ std::vector<Document> SearchServer::FindTopDocuments(const std::string_view& raw
 
 template <typename ExecutionPolicy>
 std::vector<Document> SearchServer::FindTopDocuments(const ExecutionPolicy& policy, const std::string_view& raw_query, DocumentStatus status) const {
-    return SearchServer::FindTopDocuments(policy, raw_query, [status](int document_id, DocumentStatus document_status, int rating) { return document_status == status; });
+    return SearchServer::FindTopDocuments(policy, raw_query, DocumentStatusPredicate{ status });
 }
 
 template <typename ExecutionPolicy>
@@ -169,71 +665,338 @@ std::vector<Document> SearchServer::FindTopDocuments(const ExecutionPolicy& poli
     return SearchServer::FindTopDocuments(policy, raw_query, DocumentStatus::ACTUAL);
 }
 
+template <typename ExecutionPolicy>
+TopDocumentsResult SearchServer::FindTopDocuments(const ExecutionPolicy& policy, const std::string_view& raw_query, DocumentStatus status, const QueryDeadline& deadline) const {
+    return SearchServer::FindTopDocuments(policy, raw_query, DocumentStatusPredicate{ status }, deadline);
+}
+
+template <typename ExecutionPolicy, typename DocumentPredicate>
+SearchPage SearchServer::FindPage(const ExecutionPolicy& policy, const std::string_view& raw_query, size_t page_size, const PageCursor& cursor, DocumentPredicate document_predicate) const {
+    TRACE_DURATION("FindPage");
+    const QueryScratch scratch;
+    const Query query = ParseQueryTimed(raw_query);
+
+    std::pmr::vector<Document> matched_documents = FindAllDocuments(policy, query, document_predicate);
+
+    if (cursor.IsSet()) {
+        //   ,     
+        const Document& last_document = cursor.GetLastDocument();
+        matched_documents.erase(
+            std::remove_if(policy,
+                matched_documents.begin(), matched_documents.end(),
+                [&last_document](const Document& document) { return !IsBetterDocument(last_document, document); }),
+            matched_documents.end());
+    }
+
+    return MakePage(policy, std::move(matched_documents), 0, page_size);
+}
+
+template <typename ExecutionPolicy, typename DocumentPredicate>
+SearchPage SearchServer::FindPageAt(const ExecutionPolicy& policy, const std::string_view& raw_query, size_t page_size, size_t page_index, DocumentPredicate document_predicate) const {
+    TRACE_DURATION("FindPageAt");
+    const QueryScratch scratch;
+    const Query query = ParseQueryTimed(raw_query);
+
+    return MakePage(policy, FindAllDocuments(policy, query, document_predicate), page_index * page_size, page_size);
+}
+
+template <typename ExecutionPolicy>
+void SearchServer::SelectTopDocuments(const ExecutionPolicy& policy, std::pmr::vector<Document>& documents, size_t count) {
+    if (documents.size() > count) {
+        std::partial_sort(policy, documents.begin(), documents.begin() + count, documents.end(), IsBetterDocument);
+        documents.resize(count);
+    }
+    else {
+        std::sort(policy, documents.begin(), documents.end(), IsBetterDocument);
+    }
+}
+
+template <typename ExecutionPolicy>
+SearchPage SearchServer::MakePage(const ExecutionPolicy& policy, std::pmr::vector<Document> documents, size_t offset, size_t page_size) const {
+    if (page_size == 0) {
+        throw std::invalid_argument("Page size must be positive");
+    }
+
+    const QueryStageTimer top_k_timer(query_stats_, QueryStage::TOP_K);
+    SearchPage page;
+    if (offset >= documents.size()) {
+        return page;
+    }
+
+    const size_t total_count = documents.size();
+    const size_t page_end = std::min(total_count, offset + page_size);
+    SelectTopDocuments(policy, documents, page_end);
+
+    page.documents.assign(documents.begin() + offset, documents.end());
+    page.has_more = total_count > page_end;
+
+    page.next = PageCursor(page.documents.back());
+    return page;
+}
+
+template <typename ExecutionPolicy, typename DocumentPredicate>
+std::pmr::vector<Document> SearchServer::FindRequiredDocuments(const ExecutionPolicy& policy, const Query& query, DocumentPredicate document_predicate, DeadlineCheck* deadline_check) const {
+    std::pmr::memory_resource* scratch = QueryScratch::GetResource();
+    std::pmr::vector<int> candidates(scratch);
+    {
+        const QueryStageTimer traversal_timer(query_stats_, QueryStage::TRAVERSAL);
+        candidates = IntersectRequiredWords(query.required_words);
+    }
+
+    QueryCount minus_exclusions;
+    {
+        const QueryStageTimer filtering_timer(query_stats_, QueryStage::FILTERING);
+        std::pmr::vector<const std::pmr::map<int, double>*> minus_lists(scratch);
+        std::pmr::vector<const RoaringBitmap*> minus_bitmaps(scratch);
+        for (const std::string_view& word : query.minus_words) {
+            const auto it = word_to_document_freqs_.find(word);
+            if (it == word_to_document_freqs_.end()) {
+                continue;
+            }
+            if (const RoaringBitmap* bitmap = FindTermBitmap(word)) {
+                minus_bitmaps.push_back(bitmap);
+            }
+            else {
+                minus_lists.push_back(&it->second);
+            }
+        }
+        const size_t candidate_count = candidates.size();
+        candidates.erase(
+            std::remove_if(candidates.begin(), candidates.end(),
+                [&minus_lists, &minus_bitmaps](int document_id) {
+                    return std::any_of(minus_bitmaps.begin(), minus_bitmaps.end(),
+                            [document_id](const RoaringBitmap* bitmap) { return bitmap->Contains(document_id); })
+                        || std::any_of(minus_lists.begin(), minus_lists.end(),
+                            [document_id](const auto* documents) { return documents->count(document_id) != 0; });
+                }),
+            candidates.end());
+        minus_exclusions.Add(candidate_count - candidates.size());
+
+        candidates.erase(
+            std::remove_if(candidates.begin(), candidates.end(),
+                [&](int document_id) {
+                    const auto& document_data = documents_.at(document_id);
+                    return !document_predicate(document_id, document_data.status, document_data.rating);
+                }),
+            candidates.end());
+
+        if (!query.phrases.empty()) {
+            candidates.erase(
+                std::remove_if(candidates.begin(), candidates.end(),
+                    //      
+                    [&](int document_id) {
+                        return (deadline_check != nullptr && deadline_check->ShouldStop()) || !MatchesPhrases(query, document_id);
+                    }),
+                candidates.end());
+        }
+    }
+
+    //       -,      
+    std::pmr::vector<std::pair<const std::pmr::map<int, double>*, double>> plus_lists(scratch);
+    for (const std::string_view& word : query.plus_words) {
+        const auto it = word_to_document_freqs_.find(word);
+        if (it != word_to_document_freqs_.end()) {
+            plus_lists.emplace_back(&it->second, ComputeWordInverseDocumentFreq(word) * GetWordWeight(query, word));
+        }
+    }
+
+    std::pmr::vector<Document> matched_documents(candidates.size(), scratch);
+    size_t scored_count = 0;
+    {
+        const QueryStageTimer traversal_timer(query_stats_, QueryStage::TRAVERSAL);
+        const auto score = [&](int document_id) {
+            double relevance = 0.0;
+            for (const auto& [documents, inverse_document_freq] : plus_lists) {
+                const auto it = documents->find(document_id);
+                if (it != documents->end()) {
+                    relevance += it->second * inverse_document_freq;
+                }
+            }
+            return Document{ document_id, relevance, documents_.at(document_id).rating };
+        };
+        if (deadline_check == nullptr) {
+            std::transform(policy, candidates.begin(), candidates.end(), matched_documents.begin(), score);
+            scored_count = candidates.size();
+        }
+        else {
+            //     ,     
+            const size_t block_size = DeadlineCheck::CHECK_INTERVAL;
+            while (scored_count < candidates.size() && !deadline_check->CheckNow()) {
+                const size_t block_end = std::min(candidates.size(), scored_count + block_size);
+                std::transform(policy, candidates.begin() + scored_count, candidates.begin() + block_end,
+                    matched_documents.begin() + scored_count, score);
+                scored_count = block_end;
+            }
+            matched_documents.resize(scored_count);
+        }
+    }
+
+    query_stats_.RecordCounter(QueryCounter::POSTINGS_VISITED, scored_count * plus_lists.size());
+    query_stats_.RecordCounter(QueryCounter::DOCUMENTS_SCORED, matched_documents.size());
+    query_stats_.RecordCounter(QueryCounter::MINUS_EXCLUSIONS, minus_exclusions.Get());
+    return matched_documents;
+}
+
 template <typename DocumentPredicate>
-std::vector<Document> SearchServer::FindAllDocuments(const std::execution::parallel_policy& policy, const Query& query, DocumentPredicate document_predicate) const {
+std::pmr::vector<Document> SearchServer::FindAllDocuments(const std::execution::parallel_policy& policy, const Query& query, DocumentPredicate document_predicate, DeadlineCheck* deadline_check) const {
+    if (!query.required_words.empty()) {
+        return FindRequiredDocuments(policy, query, document_predicate, deadline_check);
+    }
+
     ConcurrentMap<int, double> document_to_relevance(100);  //100 -   - ""   
-    
-    std::for_each(policy,
-        query.plus_words.begin(), query.plus_words.end(),
-        [&](const std::string_view& word) {
-            if (word_to_document_freqs_.count(word) != 0) {
-
-                const double inverse_document_freq = ComputeWordInverseDocumentFreq(word);
-                for (const auto [document_id, term_freq] : word_to_document_freqs_.at(word)) {
+    AtomicQueryCount postings_visited;
+    AtomicQueryCount minus_exclusions;
+
+    const QueryPlan plan = PlanQuery(query, QueryScratch::GetResource());
+    //    TBB,      
+    const TraceContext trace_context = TraceSpan::GetCurrentContext();
+
+    {
+        const QueryStageTimer traversal_timer(query_stats_, QueryStage::TRAVERSAL);
+        std::for_each(policy,
+            plan.plus_terms.begin(), plan.plus_terms.end(),
+            [&](const QueryPlan::Term& term) {
+                const TraceContextScope trace_scope(trace_context);
+                TRACE_DURATION("FindAllDocuments(par) plus word");
+                QueryCount visited;
+                for (const auto [document_id, term_freq] : word_to_document_freqs_.at(term.word)) {
+                    if (deadline_check != nullptr && deadline_check->ShouldStop()) {
+                        break;
+                    }
+                    visited.Add(1);
                     const auto& document_data = documents_.at(document_id);
                     if (document_predicate(document_id, document_data.status, document_data.rating)) {
-                        document_to_relevance[document_id].ref_to_value += term_freq * inverse_document_freq;
+                        document_to_relevance[document_id].ref_to_value += term_freq * term.inverse_document_freq;
                     }
                 }
+                postings_visited.Add(visited.Get());
             }
-        }
-    );
+        );
 
-    std::for_each(policy,
-        query.minus_words.begin(), query.minus_words.end(),
-        [&](const std::string_view& word) {
-            if (word_to_document_freqs_.count(word) != 0) {
+        //     :    ,      
+        if (plan.matches_all_documents) {
+            std::for_each(policy,
+                documents_.begin(), documents_.end(),
+                [&](const auto& document) {
+                    const auto& [document_id, document_data] = document;
+                    if (deadline_check != nullptr && deadline_check->ShouldStop()) {
+                        return;
+                    }
+                    if (document_predicate(document_id, document_data.status, document_data.rating)) {
+                        document_to_relevance[document_id];
+                    }
+                }
+            );
+        }
+    }
 
-                for (const auto [document_id, _] : word_to_document_freqs_.at(word)) {
-                    document_to_relevance.Erase(document_id);
+    {
+        const QueryStageTimer filtering_timer(query_stats_, QueryStage::FILTERING);
+        std::for_each(policy,
+            plan.minus_terms.begin(), plan.minus_terms.end(),
+            [&](const QueryPlan::Term& term) {
+                const TraceContextScope trace_scope(trace_context);
+                TRACE_DURATION("FindAllDocuments(par) minus word");
+                QueryCount erased;
+                for (const auto [document_id, _] : word_to_document_freqs_.at(term.word)) {
+                    erased.Add(document_to_relevance.Erase(document_id));
                 }
+                minus_exclusions.Add(erased.Get());
             }
-        }
-    );
+        );
+    }
         
-    std::vector<Document> matched_documents;
+    std::pmr::vector<Document> matched_documents(QueryScratch::GetResource());
     for (const auto [document_id, relevance] : document_to_relevance.BuildOrdinaryMap()) {
         matched_documents.push_back({ document_id, relevance, documents_.at(document_id).rating });
     }
+
+    query_stats_.RecordCounter(QueryCounter::POSTINGS_VISITED, postings_visited.Get());
+    query_stats_.RecordCounter(QueryCounter::DOCUMENTS_SCORED, matched_documents.size() + minus_exclusions.Get());
+    query_stats_.RecordCounter(QueryCounter::MINUS_EXCLUSIONS, minus_exclusions.Get());
     return matched_documents;
 }
 
 template <typename DocumentPredicate>
-std::vector<Document> SearchServer::FindAllDocuments(const std::execution::sequenced_policy& policy, const Query& query, DocumentPredicate document_predicate) const {
-    std::map<int, double> document_to_relevance;
-    for (const std::string_view& word : query.plus_words) {
-        if (word_to_document_freqs_.count(word) == 0) {
-            continue;
+std::pmr::vector<Document> SearchServer::FindAllDocuments(const std::execution::sequenced_policy& policy, const Query& query, DocumentPredicate document_predicate, DeadlineCheck* deadline_check) const {
+    const QueryPlan plan = PlanQuery(query, QueryScratch::GetResource());
+
+    switch (plan.strategy) {
+    case QueryStrategy::CONJUNCTIVE:
+        return FindRequiredDocuments(policy, query, document_predicate, deadline_check);
+    case QueryStrategy::DOCUMENT_AT_A_TIME:
+        return FindDocumentsDocumentAtATime(plan, document_predicate, deadline_check);
+    case QueryStrategy::BITMAP:
+        return FindDocumentsBitmap(plan, document_predicate, deadline_check);
+    default:
+        return FindDocumentsTermAtATime(plan, document_predicate, deadline_check);
+    }
+}
+
+template <typename DocumentPredicate>
+std::pmr::vector<Document> SearchServer::FindDocumentsTermAtATime(const QueryPlan& plan, DocumentPredicate document_predicate, DeadlineCheck* deadline_check) const {
+    std::pmr::memory_resource* scratch = QueryScratch::GetResource();
+    std::pmr::map<int, double> document_to_relevance(scratch);
+    QueryCount postings_visited;
+    QueryCount minus_exclusions;
+
+    {
+        const QueryStageTimer traversal_timer(query_stats_, QueryStage::TRAVERSAL);
+        //      ,        
+        for (const QueryPlan::Term& term : plan.plus_terms) {
+            for (const auto [document_id, term_freq] : word_to_document_freqs_.at(term.word)) {
+                if (deadline_check != nullptr && deadline_check->ShouldStop()) {
+                    break;
+                }
+                postings_visited.Add(1);
+                const auto& document_data = documents_.at(document_id);
+                if (document_predicate(document_id, document_data.status, document_data.rating)) {
+                    document_to_relevance[document_id] += term_freq * term.inverse_document_freq;
+                }
+            }
         }
-        const double inverse_document_freq = ComputeWordInverseDocumentFreq(word);
-        for (const auto [document_id, term_freq] : word_to_document_freqs_.at(word)) {
-            const auto& document_data = documents_.at(document_id);
-            if (document_predicate(document_id, document_data.status, document_data.rating)) {
-                document_to_relevance[document_id] += term_freq * inverse_document_freq;
+
+        //     :    ,      
+        if (plan.matches_all_documents) {
+            for (const auto& [document_id, document_data] : documents_) {
+                if (deadline_check != nullptr && deadline_check->ShouldStop()) {
+                    break;
+                }
+                if (document_predicate(document_id, document_data.status, document_data.rating)) {
+                    document_to_relevance.emplace(document_id, 0.0);
+                }
             }
         }
     }
+    query_stats_.RecordCounter(QueryCounter::DOCUMENTS_SCORED, document_to_relevance.size());
 
-    for (const std::string_view& word : query.minus_words) {
-        if (word_to_document_freqs_.count(word) == 0) {
-            continue;
-        }
-        for (const auto [document_id, _] : word_to_document_freqs_.at(word)) {
-            document_to_relevance.erase(document_id);
+    {
+        const QueryStageTimer filtering_timer(query_stats_, QueryStage::FILTERING);
+        for (const QueryPlan::Term& term : plan.minus_terms) {
+            //   ,    -:    
+            const RoaringBitmap* bitmap = FindTermBitmap(term.word);
+            if (bitmap != nullptr && document_to_relevance.size() < term.document_freq) {
+                for (auto it = document_to_relevance.begin(); it != document_to_relevance.end();) {
+                    if (bitmap->Contains(it->first)) {
+                        it = document_to_relevance.erase(it);
+                        minus_exclusions.Add(1);
+                    }
+                    else {
+                        ++it;
+                    }
+                }
+                continue;
+            }
+            for (const auto [document_id, _] : word_to_document_freqs_.at(term.word)) {
+                minus_exclusions.Add(document_to_relevance.erase(document_id));
+            }
         }
     }
+    query_stats_.RecordCounter(QueryCounter::POSTINGS_VISITED, postings_visited.Get());
+    query_stats_.RecordCounter(QueryCounter::MINUS_EXCLUSIONS, minus_exclusions.Get());
 
-    std::vector<Document> matched_documents;
+    std::pmr::vector<Document> matched_documents(scratch);
+    matched_documents.reserve(document_to_relevance.size());
     for (const auto [document_id, relevance] : document_to_relevance) {
         matched_documents.push_back(
             { document_id, relevance, documents_.at(document_id).rating });
@@ -242,6 +1005,186 @@ std::vector<Document> SearchServer::FindAllDocuments(const std::execution::seque
 }
 
 template <typename DocumentPredicate>
-std::vector<Document> SearchServer::FindAllDocuments(const Query& query, DocumentPredicate document_predicate) const {
-    return SearchServer::FindAllDocuments(std::execution::seq, query, document_predicate);
+std::pmr::vector<Document> SearchServer::FindDocumentsDocumentAtATime(const QueryPlan& plan, DocumentPredicate document_predicate, DeadlineCheck* deadline_check) const {
+    using PostingIterator = std::pmr::map<int, double>::const_iterator;
+    struct Cursor {
+        PostingIterator it;
+        PostingIterator end;
+        double inverse_document_freq;
+        const RoaringBitmap* bitmap; //  -    ,    
+    };
+
+    std::pmr::memory_resource* scratch = QueryScratch::GetResource();
+    std::pmr::vector<Cursor> plus_cursors(scratch);
+    for (const QueryPlan::Term& term : plan.plus_terms) {
+        const auto& document_freqs = word_to_document_freqs_.at(term.word);
+        plus_cursors.push_back({ document_freqs.begin(), document_freqs.end(), term.inverse_document_freq, nullptr });
+    }
+    std::pmr::vector<Cursor> minus_cursors(scratch);
+    for (const QueryPlan::Term& term : plan.minus_terms) {
+        const auto& document_freqs = word_to_document_freqs_.at(term.word);
+        minus_cursors.push_back({ document_freqs.begin(), document_freqs.end(), 0.0, FindTermBitmap(term.word) });
+    }
+
+    //  {id ,  }   id  
+    std::pmr::vector<std::pair<int, size_t>> heap(scratch);
+    for (size_t i = 0; i < plus_cursors.size(); ++i) {
+        heap.emplace_back(plus_cursors[i].it->first, i);
+    }
+    const auto heap_compare = std::greater<std::pair<int, size_t>>{};
+    std::make_heap(heap.begin(), heap.end(), heap_compare);
+
+    std::pmr::vector<Document> matched_documents(scratch);
+    QueryCount postings_visited;
+    QueryCount minus_exclusions;
+    {
+        const QueryStageTimer traversal_timer(query_stats_, QueryStage::TRAVERSAL);
+        //     id,       
+        while (!heap.empty()) {
+            if (deadline_check != nullptr && deadline_check->ShouldStop()) {
+                break;
+            }
+            const int document_id = heap.front().first;
+
+            double relevance = 0.0;
+            while (!heap.empty() && heap.front().first == document_id) {
+                std::pop_heap(heap.begin(), heap.end(), heap_compare);
+                Cursor& cursor = plus_cursors[heap.back().second];
+                relevance += cursor.it->second * cursor.inverse_document_freq;
+                postings_visited.Add(1);
+                if (++cursor.it != cursor.end) {
+                    heap.back().first = cursor.it->first;
+                    std::push_heap(heap.begin(), heap.end(), heap_compare);
+                }
+                else {
+                    heap.pop_back();
+                }
+            }
+
+            //  -   ,      
+            const bool is_excluded = std::any_of(minus_cursors.begin(), minus_cursors.end(),
+                [document_id](Cursor& cursor) {
+                    if (cursor.bitmap != nullptr) {
+                        return cursor.bitmap->Contains(document_id);
+                    }
+                    while (cursor.it != cursor.end && cursor.it->first < document_id) {
+                        ++cursor.it;
+                    }
+                    return cursor.it != cursor.end && cursor.it->first == document_id;
+                });
+            if (is_excluded) {
+                minus_exclusions.Add(1);
+                continue;
+            }
+
+            const auto& document_data = documents_.at(document_id);
+            if (document_predicate(document_id, document_data.status, document_data.rating)) {
+                matched_documents.push_back({ document_id, relevance, document_data.rating });
+            }
+        }
+    }
+
+    query_stats_.RecordCounter(QueryCounter::POSTINGS_VISITED, postings_visited.Get());
+    query_stats_.RecordCounter(QueryCounter::DOCUMENTS_SCORED, matched_documents.size());
+    query_stats_.RecordCounter(QueryCounter::MINUS_EXCLUSIONS, minus_exclusions.Get());
+    return matched_documents;
+}
+
+template <typename DocumentPredicate>
+std::pmr::vector<Document> SearchServer::FindDocumentsBitmap(const QueryPlan& plan, DocumentPredicate document_predicate, DeadlineCheck* deadline_check) const {
+    //        id,      - 
+    const size_t universe = ids_of_documents_.empty() ? 0 : static_cast<size_t>(*ids_of_documents_.rbegin()) + 1;
+    std::pmr::memory_resource* scratch = QueryScratch::GetResource();
+    const bool use_impacts = options_.impact_bits > 0;
+    std::pmr::vector<double> relevances(use_impacts ? 0 : universe, 0.0, scratch);
+    std::pmr::vector<float> impact_relevances(use_impacts ? universe : 0, 0.0f, scratch);
+    std::pmr::vector<uint64_t> matched_bits((universe + 63) / 64, 0, scratch);
+    QueryCount postings_visited;
+    QueryCount minus_exclusions;
+
+    {
+        const QueryStageTimer traversal_timer(query_stats_, QueryStage::TRAVERSAL);
+        if (use_impacts) {
+            //     ,     
+            for (const QueryPlan::Term& term : plan.plus_terms) {
+                if (deadline_check != nullptr && deadline_check->CheckNow()) {
+                    break;
+                }
+                postings_visited.Add(impacts_.Accumulate(term.word, term.inverse_document_freq, impact_relevances.data()));
+            }
+            //     1,  IDF -  0,    -  
+            for (size_t document_id = 0; document_id < universe; ++document_id) {
+                matched_bits[document_id / 64] |= uint64_t{ impact_relevances[document_id] > 0.0f } << (document_id % 64);
+            }
+        }
+        else {
+            for (const QueryPlan::Term& term : plan.plus_terms) {
+                for (const auto [document_id, term_freq] : word_to_document_freqs_.at(term.word)) {
+                    if (deadline_check != nullptr && deadline_check->ShouldStop()) {
+                        break;
+                    }
+                    postings_visited.Add(1);
+                    relevances[document_id] += term_freq * term.inverse_document_freq;
+                    matched_bits[document_id / 64] |= uint64_t{ 1 } << (document_id % 64);
+                }
+            }
+        }
+        if (plan.matches_all_documents) {
+            for (const RoaringBitmap& status_bitmap : status_bitmaps_) {
+                status_bitmap.OrInto(matched_bits.data(), matched_bits.size());
+            }
+        }
+    }
+
+    {
+        const QueryStageTimer filtering_timer(query_stats_, QueryStage::FILTERING);
+        for (const QueryPlan::Term& term : plan.minus_terms) {
+            if (const RoaringBitmap* bitmap = FindTermBitmap(term.word)) {
+                minus_exclusions.Add(bitmap->AndNotInto(matched_bits.data(), matched_bits.size()));
+                continue;
+            }
+            for (const auto [document_id, _] : word_to_document_freqs_.at(term.word)) {
+                if (static_cast<size_t>(document_id) >= universe) {
+                    continue;
+                }
+                uint64_t& bits = matched_bits[document_id / 64];
+                const uint64_t mask = uint64_t{ 1 } << (document_id % 64);
+                minus_exclusions.Add((bits & mask) != 0);
+                bits &= ~mask;
+            }
+        }
+        //    -    ;       
+        if constexpr (std::is_same_v<DocumentPredicate, DocumentStatusPredicate>) {
+            status_bitmaps_[static_cast<size_t>(document_predicate.status)].AndInto(matched_bits.data(), matched_bits.size());
+        }
+    }
+
+    std::pmr::vector<Document> matched_documents(scratch);
+    for (size_t block = 0; block < matched_bits.size(); ++block) {
+        uint64_t bits = matched_bits[block];
+        while (bits != 0) {
+            int bit = 0;
+            while ((bits & (uint64_t{ 1 } << bit)) == 0) {
+                ++bit;
+            }
+            bits &= bits - 1;
+
+            const int document_id = static_cast<int>(block * 64 + bit);
+            const auto& document_data = documents_.at(document_id);
+            if (document_predicate(document_id, document_data.status, document_data.rating)) {
+                const double relevance = use_impacts ? impact_relevances[document_id] : relevances[document_id];
+                matched_documents.push_back({ document_id, relevance, document_data.rating });
+            }
+        }
+    }
+
+    query_stats_.RecordCounter(QueryCounter::POSTINGS_VISITED, postings_visited.Get());
+    query_stats_.RecordCounter(QueryCounter::DOCUMENTS_SCORED, matched_documents.size());
+    query_stats_.RecordCounter(QueryCounter::MINUS_EXCLUSIONS, minus_exclusions.Get());
+    return matched_documents;
+}
+
+template <typename DocumentPredicate>
+std::pmr::vector<Document> SearchServer::FindAllDocuments(const Query& query, DocumentPredicate document_predicate, DeadlineCheck* deadline_check) const {
+    return SearchServer::FindAllDocuments(std::execution::seq, query, document_predicate, deadline_check);
 }
@@ -0,0 +1,242 @@
+//    query_server:  ,    depth    .
+//         ,   .
+//    search-server:
+//   g++ -std=c++17 -O2 -I. service/load_generator.cpp benchmark/corpus_generator.cpp query_protocol.cpp latency_histogram.cpp document.cpp -lpthread
+//  : ./load_generator --unix=/tmp/search.sock --connections=8 --depth=32 --requests=200000
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../benchmark/corpus_generator.h"
+#include "../latency_histogram.h"
+#include "../query_protocol.h"
+
+using namespace std::literals;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct LoadOptions {
+    std::string unix_socket_path;
+    uint16_t port = 7700;
+    int connection_count = 4;
+    size_t depth = 16;          //     
+    size_t request_count = 100000;
+};
+
+struct ClientConnection {
+    int fd = -1;
+    std::string input;
+    std::string output;
+    size_t output_offset = 0;
+    std::deque<Clock::time_point> sent_at; //   ,     
+    uint32_t events = 0;
+};
+
+bool ParseOption(const std::string& arg, const std::string& name, std::string& value) {
+    const std::string prefix = "--"s + name + "="s;
+    if (arg.compare(0, prefix.size(), prefix) != 0) {
+        return false;
+    }
+    value = arg.substr(prefix.size());
+    return true;
+}
+
+int Connect(const LoadOptions& options) {
+    int fd = -1;
+    int result = -1;
+    if (!options.unix_socket_path.empty()) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, options.unix_socket_path.c_str(), sizeof(address.sun_path) - 1);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        result = connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    }
+    else {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(options.port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        result = connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+        const int enable = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    }
+    if (fd < 0 || result < 0) {
+        std::cerr << "Cannot connect: "s << std::strerror(errno) << std::endl;
+        std::exit(1);
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+// ,   ;      EPOLLOUT
+void Flush(int epoll_fd, ClientConnection& connection) {
+    while (connection.output_offset < connection.output.size()) {
+        const ssize_t size = send(connection.fd, connection.output.data() + connection.output_offset,
+            connection.output.size() - connection.output_offset, MSG_NOSIGNAL);
+        if (size < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                std::cerr << "send: "s << std::strerror(errno) << std::endl;
+                std::exit(1);
+            }
+            break;
+        }
+        connection.output_offset += size;
+    }
+    if (connection.output_offset == connection.output.size()) {
+        connection.output.clear();
+        connection.output_offset = 0;
+    }
+
+    const uint32_t events = EPOLLIN | (connection.output.empty() ? 0 : EPOLLOUT);
+    if (events != connection.events) {
+        epoll_event event{};
+        event.events = events;
+        event.data.ptr = &connection;
+        epoll_ctl(epoll_fd, EPOLL_CTL_MOD, connection.fd, &event);
+        connection.events = events;
+    }
+}
+
+}
+
+int main(int argc, char** argv) {
+    LoadOptions options;
+    CorpusOptions corpus_options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        std::string value;
+        if (ParseOption(arg, "unix"s, value)) {
+            options.unix_socket_path = value;
+        }
+        else if (ParseOption(arg, "port"s, value)) {
+            options.port = static_cast<uint16_t>(std::stoi(value));
+        }
+        else if (ParseOption(arg, "connections"s, value)) {
+            options.connection_count = std::stoi(value);
+        }
+        else if (ParseOption(arg, "depth"s, value)) {
+            options.depth = std::stoul(value);
+        }
+        else if (ParseOption(arg, "requests"s, value)) {
+            options.request_count = std::stoul(value);
+        }
+        else if (ParseOption(arg, "docs"s, value)) {
+            corpus_options.document_count = std::stoi(value);
+        }
+        else if (ParseOption(arg, "seed"s, value)) {
+            corpus_options.seed = std::stoull(value);
+        }
+        else {
+            std::cerr << "Unknown option: "s << arg << std::endl;
+            return 1;
+        }
+    }
+
+    const std::vector<std::string> queries = GenerateCorpus(corpus_options).queries;
+    const int epoll_fd = epoll_create1(0);
+    std::vector<ClientConnection> connections(options.connection_count);
+    for (ClientConnection& connection : connections) {
+        connection.fd = Connect(options);
+        connection.events = EPOLLIN;
+        epoll_event event{};
+        event.events = connection.events;
+        event.data.ptr = &connection;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, connection.fd, &event);
+    }
+
+    size_t sent = 0;
+    size_t received = 0;
+    size_t errors = 0;
+    size_t found_documents = 0;
+    LatencyHistogram::Snapshot latencies;
+    const auto send_request = [&](ClientConnection& connection) {
+        connection.output += queries[sent % queries.size()];
+        connection.output += '\n';
+        connection.sent_at.push_back(Clock::now());
+        ++sent;
+    };
+
+    const Clock::time_point start = Clock::now();
+    for (ClientConnection& connection : connections) {
+        while (connection.sent_at.size() < options.depth && sent < options.request_count) {
+            send_request(connection);
+        }
+        Flush(epoll_fd, connection);
+    }
+
+    std::vector<epoll_event> events(connections.size());
+    std::vector<char> read_buffer(64 * 1024);
+    std::vector<Document> documents;
+    while (received < options.request_count) {
+        const int event_count = epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()), -1);
+        for (int i = 0; i < event_count; ++i) {
+            ClientConnection& connection = *static_cast<ClientConnection*>(events[i].data.ptr);
+            if ((events[i].events & EPOLLIN) != 0) {
+                const ssize_t size = recv(connection.fd, read_buffer.data(), read_buffer.size(), 0);
+                if (size == 0 || (size < 0 && errno != EAGAIN && errno != EINTR)) {
+                    std::cerr << "Connection closed by server"s << std::endl;
+                    return 1;
+                }
+                if (size > 0) {
+                    connection.input.append(read_buffer.data(), size);
+                }
+
+                std::string_view input(connection.input);
+                std::string_view line;
+                const Clock::time_point now = Clock::now();
+                while (ExtractLine(input, line)) {
+                    latencies.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(now - connection.sent_at.front()).count());
+                    connection.sent_at.pop_front();
+                    ++received;
+                    if (ParseResponse(line, documents)) {
+                        found_documents += documents.size();
+                    }
+                    else {
+                        ++errors;
+                    }
+                    if (sent < options.request_count) {
+                        send_request(connection);
+                    }
+                }
+                connection.input.erase(0, connection.input.size() - input.size());
+            }
+            Flush(epoll_fd, connection);
+        }
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    for (const ClientConnection& connection : connections) {
+        close(connection.fd);
+    }
+    close(epoll_fd);
+
+    const auto to_us = [](uint64_t ns) { return ns / 1000.0; };
+    std::cout << "requests: "s << received << ", errors: "s << errors << ", documents: "s << found_documents
+        << ", seconds: "s << seconds << ", requests/s: "s << received / seconds << '\n'
+        << "latency us: p50 = "s << to_us(latencies.GetValueAtPercentile(50))
+        << ", p90 = "s << to_us(latencies.GetValueAtPercentile(90))
+        << ", p99 = "s << to_us(latencies.GetValueAtPercentile(99))
+        << ", max = "s << to_us(latencies.max_value) << std::endl;
+    return 0;
+}
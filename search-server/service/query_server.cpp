@@ -0,0 +1,115 @@
+//   : QueryService  SearchServer       .
+//    search-server:
+//   g++ -std=c++17 -O2 -I. service/query_server.cpp service/query_service.cpp benchmark/corpus_generator.cpp < .cpp ,  main.cpp  unit_tests.cpp> -ltbb -lpthread
+//  : ./query_server --unix=/tmp/search.sock --docs=20000
+//                 ./query_server --port=7700 --corpus=documents.txt --stop-words="and in on"
+//   -    , id  -    
+
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "../benchmark/corpus_generator.h"
+#include "../search_server.h"
+#include "query_service.h"
+
+using namespace std::literals;
+
+namespace {
+
+QueryService* running_service = nullptr;
+
+void HandleSignal(int) {
+    if (running_service != nullptr) {
+        running_service->Stop();
+    }
+}
+
+bool ParseOption(const std::string& arg, const std::string& name, std::string& value) {
+    const std::string prefix = "--"s + name + "="s;
+    if (arg.compare(0, prefix.size(), prefix) != 0) {
+        return false;
+    }
+    value = arg.substr(prefix.size());
+    return true;
+}
+
+}
+
+int main(int argc, char** argv) {
+    QueryService::Options service_options;
+    CorpusOptions corpus_options;
+    std::string corpus_path;
+    std::string stop_words;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        std::string value;
+        if (ParseOption(arg, "unix"s, value)) {
+            service_options.unix_socket_path = value;
+        }
+        else if (ParseOption(arg, "port"s, value)) {
+            service_options.port = static_cast<uint16_t>(std::stoi(value));
+        }
+        else if (ParseOption(arg, "batch"s, value)) {
+            service_options.max_batch_size = std::stoul(value);
+        }
+        else if (ParseOption(arg, "corpus"s, value)) {
+            corpus_path = value;
+        }
+        else if (ParseOption(arg, "stop-words"s, value)) {
+            stop_words = value;
+        }
+        else if (ParseOption(arg, "docs"s, value)) {
+            corpus_options.document_count = std::stoi(value);
+        }
+        else if (ParseOption(arg, "seed"s, value)) {
+            corpus_options.seed = std::stoull(value);
+        }
+        else {
+            std::cerr << "Unknown option: "s << arg << std::endl;
+            return 1;
+        }
+    }
+
+    SearchServer search_server = [&] {
+        if (corpus_path.empty()) {
+            const Corpus corpus = GenerateCorpus(corpus_options);
+            SearchServer server(corpus.stop_words);
+            for (size_t i = 0; i < corpus.documents.size(); ++i) {
+                server.AddDocument(static_cast<int>(i), corpus.documents[i], corpus.statuses[i], corpus.ratings[i]);
+            }
+            return server;
+        }
+
+        std::ifstream input(corpus_path);
+        if (!input) {
+            std::cerr << "Cannot open "s << corpus_path << std::endl;
+            std::exit(1);
+        }
+        SearchServer server(stop_words);
+        std::string line;
+        for (int id = 0; std::getline(input, line); ++id) {
+            server.AddDocument(id, line, DocumentStatus::ACTUAL, {});
+        }
+        return server;
+    }();
+
+    QueryService service(search_server, service_options);
+    running_service = &service;
+    std::signal(SIGINT, HandleSignal);
+    std::signal(SIGTERM, HandleSignal);
+
+    std::cerr << "documents: "s << search_server.GetDocumentCount() << ", listening on "s
+        << (service_options.unix_socket_path.empty() ? "127.0.0.1:"s + std::to_string(service.GetPort()) : service_options.unix_socket_path)
+        << std::endl;
+    service.Run();
+    running_service = nullptr;
+
+    const QueryService::Stats stats = service.GetStats();
+    std::cerr << "connections: "s << stats.connections << ", requests: "s << stats.requests
+        << ", errors: "s << stats.errors << ", batches: "s << stats.batches
+        << ", mean batch: "s << (stats.batches > 0 ? static_cast<double>(stats.requests) / stats.batches : 0.0) << std::endl;
+    return 0;
+}
@@ -0,0 +1,424 @@
+#include "query_service.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <execution>
+#include <stdexcept>
+#include <system_error>
+
+#include "../log_duration.h"
+#include "../query_protocol.h"
+
+namespace {
+
+const size_t READ_CHUNK_SIZE = 64 * 1024;
+const int MAX_EVENTS = 256;
+
+[[noreturn]] void ThrowSystemError(const char* operation) {
+    throw std::system_error(errno, std::generic_category(), operation);
+}
+
+}
+
+QueryService::QueryService(const SearchServer& search_server, const Options& options)
+    : search_server_(search_server)
+    , options_(options)
+    , read_buffer_(READ_CHUNK_SIZE)
+{
+    try {
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd_ < 0) {
+            ThrowSystemError("epoll_create1");
+        }
+        stop_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (stop_fd_ < 0) {
+            ThrowSystemError("eventfd");
+        }
+        Listen();
+
+        for (const int fd : { listen_fd_, stop_fd_ }) {
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.fd = fd;
+            if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+                ThrowSystemError("epoll_ctl");
+            }
+        }
+    }
+    catch (...) {
+        CloseDescriptors();
+        throw;
+    }
+}
+
+QueryService::~QueryService() {
+    CloseDescriptors();
+}
+
+uint16_t QueryService::GetPort() const {
+    return port_;
+}
+
+void QueryService::Run() {
+    std::vector<epoll_event> events(MAX_EVENTS);
+    while (!stopped_.load(std::memory_order_acquire)) {
+        const int event_count = epoll_wait(epoll_fd_, events.data(), MAX_EVENTS, -1);
+        if (event_count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ThrowSystemError("epoll_wait");
+        }
+
+        touched_.clear();
+        for (int i = 0; i < event_count; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == stop_fd_) {
+                uint64_t value = 0;
+                [[maybe_unused]] const ssize_t size = read(stop_fd_, &value, sizeof(value));
+                continue;
+            }
+            if (fd == listen_fd_) {
+                AcceptConnections();
+                continue;
+            }
+
+            const auto it = connections_.find(fd);
+            if (it == connections_.end()) {
+                continue;
+            }
+            Connection& connection = it->second;
+            if ((events[i].events & EPOLLERR) != 0) {
+                connection.broken = true;
+            }
+            else {
+                if ((events[i].events & (EPOLLIN | EPOLLHUP)) != 0) {
+                    ReadInput(connection);
+                }
+                if ((events[i].events & EPOLLOUT) != 0) {
+                    WriteOutput(connection);
+                }
+            }
+            touched_.push_back(fd);
+        }
+
+        while (CollectBatch()) {
+            ProcessBatch();
+        }
+        for (const int fd : touched_) {
+            FinishConnection(fd);
+        }
+    }
+}
+
+void QueryService::Stop() {
+    stopped_.store(true, std::memory_order_release);
+    // write  eventfd    
+    const uint64_t value = 1;
+    [[maybe_unused]] const ssize_t size = write(stop_fd_, &value, sizeof(value));
+}
+
+QueryService::Stats QueryService::GetStats() const {
+    return stats_;
+}
+
+// private
+
+void QueryService::Listen() {
+    if (!options_.unix_socket_path.empty()) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (options_.unix_socket_path.size() >= sizeof(address.sun_path)) {
+            throw std::invalid_argument("Unix socket path is too long");
+        }
+        std::memcpy(address.sun_path, options_.unix_socket_path.c_str(), options_.unix_socket_path.size() + 1);
+
+        listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listen_fd_ < 0) {
+            ThrowSystemError("socket");
+        }
+        // ,    
+        unlink(options_.unix_socket_path.c_str());
+        if (bind(listen_fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+            ThrowSystemError("bind");
+        }
+    }
+    else {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(options_.port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listen_fd_ < 0) {
+            ThrowSystemError("socket");
+        }
+        const int enable = 1;
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+        if (bind(listen_fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+            ThrowSystemError("bind");
+        }
+        socklen_t address_size = sizeof(address);
+        if (getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &address_size) < 0) {
+            ThrowSystemError("getsockname");
+        }
+        port_ = ntohs(address.sin_port);
+    }
+
+    if (listen(listen_fd_, SOMAXCONN) < 0) {
+        ThrowSystemError("listen");
+    }
+}
+
+void QueryService::CloseDescriptors() {
+    for (const auto& [fd, connection] : connections_) {
+        close(fd);
+    }
+    connections_.clear();
+    for (int* fd : { &listen_fd_, &stop_fd_, &epoll_fd_ }) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+    if (!options_.unix_socket_path.empty()) {
+        unlink(options_.unix_socket_path.c_str());
+    }
+}
+
+void QueryService::AcceptConnections() {
+    while (true) {
+        const int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            // EAGAIN -  ;        
+            return;
+        }
+        if (options_.unix_socket_path.empty()) {
+            //       
+            const int enable = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+        }
+
+        Connection& connection = connections_[fd];
+        connection.fd = fd;
+        connection.events = EPOLLIN;
+        epoll_event event{};
+        event.events = connection.events;
+        event.data.fd = fd;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+            CloseConnection(fd);
+            continue;
+        }
+        ++stats_.connections;
+    }
+}
+
+void QueryService::ReadInput(Connection& connection) {
+    if (connection.closing || connection.broken) {
+        return;
+    }
+    //     ,       
+    connection.input.erase(0, connection.input_offset);
+    connection.input_offset = 0;
+
+    //  ,          ;
+    //     
+    while (connection.input.size() <= options_.max_request_size) {
+        const ssize_t size = recv(connection.fd, read_buffer_.data(), read_buffer_.size(), 0);
+        if (size > 0) {
+            connection.input.append(read_buffer_.data(), size);
+            if (static_cast<size_t>(size) < read_buffer_.size()) {
+                break;
+            }
+            continue;
+        }
+        if (size == 0) {
+            connection.closing = true;
+        }
+        else if (errno == EINTR) {
+            continue;
+        }
+        else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            connection.broken = true;
+        }
+        break;
+    }
+
+    if (!connection.is_ready && !connection.broken) {
+        connection.is_ready = true;
+        ready_.push_back(connection.fd);
+    }
+}
+
+void QueryService::WriteOutput(Connection& connection) {
+    while (!connection.broken && connection.output_offset < connection.output.size()) {
+        const ssize_t size = send(connection.fd, connection.output.data() + connection.output_offset,
+            connection.output.size() - connection.output_offset, MSG_NOSIGNAL);
+        if (size >= 0) {
+            connection.output_offset += size;
+        }
+        else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        else if (errno != EINTR) {
+            connection.broken = true;
+        }
+    }
+    if (connection.output_offset == connection.output.size()) {
+        connection.output.clear();
+        connection.output_offset = 0;
+    }
+}
+
+bool QueryService::CollectBatch() {
+    batch_.clear();
+    size_t kept = 0;
+    for (size_t i = 0; i < ready_.size(); ++i) {
+        const auto it = connections_.find(ready_[i]);
+        if (it == connections_.end()) {
+            continue;
+        }
+        Connection& connection = it->second;
+        if (connection.broken) {
+            connection.is_ready = false;
+            continue;
+        }
+        //    :   ,     
+        if (batch_.size() == options_.max_batch_size
+            || connection.output.size() - connection.output_offset > options_.max_output_size) {
+            ready_[kept++] = ready_[i];
+            continue;
+        }
+
+        std::string_view input(connection.input);
+        input.remove_prefix(connection.input_offset);
+        std::string_view line;
+        while (batch_.size() < options_.max_batch_size && ExtractLine(input, line)) {
+            batch_.push_back({ &connection, line });
+        }
+        connection.input_offset = connection.input.size() - input.size();
+
+        if (batch_.size() == options_.max_batch_size && input.find('\n') != std::string_view::npos) {
+            ready_[kept++] = ready_[i];
+            continue;
+        }
+        if (input.size() > options_.max_request_size) {
+            connection.input_offset = connection.input.size();
+            connection.too_long = true;
+            connection.closing = true;
+        }
+        connection.is_ready = false;
+        touched_.push_back(connection.fd);
+    }
+    ready_.resize(kept);
+    return !batch_.empty();
+}
+
+void QueryService::ProcessBatch() {
+    TRACE_DURATION("QueryService::ProcessBatch");
+    const auto evaluate = [this](const PendingQuery& query) {
+        QueryResult result;
+        //    -  ,     
+        try {
+            Expected<std::vector<Document>> documents = search_server_.TryFindTopDocuments(query.raw_query);
+            if (documents) {
+                result.documents = std::move(documents).Value();
+            }
+            else {
+                result.error = GetSearchErrorMessage(documents.GetError());
+            }
+        }
+        catch (const std::exception& e) {
+            result.error = e.what();
+        }
+        return result;
+    };
+
+    results_.resize(batch_.size());
+    if (batch_.size() == 1) {
+        results_[0] = evaluate(batch_[0]);
+    }
+    else {
+        std::transform(std::execution::par, batch_.begin(), batch_.end(), results_.begin(), evaluate);
+    }
+    ++stats_.batches;
+    stats_.requests += batch_.size();
+
+    for (size_t i = 0; i < batch_.size(); ++i) {
+        Connection& connection = *batch_[i].connection;
+        if (results_[i].error.empty()) {
+            AppendResponse(connection.output, results_[i].documents);
+        }
+        else {
+            AppendErrorResponse(connection.output, results_[i].error);
+            ++stats_.errors;
+        }
+        //      ,      
+        if (i + 1 == batch_.size() || batch_[i + 1].connection != &connection) {
+            WriteOutput(connection);
+        }
+    }
+}
+
+void QueryService::UpdateEvents(Connection& connection) {
+    uint32_t events = 0;
+    if (!connection.closing && connection.output.size() - connection.output_offset <= options_.max_output_size) {
+        events |= EPOLLIN;
+    }
+    if (connection.output_offset < connection.output.size()) {
+        events |= EPOLLOUT;
+    }
+    if (events == connection.events) {
+        return;
+    }
+
+    epoll_event event{};
+    event.events = events;
+    event.data.fd = connection.fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, connection.fd, &event) < 0) {
+        connection.broken = true;
+        return;
+    }
+    connection.events = events;
+}
+
+void QueryService::FinishConnection(int fd) {
+    const auto it = connections_.find(fd);
+    if (it == connections_.end()) {
+        return;
+    }
+    Connection& connection = it->second;
+    if (connection.too_long) {
+        //        output
+        AppendErrorResponse(connection.output, "Request is too long");
+        ++stats_.errors;
+        connection.too_long = false;
+        WriteOutput(connection);
+    }
+    if (!connection.broken) {
+        UpdateEvents(connection);
+    }
+    const bool is_done = connection.closing && !connection.is_ready && connection.output.empty();
+    if (connection.broken || is_done) {
+        CloseConnection(fd);
+    }
+}
+
+void QueryService::CloseConnection(int fd) {
+    //      epoll
+    close(fd);
+    connections_.erase(fd);
+}
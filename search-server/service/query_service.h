@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../search_server.h"
+
+//   SearchServer  epoll ( Linux).  127.0.0.1  Unix-
+//      query_protocol.h.  ,  
+//   : ,       ,
+//      ,   ProcessQueries.
+//      ,       
+class QueryService {
+public:
+    struct Options {
+        std::string unix_socket_path; //   - TCP  127.0.0.1
+        uint16_t port = 0;            // 0 -  , . GetPort
+        size_t max_batch_size = 256;
+        size_t max_request_size = 64 * 1024;
+        //       ,       
+        size_t max_output_size = 1024 * 1024;
+    };
+
+    struct Stats {
+        uint64_t connections = 0; //  
+        uint64_t requests = 0;
+        uint64_t errors = 0;      //  ERR
+        uint64_t batches = 0;
+    };
+
+    //     ;    std::system_error
+    QueryService(const SearchServer& search_server, const Options& options);
+    ~QueryService();
+
+    QueryService(const QueryService&) = delete;
+    QueryService& operator=(const QueryService&) = delete;
+
+    //  TCP-, 0  Unix-
+    uint16_t GetPort() const;
+
+    //  ,    Stop
+    void Run();
+
+    //         
+    void Stop();
+
+    //     Run
+    Stats GetStats() const;
+
+private:
+    struct Connection {
+        int fd = -1;
+        std::string input;        //  ,     
+        size_t input_offset = 0;  //     
+        std::string output;
+        size_t output_offset = 0; //     
+        uint32_t events = 0;      // ,    fd
+        bool is_ready = false;    //   ready_
+        bool closing = false;     //        :   
+        bool too_long = false;    //       
+        bool broken = false;      //  :  
+    };
+
+    struct PendingQuery {
+        Connection* connection;
+        std::string_view raw_query;
+    };
+
+    struct QueryResult {
+        std::vector<Document> documents;
+        std::string error;
+    };
+
+    const SearchServer& search_server_;
+    const Options options_;
+    int listen_fd_ = -1;
+    int epoll_fd_ = -1;
+    int stop_fd_ = -1; // eventfd,  epoll_wait  Stop
+    uint16_t port_ = 0;
+    std::atomic<bool> stopped_ = false;
+    std::unordered_map<int, Connection> connections_;
+    std::vector<int> ready_;   //     
+    std::vector<int> touched_; // ,     
+    std::vector<char> read_buffer_;
+    std::vector<PendingQuery> batch_;
+    std::vector<QueryResult> results_;
+    Stats stats_;
+
+    void Listen();
+    void CloseDescriptors();
+    void AcceptConnections();
+    void ReadInput(Connection& connection);
+    void WriteOutput(Connection& connection);
+
+    //   batch_   ,    .
+    //  false,    
+    bool CollectBatch();
+    void ProcessBatch();
+
+    //           
+    void UpdateEvents(Connection& connection);
+    //  ,       ,   
+    void FinishConnection(int fd);
+    void CloseConnection(int fd);
+};
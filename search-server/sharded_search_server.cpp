@@ -0,0 +1,327 @@
+#include "sharded_search_server.h"
+
+#include <limits>
+#include <thread>
+
+ShardedSearchServer::ShardedSearchServer(const std::string_view& stop_words_text, size_t shard_count, const IndexOptions& options)
+    : ShardedSearchServer(SplitIntoWords(stop_words_text), shard_count, options)
+{}
+
+ShardedSearchServer::ShardedSearchServer(const std::string& stop_words_text, size_t shard_count, const IndexOptions& options)
+    : ShardedSearchServer(std::string_view{ stop_words_text }, shard_count, options)
+{}
+
+void ShardedSearchServer::AddDocument(int document_id, const std::string_view& document, DocumentStatus status, const std::vector<int>& ratings) {
+    SearchServer& server = GetShard(document_id);
+    server.AddDocument(document_id, document, status, ratings);
+    document_ids_.insert(document_id);
+    server.MatchStandingQueries(standing_queries_, document_id);
+}
+
+void ShardedSearchServer::AddDocuments(std::execution::sequenced_policy policy, const std::vector<NewDocument>& documents) {
+    AddDocumentsToShards(policy, documents);
+}
+
+void ShardedSearchServer::AddDocuments(std::execution::parallel_policy policy, const std::vector<NewDocument>& documents) {
+    AddDocumentsToShards(policy, documents);
+}
+
+std::vector<Document> ShardedSearchServer::FindTopDocuments(const std::string_view& raw_query, DocumentStatus status) const {
+    return ShardedSearchServer::FindTopDocuments(std::execution::par, raw_query, status);
+}
+
+std::vector<Document> ShardedSearchServer::FindTopDocuments(const std::string_view& raw_query) const {
+    return ShardedSearchServer::FindTopDocuments(std::execution::par, raw_query);
+}
+
+SearchPage ShardedSearchServer::FindPage(const std::string_view& raw_query, size_t page_size, const PageCursor& cursor) const {
+    return ShardedSearchServer::FindPage(std::execution::par, raw_query, page_size, cursor,
+        [](int, DocumentStatus document_status, int) { return document_status == DocumentStatus::ACTUAL; });
+}
+
+SearchPage ShardedSearchServer::FindPageAt(const std::string_view& raw_query, size_t page_size, size_t page_index) const {
+    return ShardedSearchServer::FindPageAt(std::execution::par, raw_query, page_size, page_index,
+        [](int, DocumentStatus document_status, int) { return document_status == DocumentStatus::ACTUAL; });
+}
+
+std::vector<std::string_view> ShardedSearchServer::GetCompletions(std::string_view prefix, size_t max_count) const {
+    //      ,    ,      
+    std::set<std::string_view> words;
+    for (const SearchServer& server : shards_->servers) {
+        for (const std::string_view word : server.GetCompletions(prefix, std::numeric_limits<size_t>::max())) {
+            words.insert(word);
+        }
+    }
+
+    std::vector<std::pair<size_t, std::string_view>> candidates;
+    candidates.reserve(words.size());
+    for (const std::string_view word : words) {
+        candidates.emplace_back(shards_->GetDocumentFreq(word), word);
+    }
+
+    const size_t count = std::min(max_count, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+        [](const auto& lhs, const auto& rhs) {
+            return lhs.first != rhs.first ? lhs.first > rhs.first : lhs.second < rhs.second;
+        });
+
+    std::vector<std::string_view> completions(count);
+    std::transform(candidates.begin(), candidates.begin() + count, completions.begin(),
+        [](const auto& candidate) { return candidate.second; });
+    return completions;
+}
+
+std::vector<QueryPlan> ShardedSearchServer::ExplainQuery(const std::string_view& raw_query) const {
+    std::vector<QueryPlan> plans;
+    plans.reserve(GetShardCount());
+    for (const SearchServer& server : shards_->servers) {
+        plans.push_back(server.ExplainQuery(raw_query));
+    }
+    return plans;
+}
+
+size_t ShardedSearchServer::RegisterStandingQuery(const std::string_view& raw_query, StandingQueryCallback callback) {
+    // -   ,      
+    return shards_->servers.front().RegisterStandingQuery(standing_queries_, raw_query, std::move(callback));
+}
+
+void ShardedSearchServer::UnregisterStandingQuery(size_t query_id) {
+    standing_queries_.Remove(query_id);
+}
+
+int ShardedSearchServer::GetDocumentCount() const {
+    return static_cast<int>(document_ids_.size());
+}
+
+size_t ShardedSearchServer::GetShardCount() const {
+    return shards_->servers.size();
+}
+
+std::tuple<std::vector<std::string_view>, DocumentStatus> ShardedSearchServer::MatchDocument(const std::string_view& raw_query, int document_id) const {
+    return GetShard(document_id).MatchDocument(raw_query, document_id);
+}
+
+std::tuple<std::vector<std::string_view>, DocumentStatus> ShardedSearchServer::MatchDocument(std::execution::sequenced_policy policy, const std::string_view& raw_query, int document_id) const {
+    return GetShard(document_id).MatchDocument(policy, raw_query, document_id);
+}
+
+std::tuple<std::vector<std::string_view>, DocumentStatus> ShardedSearchServer::MatchDocument(std::execution::parallel_policy policy, const std::string_view& raw_query, int document_id) const {
+    return GetShard(document_id).MatchDocument(policy, raw_query, document_id);
+}
+
+void ShardedSearchServer::MatchDocuments(std::execution::sequenced_policy policy, const std::string_view& raw_query, const std::vector<int>& document_ids, MatchedDocuments& result) const {
+    MatchDocumentsInShards(policy, raw_query, document_ids, result);
+}
+
+void ShardedSearchServer::MatchDocuments(std::execution::parallel_policy policy, const std::string_view& raw_query, const std::vector<int>& document_ids, MatchedDocuments& result) const {
+    MatchDocumentsInShards(policy, raw_query, document_ids, result);
+}
+
+MatchedDocuments ShardedSearchServer::MatchDocuments(const std::string_view& raw_query, const std::vector<int>& document_ids) const {
+    MatchedDocuments result;
+    MatchDocuments(std::execution::seq, raw_query, document_ids, result);
+    return result;
+}
+
+std::set<int>::const_iterator ShardedSearchServer::begin() const {
+    return document_ids_.begin();
+}
+
+std::set<int>::const_iterator ShardedSearchServer::end() const {
+    return document_ids_.end();
+}
+
+WordFrequencies ShardedSearchServer::GetWordFrequencies(int document_id) const {
+    return GetShard(document_id).GetWordFrequencies(document_id);
+}
+
+void ShardedSearchServer::RemoveDocument(int document_id) {
+    GetShard(document_id).RemoveDocument(document_id);
+    document_ids_.erase(document_id);
+}
+
+void ShardedSearchServer::RemoveDocument(std::execution::sequenced_policy policy, int document_id) {
+    GetShard(document_id).RemoveDocument(policy, document_id);
+    document_ids_.erase(document_id);
+}
+
+void ShardedSearchServer::RemoveDocument(std::execution::parallel_policy policy, int document_id) {
+    GetShard(document_id).RemoveDocument(policy, document_id);
+    document_ids_.erase(document_id);
+}
+
+void ShardedSearchServer::RemoveDocuments(std::execution::sequenced_policy policy, const std::vector<int>& document_ids) {
+    RemoveDocumentsFromShards(policy, document_ids);
+}
+
+void ShardedSearchServer::RemoveDocuments(std::execution::parallel_policy policy, const std::vector<int>& document_ids) {
+    RemoveDocumentsFromShards(policy, document_ids);
+}
+
+QueryStatsSnapshot ShardedSearchServer::GetQueryStats() const {
+    QueryStatsSnapshot stats;
+    for (const SearchServer& server : shards_->servers) {
+        const QueryStatsSnapshot shard_stats = server.GetQueryStats();
+        for (size_t i = 0; i < stats.stages.size(); ++i) {
+            stats.stages[i].Merge(shard_stats.stages[i]);
+        }
+        for (size_t i = 0; i < stats.counters.size(); ++i) {
+            stats.counters[i].Merge(shard_stats.counters[i]);
+        }
+    }
+    return stats;
+}
+
+void ShardedSearchServer::ResetQueryStats() {
+    for (SearchServer& server : shards_->servers) {
+        server.ResetQueryStats();
+    }
+}
+
+MemoryStats ShardedSearchServer::GetMemoryStats() const {
+    MemoryStats stats;
+    for (const SearchServer& server : shards_->servers) {
+        const MemoryStats shard_stats = server.GetMemoryStats();
+        for (size_t i = 0; i < stats.structures.size(); ++i) {
+            stats.structures[i].bytes += shard_stats.structures[i].bytes;
+            stats.structures[i].entries += shard_stats.structures[i].entries;
+        }
+        stats.used_bytes += shard_stats.used_bytes;
+        stats.reserved_bytes += shard_stats.reserved_bytes;
+        stats.allocator_overhead_bytes += shard_stats.allocator_overhead_bytes;
+    }
+    if (stats.reserved_bytes > 0) {
+        stats.fragmentation = static_cast<double>(stats.allocator_overhead_bytes) / stats.reserved_bytes;
+    }
+    return stats;
+}
+
+// private
+
+size_t ShardedSearchServer::Shards::GetDocumentCount() const {
+    size_t document_count = 0;
+    for (const SearchServer& server : servers) {
+        document_count += server.GetDocumentCount();
+    }
+    return document_count;
+}
+
+size_t ShardedSearchServer::Shards::GetDocumentFreq(std::string_view word) const {
+    size_t document_freq = 0;
+    for (const SearchServer& server : servers) {
+        document_freq += server.GetDocumentFreq(word);
+    }
+    return document_freq;
+}
+
+size_t ShardedSearchServer::GetDefaultShardCount() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void ShardedSearchServer::ConnectShards() {
+    for (SearchServer& server : shards_->servers) {
+        server.SetCollectionStatistics(shards_.get());
+    }
+}
+
+size_t ShardedSearchServer::GetShardIndex(int document_id) const {
+    //  : id    (,  )     
+    const uint64_t hash = static_cast<uint32_t>(document_id) * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(hash >> 32) % GetShardCount();
+}
+
+const SearchServer& ShardedSearchServer::GetShard(int document_id) const {
+    return shards_->servers[GetShardIndex(document_id)];
+}
+
+SearchServer& ShardedSearchServer::GetShard(int document_id) {
+    return shards_->servers[GetShardIndex(document_id)];
+}
+
+std::vector<std::vector<int>> ShardedSearchServer::GroupByShard(const std::vector<int>& document_ids) const {
+    std::vector<std::vector<int>> shard_ids(GetShardCount());
+    for (const int document_id : document_ids) {
+        shard_ids[GetShardIndex(document_id)].push_back(document_id);
+    }
+    return shard_ids;
+}
+
+template <typename ExecutionPolicy>
+void ShardedSearchServer::AddDocumentsToShards(const ExecutionPolicy& policy, const std::vector<NewDocument>& documents) {
+    std::vector<std::vector<const NewDocument*>> shard_documents(GetShardCount());
+    for (const NewDocument& document : documents) {
+        shard_documents[GetShardIndex(document.id)].push_back(&document);
+    }
+
+    // id  ,     id    
+    std::vector<std::vector<int>> added_ids(GetShardCount());
+    std::exception_ptr error;
+    try {
+        ForEachShard(policy, [&](size_t shard_index) {
+            SearchServer& server = shards_->servers[shard_index];
+            for (const NewDocument* document : shard_documents[shard_index]) {
+                server.AddDocument(document->id, document->text, document->status, document->ratings);
+                added_ids[shard_index].push_back(document->id);
+            }
+            });
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+
+    for (const std::vector<int>& ids : added_ids) {
+        document_ids_.insert(ids.begin(), ids.end());
+    }
+
+    // IDF    ,   ,     
+    if (!standing_queries_.IsEmpty()) {
+        ForEachShard(policy, [&](size_t shard_index) {
+            const SearchServer& server = shards_->servers[shard_index];
+            for (const int document_id : added_ids[shard_index]) {
+                server.MatchStandingQueries(standing_queries_, document_id);
+            }
+            });
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+template <typename ExecutionPolicy>
+void ShardedSearchServer::RemoveDocumentsFromShards(const ExecutionPolicy& policy, const std::vector<int>& document_ids) {
+    const std::vector<std::vector<int>> shard_ids = GroupByShard(document_ids);
+    ForEachShard(policy, [&](size_t shard_index) {
+        SearchServer& server = shards_->servers[shard_index];
+        //      ,     
+        for (const int document_id : shard_ids[shard_index]) {
+            server.RemoveDocument(std::execution::par, document_id);
+        }
+        });
+    for (const int document_id : document_ids) {
+        document_ids_.erase(document_id);
+    }
+}
+
+template <typename ExecutionPolicy>
+void ShardedSearchServer::MatchDocumentsInShards(const ExecutionPolicy& policy, const std::string_view& raw_query, const std::vector<int>& document_ids, MatchedDocuments& result) const {
+    const std::vector<std::vector<int>> shard_ids = GroupByShard(document_ids);
+    std::vector<MatchedDocuments> shard_results(GetShardCount());
+    ForEachShard(policy, [&](size_t shard_index) {
+        shards_->servers[shard_index].MatchDocuments(std::execution::seq, raw_query, shard_ids[shard_index], shard_results[shard_index]);
+        });
+
+    //       id,      
+    result.words_.clear();
+    result.offsets_.assign(1, 0);
+    result.statuses_.clear();
+    std::vector<size_t> next_indices(GetShardCount());
+    for (const int document_id : document_ids) {
+        const size_t shard_index = GetShardIndex(document_id);
+        const MatchedDocuments& shard_result = shard_results[shard_index];
+        const size_t index = next_indices[shard_index]++;
+        const MatchedDocuments::WordsRange words = shard_result.GetWords(index);
+        result.words_.insert(result.words_.end(), words.begin(), words.end());
+        result.offsets_.push_back(result.words_.size());
+        result.statuses_.push_back(shard_result.GetStatus(index));
+    }
+}
@@ -0,0 +1,309 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <execution>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "search_server.h"
+
+//      ShardedSearchServer
+struct NewDocument {
+    int id = 0;
+    std::string_view text;
+    DocumentStatus status = DocumentStatus::ACTUAL;
+    std::vector<int> ratings;
+};
+
+//     SearchServer ().    ,    id,
+//       . IDF     
+//    IDF      .      ,
+//      .
+//   "*"        ,   
+//  max_prefix_expansions  max_typo_expansions      
+class ShardedSearchServer {
+public:
+    // shard_count = 0 -    
+    template <typename StringContainer>
+    explicit ShardedSearchServer(const StringContainer& stop_words, size_t shard_count = 0, const IndexOptions& options = {});
+    explicit ShardedSearchServer(const std::string_view& stop_words_text, size_t shard_count = 0, const IndexOptions& options = {});
+    explicit ShardedSearchServer(const std::string& stop_words_text, size_t shard_count = 0, const IndexOptions& options = {});
+
+    void AddDocument(int document_id, const std::string_view& document, DocumentStatus status, const std::vector<int>& ratings);
+
+    template <typename RatingIterator>
+    void AddDocument(int document_id, const std::string_view& document, DocumentStatus status, RatingIterator ratings_begin, RatingIterator ratings_end);
+
+    //      ,   -   parallel_policy.
+    //  -   ,      ;
+    // ,      ,       
+    void AddDocuments(std::execution::sequenced_policy policy, const std::vector<NewDocument>& documents);
+    void AddDocuments(std::execution::parallel_policy policy, const std::vector<NewDocument>& documents);
+
+    //     :  parallel_policy   ,
+    //     .     
+    template <typename ExecutionPolicy, typename DocumentPredicate>
+    std::vector<Document> FindTopDocuments(const ExecutionPolicy& policy, const std::string_view& raw_query, DocumentPredicate document_predicate) const;
+
+    template <typename DocumentPredicate>
+    std::vector<Document> FindTopDocuments(const std::string_view& raw_query, DocumentPredicate document_predicate) const;
+
+    template <typename ExecutionPolicy>
+    std::vector<Document> FindTopDocuments(const ExecutionPolicy& policy, const std::string_view& raw_query, DocumentStatus status) const;
+    std::vector<Document> FindTopDocuments(const std::string_view& raw_query, DocumentStatus status) const;
+
+    template <typename ExecutionPolicy>
+    std::vector<Document> FindTopDocuments(const ExecutionPolicy& policy, const std::string_view& raw_query) const;
+    std::vector<Document> FindTopDocuments(const std::string_view& raw_query) const;
+
+    //      ,   -    
+    template <typename ExecutionPolicy, typename DocumentPredicate>
+    SearchPage FindPage(const ExecutionPolicy& policy, const std::string_view& raw_query, size_t page_size, const PageCursor& cursor, DocumentPredicate document_predicate) const;
+    SearchPage FindPage(const std::string_view& raw_query, size_t page_size, const PageCursor& cursor = {}) const;
+
+    //    (page_index + 1) * page_size  
+    template <typename ExecutionPolicy, typename DocumentPredicate>
+    SearchPage FindPageAt(const ExecutionPolicy& policy, const std::string_view& raw_query, size_t page_size, size_t page_index, DocumentPredicate document_predicate) const;
+    SearchPage FindPageAt(const std::string_view& raw_query, size_t page_size, size_t page_index) const;
+
+    //   -    . string_view ,      
+    std::vector<std::string_view> GetCompletions(std::string_view prefix, size_t max_count) const;
+
+    //     
+    std::vector<QueryPlan> ExplainQuery(const std::string_view& raw_query) const;
+
+    //       .       
+    //  ,     IDF    .  AddDocuments(par)
+    // callback      
+    size_t RegisterStandingQuery(const std::string_view& raw_query, StandingQueryCallback callback);
+    void UnregisterStandingQuery(size_t query_id);
+
+    int GetDocumentCount() const;
+
+    size_t GetShardCount() const;
+
+    std::tuple<std::vector<std::string_view>, DocumentStatus> MatchDocument(const std::string_view& raw_query, int document_id) const;
+
+    std::tuple<std::vector<std::string_view>, DocumentStatus> MatchDocument(std::execution::sequenced_policy policy, const std::string_view& raw_query, int document_id) const;
+
+    std::tuple<std::vector<std::string_view>, DocumentStatus> MatchDocument(std::execution::parallel_policy policy, const std::string_view& raw_query, int document_id) const;
+
+    // id   ,  parallel_policy     
+    void MatchDocuments(std::execution::sequenced_policy policy, const std::string_view& raw_query, const std::vector<int>& document_ids, MatchedDocuments& result) const;
+
+    void MatchDocuments(std::execution::parallel_policy policy, const std::string_view& raw_query, const std::vector<int>& document_ids, MatchedDocuments& result) const;
+
+    MatchedDocuments MatchDocuments(const std::string_view& raw_query, const std::vector<int>& document_ids) const;
+
+    std::set<int>::const_iterator begin() const;
+
+    std::set<int>::const_iterator end() const;
+
+    WordFrequencies GetWordFrequencies(int document_id) const;
+
+    void RemoveDocument(int document_id);
+
+    void RemoveDocument(std::execution::sequenced_policy policy, int document_id);
+
+    void RemoveDocument(std::execution::parallel_policy policy, int document_id);
+
+    //       parallel_policy
+    void RemoveDocuments(std::execution::sequenced_policy policy, const std::vector<int>& document_ids);
+    void RemoveDocuments(std::execution::parallel_policy policy, const std::vector<int>& document_ids);
+
+    //      
+    QueryStatsSnapshot GetQueryStats() const;
+
+    void ResetQueryStats();
+
+    MemoryStats GetMemoryStats() const;
+
+private:
+    //     ,     IDF.
+    //   ,         
+    class Shards : public CollectionStatistics {
+    public:
+        std::vector<SearchServer> servers;
+
+        size_t GetDocumentCount() const override;
+        size_t GetDocumentFreq(std::string_view word) const override;
+    };
+
+    std::unique_ptr<Shards> shards_ = std::make_unique<Shards>();
+    std::set<int> document_ids_;
+    StandingQuerySet standing_queries_;
+
+    static size_t GetDefaultShardCount();
+
+    //    
+    void ConnectShards();
+
+    size_t GetShardIndex(int document_id) const;
+    const SearchServer& GetShard(int document_id) const;
+    SearchServer& GetShard(int document_id);
+
+    //  action(shard_index)   .  ,
+    //         
+    template <typename ExecutionPolicy, typename Action>
+    void ForEachShard(const ExecutionPolicy& policy, Action action) const;
+
+    //  id  ,   
+    std::vector<std::vector<int>> GroupByShard(const std::vector<int>& document_ids) const;
+
+    template <typename ExecutionPolicy>
+    void AddDocumentsToShards(const ExecutionPolicy& policy, const std::vector<NewDocument>& documents);
+
+    template <typename ExecutionPolicy>
+    void RemoveDocumentsFromShards(const ExecutionPolicy& policy, const std::vector<int>& document_ids);
+
+    template <typename ExecutionPolicy>
+    void MatchDocumentsInShards(const ExecutionPolicy& policy, const std::string_view& raw_query, const std::vector<int>& document_ids, MatchedDocuments& result) const;
+};
+
+template <typename StringContainer>
+ShardedSearchServer::ShardedSearchServer(const StringContainer& stop_words, size_t shard_count, const IndexOptions& options) {
+    if (shard_count == 0) {
+        shard_count = GetDefaultShardCount();
+    }
+    shards_->servers.reserve(shard_count);
+    for (size_t i = 0; i < shard_count; ++i) {
+        shards_->servers.emplace_back(stop_words, options);
+    }
+    ConnectShards();
+}
+
+template <typename RatingIterator>
+void ShardedSearchServer::AddDocument(int document_id, const std::string_view& document, DocumentStatus status, RatingIterator ratings_begin, RatingIterator ratings_end) {
+    SearchServer& server = GetShard(document_id);
+    server.AddDocument(document_id, document, status, ratings_begin, ratings_end);
+    server.MatchStandingQueries(standing_queries_, document_id);
+}
+
+template <typename ExecutionPolicy, typename Action>
+void ShardedSearchServer::ForEachShard(const ExecutionPolicy& policy, Action action) const {
+    const std::vector<SearchServer>& servers = shards_->servers;
+    std::vector<std::exception_ptr> errors(servers.size());
+    //       
+    const TraceContext trace_context = TraceSpan::GetCurrentContext();
+    std::for_each(policy,
+        servers.begin(), servers.end(),
+        [&](const SearchServer& server) {
+            const TraceContextScope trace_scope(trace_context);
+            const size_t shard_index = &server - servers.data();
+            try {
+                action(shard_index);
+            }
+            catch (...) {
+                errors[shard_index] = std::current_exception();
+            }
+        });
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+template <typename ExecutionPolicy, typename DocumentPredicate>
+std::vector<Document> ShardedSearchServer::FindTopDocuments(const ExecutionPolicy& policy, const std::string_view& raw_query, DocumentPredicate document_predicate) const {
+    const size_t MAX_RESULT_DOCUMENT_COUNT = 5;
+    TRACE_DURATION("ShardedSearchServer::FindTopDocuments");
+
+    std::vector<std::vector<Document>> shard_results(GetShardCount());
+    ForEachShard(policy, [&](size_t shard_index) {
+        shard_results[shard_index] = shards_->servers[shard_index].FindTopDocuments(std::execution::seq, raw_query, document_predicate);
+        });
+
+    std::vector<Document> documents;
+    for (const std::vector<Document>& shard_documents : shard_results) {
+        documents.insert(documents.end(), shard_documents.begin(), shard_documents.end());
+    }
+    const size_t count = std::min(documents.size(), MAX_RESULT_DOCUMENT_COUNT);
+    std::partial_sort(documents.begin(), documents.begin() + count, documents.end(), SearchServer::IsBetterDocument);
+    documents.resize(count);
+    return documents;
+}
+
+template <typename DocumentPredicate>
+std::vector<Document> ShardedSearchServer::FindTopDocuments(const std::string_view& raw_query, DocumentPredicate document_predicate) const {
+    return ShardedSearchServer::FindTopDocuments(std::execution::par, raw_query, document_predicate);
+}
+
+template <typename ExecutionPolicy>
+std::vector<Document> ShardedSearchServer::FindTopDocuments(const ExecutionPolicy& policy, const std::string_view& raw_query, DocumentStatus status) const {
+    return ShardedSearchServer::FindTopDocuments(policy, raw_query, DocumentStatusPredicate{ status });
+}
+
+template <typename ExecutionPolicy>
+std::vector<Document> ShardedSearchServer::FindTopDocuments(const ExecutionPolicy& policy, const std::string_view& raw_query) const {
+    return ShardedSearchServer::FindTopDocuments(policy, raw_query, DocumentStatus::ACTUAL);
+}
+
+template <typename ExecutionPolicy, typename DocumentPredicate>
+SearchPage ShardedSearchServer::FindPage(const ExecutionPolicy& policy, const std::string_view& raw_query, size_t page_size, const PageCursor& cursor, DocumentPredicate document_predicate) const {
+    TRACE_DURATION("ShardedSearchServer::FindPage");
+    std::vector<SearchPage> shard_pages(GetShardCount());
+    ForEachShard(policy, [&](size_t shard_index) {
+        shard_pages[shard_index] = shards_->servers[shard_index].FindPage(std::execution::seq, raw_query, page_size, cursor, document_predicate);
+        });
+
+    SearchPage page;
+    for (const SearchPage& shard_page : shard_pages) {
+        page.documents.insert(page.documents.end(), shard_page.documents.begin(), shard_page.documents.end());
+        page.has_more = page.has_more || shard_page.has_more;
+    }
+    if (page.documents.size() > page_size) {
+        std::partial_sort(page.documents.begin(), page.documents.begin() + page_size, page.documents.end(), SearchServer::IsBetterDocument);
+        page.documents.resize(page_size);
+        page.has_more = true;
+    }
+    else {
+        std::sort(page.documents.begin(), page.documents.end(), SearchServer::IsBetterDocument);
+    }
+
+    if (!page.documents.empty()) {
+        page.next = PageCursor(page.documents.back());
+    }
+    return page;
+}
+
+template <typename ExecutionPolicy, typename DocumentPredicate>
+SearchPage ShardedSearchServer::FindPageAt(const ExecutionPolicy& policy, const std::string_view& raw_query, size_t page_size, size_t page_index, DocumentPredicate document_predicate) const {
+    TRACE_DURATION("ShardedSearchServer::FindPageAt");
+    if (page_size == 0) {
+        throw std::invalid_argument("Page size must be positive");
+    }
+
+    const size_t page_begin = page_index * page_size;
+    const size_t page_end = page_begin + page_size;
+    std::vector<SearchPage> shard_pages(GetShardCount());
+    ForEachShard(policy, [&](size_t shard_index) {
+        shard_pages[shard_index] = shards_->servers[shard_index].FindPageAt(std::execution::seq, raw_query, page_end, 0, document_predicate);
+        });
+
+    std::vector<Document> documents;
+    bool has_more = false;
+    for (const SearchPage& shard_page : shard_pages) {
+        documents.insert(documents.end(), shard_page.documents.begin(), shard_page.documents.end());
+        has_more = has_more || shard_page.has_more;
+    }
+
+    SearchPage page;
+    if (page_begin >= documents.size()) {
+        return page;
+    }
+    has_more = has_more || documents.size() > page_end;
+    const size_t count = std::min(documents.size(), page_end);
+    std::partial_sort(documents.begin(), documents.begin() + count, documents.end(), SearchServer::IsBetterDocument);
+
+    page.documents.assign(documents.begin() + page_begin, documents.begin() + count);
+    page.has_more = has_more;
+    page.next = PageCursor(page.documents.back());
+    return page;
+}
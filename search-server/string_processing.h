@@ -7,6 +7,47 @@
 
 std::vector<std::string_view> SplitIntoWords(const std::string_view& text);
 
+//  action    ,     
+template <typename Action>
+void ForEachWord(const std::string_view& text, Action action) {
+    size_t start_position{ text.find_first_not_of(' ') }; //    
+    while (start_position != std::string_view::npos) {
+        size_t end_position = text.find_first_of(' ', start_position + 1);
+        if (end_position == std::string_view::npos) {
+            end_position = text.length();
+        }
+
+        action(text.substr(start_position, (end_position - start_position)));
+        start_position = text.find_first_not_of(' ', end_position + 1);
+    }
+}
+
+// ForEachWord,        :   ( 0-31) .
+// action  false,   .  false,    ;
+//     action  
+template <typename Action>
+bool ForEachValidWord(const std::string_view& text, Action action) {
+    const size_t length = text.length();
+    size_t position = 0;
+    while (true) {
+        while (position < length && text[position] == ' ') {
+            ++position;
+        }
+        if (position == length) {
+            return true;
+        }
+        const size_t start_position = position;
+        for (; position < length && text[position] != ' '; ++position) {
+            if (text[position] >= '\0' && text[position] < ' ') {
+                return false;
+            }
+        }
+        if (!action(text.substr(start_position, position - start_position))) {
+            return true;
+        }
+    }
+}
+
 template <typename StringContainer>
 std::set<std::string, std::less<>> MakeUniqueNonEmptyStrings(const StringContainer& strings) {
     std::set<std::string, std::less<>> non_empty_strings;
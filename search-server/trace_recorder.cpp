@@ -0,0 +1,177 @@
+#include "trace_recorder.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+
+namespace {
+
+// ,    ,  ,   TraceContextScope
+thread_local TraceContext current_context;
+
+void PrintMicroseconds(std::ostream& out, int64_t ns) {
+    //  trace-event  ,    
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%" PRId64 ".%03d", ns / 1000, static_cast<int>(ns % 1000));
+    out << buffer;
+}
+
+void PrintJsonString(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* c = text; *c != '\0'; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\';
+        }
+        out << *c;
+    }
+    out << '"';
+}
+
+}
+
+TraceRecorder& TraceRecorder::Instance() {
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+TraceRecorder::TraceRecorder()
+    : start_time_(Clock::now())
+{}
+
+void TraceRecorder::Start(uint32_t sample_every, size_t max_spans_per_thread) {
+    sample_every_.store(std::max<uint32_t>(sample_every, 1), std::memory_order_relaxed);
+    max_spans_per_thread_.store(max_spans_per_thread, std::memory_order_relaxed);
+    enabled_.store(true, std::memory_order_release);
+}
+
+void TraceRecorder::Stop() {
+    enabled_.store(false, std::memory_order_release);
+}
+
+int64_t TraceRecorder::NowNs() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_time_).count();
+}
+
+void TraceRecorder::WriteChromeTrace(std::ostream& out, int64_t from_ns, int64_t to_ns) const {
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> guard(registry_mutex_);
+        buffers = buffers_;
+    }
+
+    out << "{\"traceEvents\": [";
+    bool is_first = true;
+    for (const auto& buffer : buffers) {
+        std::lock_guard<std::mutex> guard(buffer->m);
+        for (const Span& span : buffer->spans) {
+            if (span.end_ns < from_ns || span.begin_ns >= to_ns) {
+                continue;
+            }
+            if (!is_first) {
+                out << ",\n";
+            }
+            is_first = false;
+
+            out << "{\"name\": ";
+            PrintJsonString(out, span.name);
+            out << ", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->thread_index << ", \"ts\": ";
+            PrintMicroseconds(out, span.begin_ns);
+            out << ", \"dur\": ";
+            PrintMicroseconds(out, span.end_ns - span.begin_ns);
+            out << ", \"args\": {\"id\": " << span.id << ", \"parent\": " << span.parent_id << "}}";
+        }
+    }
+    out << "], \"displayTimeUnit\": \"ns\"}";
+}
+
+void TraceRecorder::Clear() {
+    std::lock_guard<std::mutex> guard(registry_mutex_);
+    for (const auto& buffer : buffers_) {
+        std::lock_guard<std::mutex> buffer_guard(buffer->m);
+        buffer->spans.clear();
+        buffer->dropped = 0;
+    }
+}
+
+uint64_t TraceRecorder::GetDroppedSpanCount() const {
+    std::lock_guard<std::mutex> guard(registry_mutex_);
+    uint64_t dropped = 0;
+    for (const auto& buffer : buffers_) {
+        std::lock_guard<std::mutex> buffer_guard(buffer->m);
+        dropped += buffer->dropped;
+    }
+    return dropped;
+}
+
+TraceRecorder::ThreadBuffer& TraceRecorder::GetThreadBuffer() {
+    //   ,       
+    thread_local std::shared_ptr<ThreadBuffer> thread_buffer;
+    if (!thread_buffer) {
+        thread_buffer = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> guard(registry_mutex_);
+        thread_buffer->thread_index = static_cast<uint32_t>(buffers_.size());
+        buffers_.push_back(thread_buffer);
+    }
+    return *thread_buffer;
+}
+
+bool TraceRecorder::SampleRoot() {
+    const uint32_t sample_every = sample_every_.load(std::memory_order_relaxed);
+    return root_counter_.fetch_add(1, std::memory_order_relaxed) % sample_every == 0;
+}
+
+void TraceRecorder::Record(const Span& span) {
+    ThreadBuffer& buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> guard(buffer.m);
+    if (buffer.spans.size() >= max_spans_per_thread_.load(std::memory_order_relaxed)) {
+        ++buffer.dropped;
+        return;
+    }
+    buffer.spans.push_back(span);
+}
+
+TraceSpan::TraceSpan(const char* name)
+    : name_(name)
+{
+    TraceRecorder& recorder = TraceRecorder::Instance();
+    if (!recorder.IsEnabled()) {
+        return;
+    }
+
+    //      ,  -   
+    parent_ = current_context;
+    const bool is_recorded = parent_.is_inside_span ? parent_.is_recorded : recorder.SampleRoot();
+    if (is_recorded) {
+        id_ = recorder.next_span_id_.fetch_add(1, std::memory_order_relaxed);
+        begin_ns_ = recorder.NowNs();
+    }
+    current_context = { true, is_recorded, id_ };
+    is_active_ = true;
+}
+
+TraceSpan::~TraceSpan() {
+    if (!is_active_) {
+        return;
+    }
+    current_context = parent_;
+    if (id_ == 0) {
+        return;
+    }
+
+    TraceRecorder& recorder = TraceRecorder::Instance();
+    recorder.Record({ name_, begin_ns_, recorder.NowNs(), id_, parent_.span_id });
+}
+
+TraceContext TraceSpan::GetCurrentContext() {
+    return current_context;
+}
+
+TraceContextScope::TraceContextScope(const TraceContext& context)
+    : previous_(current_context)
+{
+    current_context = context;
+}
+
+TraceContextScope::~TraceContextScope() {
+    current_context = previous_;
+}
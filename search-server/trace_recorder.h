@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+//  :     id  .   - 
+//  ,          TraceContextScope
+struct TraceContext {
+    bool is_inside_span = false; // false -    
+    bool is_recorded = false;
+    uint64_t span_id = 0;        // 0,    
+};
+
+//    (span)       
+//      Chrome trace-event JSON (  chrome://tracing  Perfetto).
+//      Start, TraceSpan     .
+class TraceRecorder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Span {
+        const char* name = nullptr;
+        int64_t begin_ns = 0;
+        int64_t end_ns = 0;
+        uint64_t id = 0;
+        uint64_t parent_id = 0; // 0 -  
+    };
+
+    static TraceRecorder& Instance();
+
+    // sample_every = N -   N-       ,
+    //      ,   
+    void Start(uint32_t sample_every = 1, size_t max_spans_per_thread = 1 << 16);
+    void Stop();
+    bool IsEnabled() const {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    //      TraceRecorder,       
+    int64_t NowNs() const;
+
+    //  ,    [from_ns, to_ns); id    -  args
+    void WriteChromeTrace(std::ostream& out, int64_t from_ns = INT64_MIN, int64_t to_ns = INT64_MAX) const;
+
+    void Clear();
+
+    // - ,     
+    uint64_t GetDroppedSpanCount() const;
+
+private:
+    friend class TraceSpan;
+
+    struct ThreadBuffer {
+        std::mutex m; //       -  
+        std::vector<Span> spans;
+        uint32_t thread_index = 0;
+        uint64_t dropped = 0;
+    };
+
+    TraceRecorder();
+
+    ThreadBuffer& GetThreadBuffer();
+    // ,      
+    bool SampleRoot();
+
+    void Record(const Span& span);
+
+    const Clock::time_point start_time_;
+    std::atomic<bool> enabled_ = false;
+    std::atomic<uint32_t> sample_every_ = 1;
+    std::atomic<uint64_t> root_counter_ = 0;
+    std::atomic<uint64_t> next_span_id_ = 1;
+    std::atomic<size_t> max_spans_per_thread_ = 0;
+
+    mutable std::mutex registry_mutex_;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+};
+
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name);
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    ~TraceSpan();
+
+    //   ;    
+    static TraceContext GetCurrentContext();
+
+private:
+    const char* name_;
+    TraceContext parent_;
+    int64_t begin_ns_ = 0;
+    uint64_t id_ = 0;
+    bool is_active_ = false;
+};
+
+//  context       ,   ,
+//   TBB:      ,   context
+class TraceContextScope {
+public:
+    explicit TraceContextScope(const TraceContext& context);
+
+    TraceContextScope(const TraceContextScope&) = delete;
+    TraceContextScope& operator=(const TraceContextScope&) = delete;
+
+    ~TraceContextScope();
+
+private:
+    TraceContext previous_;
+};
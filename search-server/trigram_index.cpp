@@ -0,0 +1,112 @@
+#include "trigram_index.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+
+TrigramIndex::TrigramIndex(std::pmr::memory_resource* resource)
+    : words_by_trigram_(resource)
+{}
+
+void TrigramIndex::AddWord(std::string_view word) {
+    for (const uint32_t trigram : GetTrigrams(word)) {
+        std::pmr::vector<std::string_view>& words = words_by_trigram_[trigram];
+        const auto it = std::lower_bound(words.begin(), words.end(), word);
+        if (it == words.end() || *it != word) {
+            words.insert(it, word);
+            ++entry_count_;
+        }
+    }
+}
+
+void TrigramIndex::RemoveWord(std::string_view word) {
+    for (const uint32_t trigram : GetTrigrams(word)) {
+        const auto list_it = words_by_trigram_.find(trigram);
+        if (list_it == words_by_trigram_.end()) {
+            continue;
+        }
+        std::pmr::vector<std::string_view>& words = list_it->second;
+        const auto it = std::lower_bound(words.begin(), words.end(), word);
+        if (it != words.end() && *it == word) {
+            words.erase(it);
+            --entry_count_;
+        }
+        if (words.empty()) {
+            words_by_trigram_.erase(list_it);
+        }
+    }
+}
+
+size_t TrigramIndex::GetEntryCount() const {
+    return entry_count_;
+}
+
+std::vector<std::pair<std::string_view, int>> TrigramIndex::FindSimilarWords(std::string_view word, int max_distance) const {
+    const std::vector<uint32_t> trigrams = GetTrigrams(word);
+    const int min_shared = std::max(1, static_cast<int>(trigrams.size()) - 3 * max_distance);
+
+    // -    ,        max_distance
+    std::map<std::string_view, int> shared_counts;
+    for (const uint32_t trigram : trigrams) {
+        const auto list_it = words_by_trigram_.find(trigram);
+        if (list_it == words_by_trigram_.end()) {
+            continue;
+        }
+        for (const std::string_view candidate : list_it->second) {
+            const int length_difference = static_cast<int>(candidate.size()) - static_cast<int>(word.size());
+            if (std::abs(length_difference) <= max_distance) {
+                ++shared_counts[candidate];
+            }
+        }
+    }
+
+    std::vector<std::pair<std::string_view, int>> similar_words;
+    for (const auto& [candidate, shared] : shared_counts) {
+        if (shared < min_shared) {
+            continue;
+        }
+        const int distance = ComputeEditDistance(word, candidate, max_distance);
+        if (distance > 0 && distance <= max_distance) {
+            similar_words.emplace_back(candidate, distance);
+        }
+    }
+    return similar_words;
+}
+
+int TrigramIndex::ComputeEditDistance(std::string_view lhs, std::string_view rhs, int max_distance) {
+    std::vector<int> previous(rhs.size() + 1);
+    std::vector<int> current(rhs.size() + 1);
+    std::iota(previous.begin(), previous.end(), 0);
+
+    for (size_t i = 1; i <= lhs.size(); ++i) {
+        current[0] = static_cast<int>(i);
+        int row_min = current[0];
+        for (size_t j = 1; j <= rhs.size(); ++j) {
+            const int substitution = previous[j - 1] + (lhs[i - 1] == rhs[j - 1] ? 0 : 1);
+            current[j] = std::min({ previous[j] + 1, current[j - 1] + 1, substitution });
+            row_min = std::min(row_min, current[j]);
+        }
+        //        
+        if (row_min > max_distance) {
+            return max_distance + 1;
+        }
+        previous.swap(current);
+    }
+    return std::min(previous[rhs.size()], max_distance + 1);
+}
+
+std::vector<uint32_t> TrigramIndex::GetTrigrams(std::string_view word) {
+    const auto at = [word](size_t index) -> uint32_t {
+        // index     
+        return index == 0 || index > word.size() ? ' ' : static_cast<unsigned char>(word[index - 1]);
+    };
+
+    std::vector<uint32_t> trigrams;
+    trigrams.reserve(word.size());
+    for (size_t i = 0; i < word.size(); ++i) {
+        trigrams.push_back(at(i) << 16 | at(i + 1) << 8 | at(i + 2));
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
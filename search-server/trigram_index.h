@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory_resource>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+//      (   ,    ).
+//       ,     d  
+//      (-  - 3d) .    ,    
+class TrigramIndex {
+public:
+    explicit TrigramIndex(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // string_view  ,      
+    void AddWord(std::string_view word);
+
+    void RemoveWord(std::string_view word);
+
+    // -  (, )
+    size_t GetEntryCount() const;
+
+    //       1  max_distance  word,   
+    std::vector<std::pair<std::string_view, int>> FindSimilarWords(std::string_view word, int max_distance) const;
+
+    //  ;    max_distance,  max_distance + 1
+    static int ComputeEditDistance(std::string_view lhs, std::string_view rhs, int max_distance);
+
+private:
+    //   ,     24 
+    static std::vector<uint32_t> GetTrigrams(std::string_view word);
+
+    std::pmr::map<uint32_t, std::pmr::vector<std::string_view>> words_by_trigram_; //  
+    size_t entry_count_ = 0;
+};
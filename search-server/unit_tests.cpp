@@ -1,6 +1,27 @@
 #include "unit_tests.h"
 
 #include "search_server.h"
+#include "latency_histogram.h"
+#include "process_queries.h"
+#include "ingestion_queue.h"
+#include "write_ahead_log.h"
+#include "roaring_bitmap.h"
+#include "corpus_reader.h"
+#include "query_protocol.h"
+#include "sharded_search_server.h"
+#include "paginator.h"
+#include "request_queue.h"
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
 
 //  ,     -   
 void TestExcludeStopWordsFromAddedDocumentContent() {
@@ -55,7 +76,7 @@ void TestExcludeMinusWordsFromQuery() {
         server.AddDocument(doc_id1, content_1, DocumentStatus::ACTUAL, ratings_1);
         server.AddDocument(doc_id2, content_2, DocumentStatus::ACTUAL, ratings_2);
         const auto found_docs = server.FindTopDocuments("-in the dog"s);
-        ASSERT(found_docs.size(), 1);
+        ASSERT_EQUAL(found_docs.size(), 1u);
         const Document& doc0 = found_docs[0];
         ASSERT_EQUAL(doc0.id, doc_id2);
     }
@@ -115,7 +136,8 @@ void TestByRelevance() {
     const Document& doc3 = found_docs[2];
 
     //    
-    ASSERT(doc1.relevance > doc2.relevance > doc3.relevance);
+    ASSERT(doc1.relevance > doc2.relevance);
+    ASSERT(doc2.relevance > doc3.relevance);
 
     //     
     // idf = log(server.GetDocumentCount() * 1.0 / 1),   -  - ,   - ,    . 
@@ -135,11 +157,12 @@ void TestByRelevance() {
         + 0
         + log(server.GetDocumentCount() * 1.0 / 2) * (1.0 / 5);
 
-    double relev3 = log(server.GetDocumentCount() * 1.0 / 2) * (1.0 / 4)
-        + log(server.GetDocumentCount() * 1.0 / 2) * (1.0 / 4)
-        + log(server.GetDocumentCount() * 1.0 / 2) * (1.0 / 4)
+    //    10 , village  
+    double relev3 = log(server.GetDocumentCount() * 1.0 / 2) * (1.0 / 10)
+        + log(server.GetDocumentCount() * 1.0 / 2) * (1.0 / 10)
+        + log(server.GetDocumentCount() * 1.0 / 2) * (1.0 / 10)
         + 0
-        + log(server.GetDocumentCount() * 1.0 / 2) * (0.0 / 4);
+        + log(server.GetDocumentCount() * 1.0 / 2) * (2.0 / 10);
 
     //            
     ASSERT(abs(doc1.relevance - relev1) < epx);
@@ -271,6 +294,1563 @@ void TestSearchByStatusDocuments() {
 
 }
 
+//    RequestQueue
+void TestRequestQueue() {
+    SearchServer server;
+    server.AddDocument(1, "curly cat curly tail"s, DocumentStatus::ACTUAL, { 7, 2, 7 });
+    server.AddDocument(2, "big dog sparrow"s, DocumentStatus::ACTUAL, { 1, 2, 3 });
+
+    {
+        RequestQueue request_queue(server);
+        for (int i = 0; i < 10; ++i) {
+            request_queue.AddFindRequest("empty request"s);
+        }
+        request_queue.AddFindRequest("curly dog"s);
+        request_queue.AddFindRequest("sparrow"s, DocumentStatus::BANNED);
+        ASSERT_EQUAL(request_queue.GetNoResultRequests(), 11);
+        ASSERT_EQUAL(request_queue.GetTotalLatencyHistogram().total_count, 12u);
+        ASSERT(request_queue.GetQueriesPerSecond() > 0.0);
+        ASSERT_EQUAL(request_queue.GetEvictedRequestCount(), 0u);
+    }
+
+    //       ,     
+    {
+        RequestQueue::Options options;
+        options.shard_count = 1;
+        options.shard_capacity = 4;
+        RequestQueue request_queue(server, options);
+        for (int i = 0; i < 10; ++i) {
+            request_queue.AddFindRequest("empty request"s);
+        }
+        ASSERT_EQUAL(request_queue.GetNoResultRequests(), 4);
+        ASSERT_EQUAL(request_queue.GetEvictedRequestCount(), 6u);
+        ASSERT_EQUAL(request_queue.GetTotalLatencyHistogram().total_count, 10u);
+    }
+
+    //       
+    {
+        RequestQueue request_queue(server);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&request_queue]() {
+                for (int i = 0; i < 100; ++i) {
+                    request_queue.AddFindRequest("empty request"s);
+                }
+                });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        ASSERT_EQUAL(request_queue.GetNoResultRequests(), 400);
+    }
+
+    //      
+    {
+        RequestQueue::Options options;
+        options.window = RequestQueue::Clock::duration::zero();
+        options.hash_queries = true;
+        RequestQueue request_queue(server, options);
+        request_queue.AddFindRequest("empty request"s);
+        ASSERT_EQUAL(request_queue.GetNoResultRequests(), 0);
+        ASSERT(request_queue.GetNoResultQueryHashes().empty());
+    }
+}
+
+//       
+void TestQueryStats() {
+    SearchServer server("and with"s);
+    server.AddDocument(1, "white cat and yellow hat"s, DocumentStatus::ACTUAL, { 1, 2 });
+    server.AddDocument(2, "curly cat curly tail"s, DocumentStatus::ACTUAL, { 1, 2 });
+    server.AddDocument(3, "nasty dog with big eyes"s, DocumentStatus::ACTUAL, { 1, 2 });
+
+    server.FindTopDocuments("curly cat -hat"s);
+    server.FindTopDocuments(std::execution::par, "curly cat -hat"s);
+
+    const QueryStatsSnapshot stats = server.GetQueryStats();
+    if constexpr (QUERY_STATS_ENABLED) {
+        ASSERT_EQUAL(stats.stages[static_cast<size_t>(QueryStage::PARSE)].total_count, 2u);
+        // cat - 2 , curly - 1 
+        ASSERT_EQUAL(stats.counters[static_cast<size_t>(QueryCounter::POSTINGS_VISITED)].max_value, 3u);
+        ASSERT_EQUAL(stats.counters[static_cast<size_t>(QueryCounter::MINUS_EXCLUSIONS)].max_value, 1u);
+        ASSERT(stats.ToJson().find("\"postings_visited\""s) != std::string::npos);
+    }
+    else {
+        ASSERT_EQUAL(stats.stages[static_cast<size_t>(QueryStage::PARSE)].total_count, 0u);
+    }
+}
+
+//       Chrome trace
+void TestTraceRecorder() {
+    SearchServer server("and with"s);
+    server.AddDocument(1, "white cat and yellow hat"s, DocumentStatus::ACTUAL, { 1, 2 });
+    server.AddDocument(2, "curly cat curly tail"s, DocumentStatus::ACTUAL, { 1, 2 });
+
+    TraceRecorder& recorder = TraceRecorder::Instance();
+    recorder.Clear();
+
+    //    ,   
+    server.FindTopDocuments(std::execution::par, "curly cat -hat"s);
+    {
+        std::ostringstream out;
+        recorder.WriteChromeTrace(out);
+        ASSERT(out.str().find("FindTopDocuments"s) == std::string::npos);
+    }
+
+    recorder.Start();
+    server.FindTopDocuments(std::execution::par, "curly cat -hat"s);
+    recorder.Stop();
+    {
+        std::ostringstream out;
+        recorder.WriteChromeTrace(out);
+        const std::string trace = out.str();
+        ASSERT(trace.find("{\"traceEvents\": ["s) == 0);
+        ASSERT(trace.find("\"name\": \"FindTopDocuments\", \"ph\": \"X\""s) != std::string::npos);
+        ASSERT(trace.find("FindAllDocuments(par) plus word"s) != std::string::npos);
+    }
+
+    //        ,     TBB
+    const auto parse_spans = [&recorder]() {
+        std::ostringstream out;
+        recorder.WriteChromeTrace(out);
+        const std::string trace = out.str();
+        std::map<uint64_t, std::pair<std::string, uint64_t>> spans; // id -> {, id }
+        for (size_t pos = trace.find("{\"name\": \""s); pos != std::string::npos; pos = trace.find("{\"name\": \""s, pos + 1)) {
+            const size_t name_begin = pos + 10;
+            const std::string name = trace.substr(name_begin, trace.find('"', name_begin) - name_begin);
+            const uint64_t id = std::stoull(trace.substr(trace.find("\"id\": "s, pos) + 6));
+            const uint64_t parent_id = std::stoull(trace.substr(trace.find("\"parent\": "s, pos) + 10));
+            spans[id] = { name, parent_id };
+        }
+        return spans;
+    };
+    {
+        const auto spans = parse_spans();
+        size_t plus_word_count = 0;
+        for (const auto& [id, span] : spans) {
+            if (span.first == "FindAllDocuments(par) plus word"s) {
+                ++plus_word_count;
+                ASSERT(spans.count(span.second) != 0);
+                ASSERT_EQUAL(spans.at(span.second).first, "FindTopDocuments"s);
+            }
+        }
+        ASSERT(plus_word_count > 0);
+    }
+
+    //           
+    recorder.Clear();
+    recorder.Start(2);
+    for (int i = 0; i < 4; ++i) {
+        server.FindTopDocuments(std::execution::par, "curly cat -hat"s);
+    }
+    recorder.Stop();
+    {
+        const auto spans = parse_spans();
+        size_t root_count = 0;
+        for (const auto& [id, span] : spans) {
+            if (span.second == 0) {
+                ++root_count;
+                ASSERT_EQUAL(span.first, "FindTopDocuments"s);
+            }
+            else {
+                ASSERT(spans.count(span.second) != 0);
+            }
+        }
+        ASSERT_EQUAL(root_count, 2u);
+    }
+
+    // ,       
+    {
+        std::ostringstream out;
+        recorder.WriteChromeTrace(out, recorder.NowNs(), recorder.NowNs() + 1);
+        ASSERT(out.str().find("FindTopDocuments"s) == std::string::npos);
+    }
+    recorder.Clear();
+}
+
+//    FindPage  Paginate
+void TestFindPage() {
+    SearchServer server("and with"s);
+    for (int id = 0; id < 23; ++id) {
+        server.AddDocument(id, "cat number "s + std::to_string(id % 7) + (id % 3 == 0 ? " cat"s : ""s), DocumentStatus::ACTUAL, { id % 5 });
+    }
+    server.AddDocument(100, "dog"s, DocumentStatus::ACTUAL, { 1 });
+
+    //     FindTopDocuments
+    {
+        const std::vector<Document> top = server.FindTopDocuments("cat"s);
+        const SearchPage page = server.FindPage("cat"s, top.size());
+        ASSERT_EQUAL(page.documents.size(), top.size());
+        for (size_t i = 0; i < top.size(); ++i) {
+            ASSERT_EQUAL(page.documents[i].id, top[i].id);
+        }
+        ASSERT(page.has_more);
+    }
+
+    //               
+    {
+        std::vector<int> by_cursor;
+        PageCursor cursor;
+        bool has_more = true;
+        while (has_more) {
+            const SearchPage page = server.FindPage("cat"s, 4, cursor);
+            for (const Document& document : page.documents) {
+                by_cursor.push_back(document.id);
+            }
+            cursor = page.next;
+            has_more = page.has_more;
+        }
+        ASSERT_EQUAL(by_cursor.size(), 23u);
+
+        std::vector<int> by_index;
+        for (size_t page_index = 0; page_index < 6; ++page_index) {
+            for (const Document& document : server.FindPageAt("cat"s, 4, page_index).documents) {
+                by_index.push_back(document.id);
+            }
+        }
+        ASSERT(by_cursor == by_index);
+        ASSERT(server.FindPageAt("cat"s, 4, 6).documents.empty());
+    }
+
+    // ,    ,      
+    {
+        ASSERT(PageCursor::Parse(PageCursor().Serialize()).IsSet() == false);
+
+        const SearchPage first_page = server.FindPage("cat"s, 4, PageCursor());
+        const std::string saved_cursor = first_page.next.Serialize();
+        ASSERT(!saved_cursor.empty());
+        const SearchPage expected_page = server.FindPage("cat"s, 4, first_page.next);
+        const SearchPage restored_page = server.FindPage("cat"s, 4, PageCursor::Parse(saved_cursor));
+        ASSERT_EQUAL(restored_page.documents.size(), expected_page.documents.size());
+        for (size_t i = 0; i < expected_page.documents.size(); ++i) {
+            ASSERT_EQUAL(restored_page.documents[i].id, expected_page.documents[i].id);
+        }
+        ASSERT_EQUAL(restored_page.next.Serialize(), expected_page.next.Serialize());
+
+        for (const std::string& text : { "abc"s, "1:2"s, "1:2:3x"s, ":2:3"s }) {
+            try {
+                PageCursor::Parse(text);
+                ASSERT_HINT(false, "Cursor "s + text + " must be rejected"s);
+            }
+            catch (const std::invalid_argument&) {
+            }
+        }
+    }
+
+    //  Paginate    
+    {
+        const std::vector<int> items = { 1, 2, 3, 4, 5, 6, 7 };
+        const auto pages = Paginate(items, 3);
+        ASSERT_EQUAL(pages.size(), 3u);
+        std::vector<size_t> page_sizes;
+        for (const auto& page : pages) {
+            page_sizes.push_back(page.size());
+        }
+        ASSERT((page_sizes == std::vector<size_t>{ 3, 3, 1 }));
+    }
+}
+
+//      
+void TestMatchDocuments() {
+    SearchServer server("and with"s);
+    server.AddDocument(1, "white cat and yellow hat"s, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(2, "curly cat curly tail"s, DocumentStatus::BANNED, { 1 });
+    server.AddDocument(3, "nasty dog with big eyes"s, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(4, "nasty pigeon john"s, DocumentStatus::IRRELEVANT, { 1 });
+
+    const std::string query = "curly nasty cat -john cat"s;
+    const std::vector<int> ids = { 4, 1, 2, 3 };
+
+    MatchedDocuments par_result;
+    server.MatchDocuments(std::execution::par, query, ids, par_result);
+    const MatchedDocuments seq_result = server.MatchDocuments(query, ids);
+    const MatchedDocuments& par_view = par_result;
+
+    for (const MatchedDocuments* result : { &seq_result, &par_view }) {
+        ASSERT_EQUAL(result->size(), ids.size());
+        for (size_t i = 0; i < ids.size(); ++i) {
+            const auto [words, status] = server.MatchDocument(query, ids[i]);
+            const auto range = result->GetWords(i);
+            ASSERT((std::vector<std::string_view>(range.begin(), range.end()) == words));
+            ASSERT(result->GetStatus(i) == status);
+        }
+    }
+    ASSERT_EQUAL(seq_result.GetWords(0).size(), 0u);
+    ASSERT_EQUAL(seq_result.GetWords(2).size(), 2u);
+
+    //    
+    server.MatchDocuments(std::execution::par, "dog"s, { 3 }, par_result);
+    ASSERT_EQUAL(par_result.size(), 1u);
+    ASSERT_EQUAL(*par_result.GetWords(0).begin(), "dog"s);
+
+    //  id   ,    
+    for (const bool is_parallel : { false, true }) {
+        try {
+            if (is_parallel) {
+                server.MatchDocuments(std::execution::par, query, { 1, 42, 3 }, par_result);
+            }
+            else {
+                server.MatchDocuments(std::execution::seq, query, { 1, 42, 3 }, par_result);
+            }
+            ASSERT_HINT(false, "Unknown document id must be rejected"s);
+        }
+        catch (const std::out_of_range&) {}
+        ASSERT_EQUAL(par_result.size(), 1u);
+    }
+}
+
+//      (+)
+void TestRequiredWords() {
+    SearchServer server("and with"s);
+    server.AddDocument(1, "white cat and yellow hat"s, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(2, "curly cat curly tail"s, DocumentStatus::ACTUAL, { 2 });
+    server.AddDocument(3, "nasty dog with curly tail"s, DocumentStatus::ACTUAL, { 3 });
+    server.AddDocument(4, "curly cat and nasty dog"s, DocumentStatus::ACTUAL, { 4 });
+
+    //  "+"      
+    ASSERT_EQUAL(server.FindTopDocuments("curly cat"s).size(), 4u);
+
+    //      ,     -
+    {
+        const std::vector<Document> found = server.FindTopDocuments("+curly +cat tail"s);
+        ASSERT_EQUAL(found.size(), 2u);
+        ASSERT_EQUAL(found[0].id, 2);
+        ASSERT_EQUAL(found[1].id, 4);
+
+        const std::vector<Document> found_par = server.FindTopDocuments(std::execution::par, "+curly +cat tail"s);
+        ASSERT_EQUAL(found_par.size(), 2u);
+        ASSERT(std::abs(found_par[0].relevance - found[0].relevance) < 1e-6);
+
+        //   ,    "+"
+        const std::vector<Document> found_or = server.FindTopDocuments("curly cat tail"s);
+        ASSERT(std::abs(found_or[0].relevance - found[0].relevance) < 1e-6);
+    }
+
+    ASSERT_EQUAL(server.FindTopDocuments("+curly +cat -nasty"s).size(), 1u);
+    ASSERT(server.FindTopDocuments("+curly +parrot"s).empty());
+
+    {
+        const auto [words, status] = server.MatchDocument("+curly cat"s, 1);
+        ASSERT(words.empty());
+        const auto [words_par, status_par] = server.MatchDocument(std::execution::par, "+curly cat"s, 2);
+        ASSERT_EQUAL(words_par.size(), 2u);
+        ASSERT_EQUAL(server.MatchDocuments("+curly cat"s, { 1, 2 }).GetWords(0).size(), 0u);
+    }
+
+    //  
+    for (const std::string& query : { "+"s, "cat +"s, "++cat"s, "+-cat"s, "-+cat"s }) {
+        try {
+            server.FindTopDocuments(query);
+            ASSERT_HINT(false, "Query "s + query + " must be rejected"s);
+        }
+        catch (const std::invalid_argument&) {
+        }
+    }
+}
+
+//         
+void TestQueryPlanner() {
+    const std::vector<std::string> texts = {
+        "white cat and yellow hat"s, "curly cat curly tail"s, "nasty dog with curly tail"s,
+        "curly cat and nasty dog"s, "yellow dog and white tail"s };
+    const std::vector<std::string> queries = {
+        "curly cat"s, "curly -nasty tail"s, "yellow"s, "curly dog -white"s, "parrot"s, "and"s, "and -cat"s };
+
+    //  id -  ,  -      
+    SearchServer dense_server(""s);
+    SearchServer sparse_server(""s);
+    for (size_t i = 0; i < texts.size(); ++i) {
+        dense_server.AddDocument(static_cast<int>(i), texts[i], DocumentStatus::ACTUAL, { static_cast<int>(i) });
+        sparse_server.AddDocument(static_cast<int>(i * 1000), texts[i], DocumentStatus::ACTUAL, { static_cast<int>(i) });
+    }
+    ASSERT(dense_server.ExplainQuery("curly cat"s).strategy == QueryStrategy::BITMAP);
+    ASSERT(sparse_server.ExplainQuery("curly cat"s).strategy == QueryStrategy::DOCUMENT_AT_A_TIME);
+    ASSERT(sparse_server.ExplainQuery("yellow"s).strategy == QueryStrategy::TERM_AT_A_TIME);
+    ASSERT(sparse_server.ExplainQuery("+curly cat"s).strategy == QueryStrategy::CONJUNCTIVE);
+
+    //      ,      
+    {
+        const QueryPlan plan = dense_server.ExplainQuery("curly parrot hat"s);
+        ASSERT_EQUAL(plan.plus_terms.size(), 2u);
+        ASSERT_EQUAL(plan.plus_terms[0].word, "hat"s);
+        ASSERT_EQUAL(plan.plus_terms[1].word, "curly"s);
+        ASSERT_EQUAL(plan.dropped_words.size(), 1u);
+        ASSERT(plan.matches_all_documents == false);
+    }
+    {
+        const QueryPlan plan = sparse_server.ExplainQuery("tail dog"s);
+        ASSERT_EQUAL(plan.plus_terms.size(), 2u);
+        ASSERT(plan.matches_all_documents == false);
+    }
+
+    //     ,    
+    for (const std::string& query : queries) {
+        const std::vector<Document> dense_found = dense_server.FindTopDocuments(query);
+        const std::vector<Document> sparse_found = sparse_server.FindTopDocuments(query);
+        const std::vector<Document> par_found = sparse_server.FindTopDocuments(std::execution::par, query);
+        ASSERT_EQUAL_HINT(dense_found.size(), sparse_found.size(), query);
+        ASSERT_EQUAL_HINT(par_found.size(), sparse_found.size(), query);
+        for (size_t i = 0; i < dense_found.size(); ++i) {
+            ASSERT_EQUAL_HINT(dense_found[i].id * 1000, sparse_found[i].id, query);
+            ASSERT_EQUAL_HINT(par_found[i].id, sparse_found[i].id, query);
+            ASSERT_HINT(std::abs(dense_found[i].relevance - sparse_found[i].relevance) < 1e-6, query);
+        }
+    }
+
+    //     : IDF = 0,     
+    SearchServer server(""s);
+    server.AddDocument(1, "cat in the city"s, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(2, "dog in the city"s, DocumentStatus::ACTUAL, { 2 });
+    ASSERT(server.ExplainQuery("city"s).matches_all_documents);
+    ASSERT_EQUAL(server.FindTopDocuments("city"s).size(), 2u);
+    ASSERT_EQUAL(server.FindTopDocuments("city -dog"s).size(), 1u);
+    ASSERT_EQUAL(server.FindTopDocuments(std::execution::par, "city -dog"s).size(), 1u);
+}
+
+//        
+void TestPhraseQueries() {
+    IndexOptions options;
+    options.store_positions = true;
+    SearchServer server("and with in the"s, options);
+    server.AddDocument(1, "curly cat and curly tail"s, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(2, "cat with curly tail"s, DocumentStatus::ACTUAL, { 2 });
+    server.AddDocument(3, "curly tail of a big cat"s, DocumentStatus::ACTUAL, { 3 });
+    server.AddDocument(4, "cat in the city"s, DocumentStatus::ACTUAL, { 4 });
+
+    const auto found_ids = [&server](const std::string& query) {
+        std::vector<int> ids;
+        for (const Document& document : server.FindTopDocuments(query)) {
+            ids.push_back(document.id);
+        }
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    };
+
+    //  :      
+    ASSERT(found_ids("\"curly tail\""s) == std::vector<int>({ 1, 2, 3 }));
+    ASSERT(found_ids("\"curly cat\""s) == std::vector<int>({ 1 }));
+    ASSERT(found_ids("\"cat curly\""s) == std::vector<int>({}));
+    // -    
+    ASSERT(found_ids("\"cat in the city\""s) == std::vector<int>({ 4 }));
+    ASSERT(found_ids("\"cat city\""s) == std::vector<int>({}));
+    // -  ,    -    
+    ASSERT(found_ids("\"cat with curly\""s) == std::vector<int>({ 1, 2 }));
+
+    //  :      N  
+    ASSERT(found_ids("\"cat tail\"~2"s) == std::vector<int>({ 1, 2 }));
+    ASSERT(found_ids("\"cat tail\"~1"s) == std::vector<int>({}));
+    ASSERT(found_ids("\"tail cat\"~3"s) == std::vector<int>({ 3 }));
+
+    //      -
+    ASSERT(found_ids("\"curly tail\" -big"s) == std::vector<int>({ 1, 2 }));
+    ASSERT_EQUAL(server.FindTopDocuments(std::execution::par, "\"curly cat\" city"s).size(), 1u);
+    {
+        const auto [words, status] = server.MatchDocument("\"curly cat\""s, 2);
+        ASSERT(words.empty());
+        const auto [words_par, status_par] = server.MatchDocument(std::execution::par, "\"curly cat\""s, 1);
+        ASSERT_EQUAL(words_par.size(), 2u);
+        const MatchedDocuments matched = server.MatchDocuments("\"curly cat\""s, { 1, 2 });
+        ASSERT_EQUAL(matched.GetWords(0).size(), 2u);
+        ASSERT_EQUAL(matched.GetWords(1).size(), 0u);
+    }
+
+    //       
+    server.RemoveDocument(1);
+    ASSERT(found_ids("\"curly cat\""s) == std::vector<int>({}));
+
+    for (const std::string& query : { "\"curly cat"s, "\"curly -cat\""s, "\"curly cat\"~"s, "\"curly cat\"x"s }) {
+        try {
+            server.FindTopDocuments(query);
+            ASSERT_HINT(false, query);
+        }
+        catch (const std::invalid_argument&) {
+        }
+    }
+
+    //     
+    SearchServer plain_server("and"s);
+    plain_server.AddDocument(1, "curly cat"s, DocumentStatus::ACTUAL, { 1 });
+    try {
+        plain_server.FindTopDocuments("\"curly cat\""s);
+        ASSERT(false);
+    }
+    catch (const std::invalid_argument&) {
+    }
+    ASSERT(plain_server.TryFindTopDocuments("cat \"curly tail\"~2"s).GetError() == SearchError::PHRASES_NOT_INDEXED);
+
+    //     ,   ,    
+    plain_server.AddDocument(2, "\"quoted cat"s, DocumentStatus::ACTUAL, { 2 });
+    const std::vector<Document> quoted = plain_server.FindTopDocuments("\"quoted"s);
+    ASSERT_EQUAL(quoted.size(), 1u);
+    ASSERT_EQUAL(quoted[0].id, 2);
+    ASSERT_EQUAL(plain_server.FindTopDocuments("tail\" cat"s).size(), 2u);
+}
+
+//    *    
+void TestPrefixQueries() {
+    IndexOptions options;
+    options.max_prefix_expansions = 2;
+    SearchServer server("and"s, options);
+    server.AddDocument(1, "cat and catalog"s, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(2, "catalog of cats"s, DocumentStatus::ACTUAL, { 2 });
+    server.AddDocument(3, "category theory"s, DocumentStatus::ACTUAL, { 3 });
+    server.AddDocument(4, "dog and cat"s, DocumentStatus::ACTUAL, { 4 });
+
+    //     : cat, catalog
+    {
+        const QueryPlan plan = server.ExplainQuery("cat*"s);
+        ASSERT_EQUAL(plan.plus_terms.size(), 2u);
+        ASSERT_EQUAL(server.FindTopDocuments("cat*"s).size(), 3u);
+        ASSERT_EQUAL(server.FindTopDocuments(std::execution::par, "cat*"s).size(), 3u);
+    }
+    ASSERT_EQUAL(server.FindTopDocuments("catalog*"s).size(), 2u);
+    ASSERT_EQUAL(server.FindTopDocuments("categ*"s).size(), 1u);
+    ASSERT(server.FindTopDocuments("bird*"s).empty());
+    ASSERT_EQUAL(server.FindTopDocuments("cat -dog*"s).size(), 1u);
+    // -   : cat, catalog, category  cats
+    ASSERT(server.FindTopDocuments("theory of dog -cat*"s).empty());
+    ASSERT(server.FindTopDocuments(std::execution::par, "theory of dog -cat*"s).empty());
+    ASSERT_EQUAL(server.ExplainQuery("theory -cat*"s).minus_terms.size(), 4u);
+    {
+        const auto [words, status] = server.MatchDocument("categ* dog"s, 3);
+        ASSERT_EQUAL(words.size(), 1u);
+        ASSERT_EQUAL(words[0], "category"s);
+    }
+
+    for (const std::string& query : { "*"s, "-*"s, "+cat*"s }) {
+        try {
+            server.FindTopDocuments(query);
+            ASSERT_HINT(false, query);
+        }
+        catch (const std::invalid_argument&) {
+        }
+    }
+
+    // :    ,    -  
+    const std::vector<std::string_view> completions = server.GetCompletions("cat"s, 3);
+    ASSERT_EQUAL(completions.size(), 3u);
+    ASSERT_EQUAL(completions[0], "cat"s);
+    ASSERT_EQUAL(completions[1], "catalog"s);
+    ASSERT_EQUAL(completions[2], "category"s);
+    ASSERT_EQUAL(server.GetCompletions("cat"s, 10).size(), 4u);
+    ASSERT(server.GetCompletions("x"s, 10).empty());
+}
+
+//      
+void TestTypoTolerance() {
+    IndexOptions options;
+    options.max_typo_distance = 2;
+    options.typo_penalty = 0.5;
+    SearchServer server("and"s, options);
+    server.AddDocument(1, "white cat and yellow hat"s, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(2, "curly dog and fancy collar"s, DocumentStatus::ACTUAL, { 2 });
+    server.AddDocument(3, "nasty parrot"s, DocumentStatus::ACTUAL, { 3 });
+
+    ASSERT_EQUAL(TrigramIndex::ComputeEditDistance("parrot"s, "parot"s, 2), 1);
+    ASSERT_EQUAL(TrigramIndex::ComputeEditDistance("parrot"s, "carrots"s, 2), 2);
+    ASSERT_EQUAL(TrigramIndex::ComputeEditDistance("parrot"s, "dog"s, 2), 3);
+
+    //     ,    
+    {
+        const std::vector<Document> exact = server.FindTopDocuments("parrot"s);
+        const std::vector<Document> one_typo = server.FindTopDocuments("parot"s);
+        const std::vector<Document> two_typos = server.FindTopDocuments("porot"s);
+        ASSERT_EQUAL(one_typo.size(), 1u);
+        ASSERT_EQUAL(one_typo[0].id, 3);
+        ASSERT_EQUAL(two_typos.size(), 1u);
+        ASSERT(std::abs(one_typo[0].relevance - exact[0].relevance * 0.5) < 1e-6);
+        ASSERT(std::abs(two_typos[0].relevance - exact[0].relevance * 0.25) < 1e-6);
+        ASSERT_EQUAL(server.FindTopDocuments(std::execution::par, "parot"s).size(), 1u);
+    }
+    ASSERT(server.FindTopDocuments("elephant"s).empty());
+    ASSERT_EQUAL(server.FindTopDocuments("colar -dgo"s).size(), 1u);
+    {
+        const auto [words, status] = server.MatchDocument("fancy colar"s, 2);
+        ASSERT_EQUAL(words.size(), 2u);
+    }
+    {
+        const QueryPlan plan = server.ExplainQuery("yelow"s);
+        ASSERT_EQUAL(plan.plus_terms.size(), 1u);
+        ASSERT_EQUAL(plan.plus_terms[0].word, "yellow"s);
+        ASSERT(std::abs(plan.plus_terms[0].weight - 0.5) < 1e-6);
+    }
+
+    //     
+    server.RemoveDocument(std::execution::par, 3);
+    ASSERT(server.FindTopDocuments("parot"s).empty());
+    server.RemoveDocument(2);
+    ASSERT(server.FindTopDocuments("colar"s).empty());
+
+    //     
+    SearchServer plain_server("and"s);
+    plain_server.AddDocument(1, "nasty parrot"s, DocumentStatus::ACTUAL, { 1 });
+    ASSERT(plain_server.FindTopDocuments("parot"s).empty());
+}
+
+//    
+void TestScratchArena() {
+    {
+        ScratchArena arena(64);
+        void* first = arena.allocate(16, 8);
+        void* aligned = arena.allocate(8, 64);
+        ASSERT_EQUAL(reinterpret_cast<uintptr_t>(aligned) % 64, 0u);
+        //      -  
+        ASSERT(arena.allocate(1000, 8) != nullptr);
+        ASSERT(arena.GetCapacity() > 64);
+
+        //    ,     
+        const size_t capacity = arena.GetCapacity();
+        arena.Reset();
+        ASSERT_EQUAL(arena.GetCapacity(), capacity);
+        void* after_reset = arena.allocate(16, 8);
+        ASSERT(arena.allocate(1000, 8) != nullptr);
+        ASSERT_EQUAL(arena.GetCapacity(), capacity);
+        ASSERT(after_reset != nullptr && first != nullptr);
+    }
+
+    //      ,    
+    {
+        ScratchArena arena(64, 1024);
+        ASSERT(arena.allocate(100000, 8) != nullptr);
+        ASSERT(arena.GetCapacity() > 100000);
+        arena.Reset();
+        ASSERT_EQUAL(arena.GetCapacity(), 1024u);
+        ASSERT(arena.allocate(512, 8) != nullptr);
+        ASSERT_EQUAL(arena.GetCapacity(), 1024u);
+        arena.Reset();
+        ASSERT_EQUAL(arena.GetCapacity(), 1024u);
+    }
+
+    //      ,      
+    ASSERT(QueryScratch::GetResource() == std::pmr::new_delete_resource());
+    {
+        const QueryScratch outer;
+        std::pmr::vector<int> outer_values({ 1, 2, 3 }, QueryScratch::GetResource());
+        ASSERT(QueryScratch::GetResource() != std::pmr::new_delete_resource());
+        {
+            const QueryScratch inner;
+            std::pmr::vector<int> inner_values(100, 7, QueryScratch::GetResource());
+        }
+        ASSERT_EQUAL(outer_values[2], 3);
+    }
+    ASSERT(QueryScratch::GetResource() == std::pmr::new_delete_resource());
+
+    //      ,    
+    SearchServer server("and"s);
+    server.AddDocument(1, "white cat and yellow hat"s, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(2, "curly cat curly tail"s, DocumentStatus::ACTUAL, { 2 });
+    for (int i = 0; i < 3; ++i) {
+        const std::vector<Document> found = server.FindTopDocuments("curly cat -hat"s);
+        ASSERT_EQUAL(found.size(), 1u);
+        ASSERT_EQUAL(found[0].id, 2);
+    }
+    ASSERT_EQUAL(server.GetWordFrequencies(2).size(), 3u);
+}
+
+//     
+void TestMemoryStats() {
+    IndexOptions options;
+    options.store_positions = true;
+    options.max_typo_distance = 1;
+    SearchServer server("and in"s, options);
+    const MemoryStats empty = server.GetMemoryStats();
+    ASSERT_EQUAL(empty[MemoryStructure::STOP_WORDS].entries, 2u);
+    ASSERT(empty[MemoryStructure::STOP_WORDS].bytes > 0);
+    ASSERT_EQUAL(empty[MemoryStructure::INVERTED_POSTINGS].bytes, 0u);
+
+    server.AddDocument(1, "white cat and yellow hat"s, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(2, "curly cat curly tail"s, DocumentStatus::ACTUAL, { 2 });
+    const MemoryStats full = server.GetMemoryStats();
+    ASSERT_EQUAL(full[MemoryStructure::TERM_DICTIONARY].entries, 6u);
+    ASSERT_EQUAL(full[MemoryStructure::INVERTED_POSTINGS].entries, 7u);
+    ASSERT_EQUAL(full[MemoryStructure::FORWARD_INDEX].entries, 7u);
+    ASSERT_EQUAL(full[MemoryStructure::DOCUMENT_METADATA].entries, 2u);
+    ASSERT_EQUAL(full[MemoryStructure::POSITIONS].entries, 8u);
+    ASSERT(full[MemoryStructure::TRIGRAMS].entries > 0);
+    for (size_t i = 0; i < full.structures.size(); ++i) {
+        const MemoryStructure structure = static_cast<MemoryStructure>(i);
+        //           
+        if (structure != MemoryStructure::IMPACTS && structure != MemoryStructure::TERM_BITMAPS) {
+            ASSERT(full.structures[i].bytes > 0);
+        }
+    }
+    ASSERT(full.reserved_bytes >= full.used_bytes - full[MemoryStructure::STOP_WORDS].bytes);
+    ASSERT(full.fragmentation >= 0.0 && full.fragmentation < 1.0);
+
+    //           ,  
+    server.RemoveDocument(1);
+    server.RemoveDocument(std::execution::par, 2);
+    const MemoryStats removed = server.GetMemoryStats();
+    ASSERT_EQUAL(removed[MemoryStructure::TERM_DICTIONARY].entries, 0u);
+    ASSERT_EQUAL(removed[MemoryStructure::INVERTED_POSTINGS].entries, 0u);
+    ASSERT_EQUAL(removed[MemoryStructure::POSITIONS].entries, 0u);
+    ASSERT_EQUAL(removed[MemoryStructure::TRIGRAMS].entries, 0u);
+    ASSERT_EQUAL(removed.used_bytes, removed[MemoryStructure::STOP_WORDS].bytes);
+    ASSERT(removed.ToJson().find("\"inverted_postings\": {\"bytes\": 0, \"entries\": 0}") != std::string::npos);
+}
+
+//     ,    
+void TestShardedSearchServer() {
+    const std::vector<std::string> texts = {
+        "white cat and fashionable collar"s,
+        "fluffy cat fluffy tail"s,
+        "groomed dog expressive eyes"s,
+        "groomed starling evgeny"s,
+        "white dog and black collar"s,
+        "curly cat curly tail"s,
+        "fluffy dog with white tail"s,
+        "big cat and small dog"s,
+    };
+    SearchServer server("and with"s);
+    ShardedSearchServer sharded("and with"s, 3);
+    ASSERT_EQUAL(sharded.GetShardCount(), 3u);
+    std::vector<NewDocument> batch;
+    for (int id = 0; id < static_cast<int>(texts.size()); ++id) {
+        const DocumentStatus status = id % 4 == 3 ? DocumentStatus::BANNED : DocumentStatus::ACTUAL;
+        server.AddDocument(id, texts[id], status, { id });
+        batch.push_back({ id, texts[id], status, { id } });
+    }
+    sharded.AddDocuments(std::execution::par, batch);
+    ASSERT_EQUAL(sharded.GetDocumentCount(), server.GetDocumentCount());
+    ASSERT(std::vector<int>(sharded.begin(), sharded.end()) == std::vector<int>(server.begin(), server.end()));
+    ASSERT(sharded.GetWordFrequencies(5) == server.GetWordFrequencies(5));
+
+    // IDF    ,      
+    const auto assert_same_results = [&](const std::vector<Document>& expected, const std::vector<Document>& actual) {
+        ASSERT_EQUAL(actual.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_EQUAL(actual[i].id, expected[i].id);
+            ASSERT(std::abs(actual[i].relevance - expected[i].relevance) < 1e-6);
+        }
+    };
+    for (const std::string& query : { "fluffy cat"s, "white dog -collar"s, "groomed tail"s, "+cat +tail"s, "cat"s }) {
+        assert_same_results(server.FindTopDocuments(query), sharded.FindTopDocuments(query));
+        assert_same_results(server.FindTopDocuments(query), sharded.FindTopDocuments(std::execution::seq, query));
+        assert_same_results(server.FindTopDocuments(query, DocumentStatus::BANNED), sharded.FindTopDocuments(query, DocumentStatus::BANNED));
+        assert_same_results(server.FindPageAt(query, 2, 1).documents, sharded.FindPageAt(query, 2, 1).documents);
+
+        //           
+        std::vector<Document> expected_pages;
+        std::vector<Document> actual_pages;
+        PageCursor expected_cursor;
+        PageCursor actual_cursor;
+        for (int page = 0; page < 4; ++page) {
+            const SearchPage expected_page = server.FindPage(query, 2, expected_cursor);
+            const SearchPage actual_page = sharded.FindPage(query, 2, actual_cursor);
+            ASSERT_EQUAL(actual_page.has_more, expected_page.has_more);
+            expected_pages.insert(expected_pages.end(), expected_page.documents.begin(), expected_page.documents.end());
+            actual_pages.insert(actual_pages.end(), actual_page.documents.begin(), actual_page.documents.end());
+            expected_cursor = expected_page.next;
+            actual_cursor = actual_page.next;
+        }
+        assert_same_results(expected_pages, actual_pages);
+    }
+
+    ASSERT(sharded.GetCompletions("c"s, 3) == server.GetCompletions("c"s, 3));
+    const std::vector<int> ids = { 7, 0, 5, 2 };
+    const MatchedDocuments expected_matches = server.MatchDocuments("white cat -black"s, ids);
+    MatchedDocuments matches;
+    sharded.MatchDocuments(std::execution::par, "white cat -black"s, ids, matches);
+    ASSERT_EQUAL(matches.size(), ids.size());
+    for (size_t i = 0; i < ids.size(); ++i) {
+        ASSERT(std::vector<std::string_view>(matches.GetWords(i).begin(), matches.GetWords(i).end())
+            == std::vector<std::string_view>(expected_matches.GetWords(i).begin(), expected_matches.GetWords(i).end()));
+    }
+
+    //  id  :   ,    
+    try {
+        sharded.AddDocuments(std::execution::par, { { 20, "dog"s, DocumentStatus::ACTUAL, { 1 } }, { 3, "cat"s, DocumentStatus::ACTUAL, { 1 } } });
+        ASSERT_HINT(false, "Duplicate id in the batch must throw"s);
+    }
+    catch (const std::invalid_argument&) {
+    }
+    ASSERT_EQUAL(sharded.GetDocumentCount(), 9);
+    sharded.RemoveDocument(20);
+
+    sharded.RemoveDocuments(std::execution::par, { 1, 6 });
+    server.RemoveDocument(1);
+    server.RemoveDocument(6);
+    ASSERT(std::vector<int>(sharded.begin(), sharded.end()) == std::vector<int>(server.begin(), server.end()));
+    assert_same_results(server.FindTopDocuments("fluffy tail"s), sharded.FindTopDocuments("fluffy tail"s));
+}
+
+//    
+void TestQueryProtocol() {
+    // ,   ,   
+    std::string_view input = "curly cat\r\nwhite -dog\nfluf"sv;
+    std::string_view line;
+    ASSERT(ExtractLine(input, line));
+    ASSERT_EQUAL(line, "curly cat"sv);
+    ASSERT(ExtractLine(input, line));
+    ASSERT_EQUAL(line, "white -dog"sv);
+    ASSERT(!ExtractLine(input, line));
+    ASSERT_EQUAL(input, "fluf"sv);
+
+    std::string output;
+    AppendResponse(output, { { 3, 0.25, 5 }, { 1, 0.125, -2 } });
+    AppendResponse(output, {});
+    AppendErrorResponse(output, "Invalid\nquery"sv);
+    ASSERT_EQUAL(output, "OK 2 3 0.25 5 1 0.125 -2\nOK 0\nERR Invalid query\n"s);
+
+    std::string_view responses = output;
+    std::vector<Document> documents;
+    ASSERT(ExtractLine(responses, line));
+    ASSERT(ParseResponse(line, documents));
+    ASSERT_EQUAL(documents.size(), 2u);
+    ASSERT_EQUAL(documents[1].id, 1);
+    ASSERT_EQUAL(documents[1].relevance, 0.125);
+    ASSERT_EQUAL(documents[1].rating, -2);
+    ASSERT(ExtractLine(responses, line));
+    ASSERT(ParseResponse(line, documents));
+    ASSERT(documents.empty());
+    ASSERT(ExtractLine(responses, line));
+    ASSERT(!ParseResponse(line, documents));
+    ASSERT(!ParseResponse("OK 2 3 0.25 5"sv, documents));
+
+    //     
+    SearchServer server("and"s);
+    server.AddDocument(1, "white cat and yellow hat"s, DocumentStatus::ACTUAL, { 1 });
+    server.AddDocument(2, "curly cat curly tail"s, DocumentStatus::ACTUAL, { 2 });
+    server.AddDocument(3, "big dog"s, DocumentStatus::ACTUAL, { 3 });
+    const std::vector<Document> found = server.FindTopDocuments("curly cat"s);
+    output.clear();
+    AppendResponse(output, found);
+    ASSERT(ParseResponse(std::string_view(output).substr(0, output.size() - 1), documents));
+    ASSERT_EQUAL(documents.size(), found.size());
+    for (size_t i = 0; i < found.size(); ++i) {
+        ASSERT_EQUAL(documents[i].id, found[i].id);
+        ASSERT_EQUAL(documents[i].relevance, found[i].relevance);
+    }
+}
+
+//    
+void TestIngestCorpus() {
+    const std::string path = (std::filesystem::temp_directory_path() / "search_server_corpus_test.txt").string();
+    const auto write_file = [&path](const std::string& content) {
+        std::ofstream out(path, std::ios::binary);
+        out << content;
+    };
+
+    //   ;       
+    {
+        write_file("white cat and fashionable collar\r\n\nfluffy cat fluffy tail\nwell-groomed dog expressive eyes"s);
+        SearchServer search_server("and in on"s);
+        IngestOptions options;
+        options.first_id = 10;
+        options.chunk_size = 8;
+        ASSERT_EQUAL(IngestCorpus(search_server, path, options), 3u);
+        ASSERT_EQUAL(search_server.GetDocumentCount(), 3);
+        ASSERT(std::vector<int>(search_server.begin(), search_server.end()) == std::vector<int>({ 10, 11, 12 }));
+        const auto found_docs = search_server.FindTopDocuments("fluffy cat"s);
+        ASSERT_EQUAL(found_docs.size(), 2u);
+        ASSERT_EQUAL(found_docs[0].id, 11);
+        ASSERT_EQUAL(search_server.GetWordFrequencies(10).count("and"sv), 0u);
+    }
+
+    //   id,   
+    {
+        write_file("5\t0\t1 2 3\tfluffy cat\n7\t2\t\tfluffy dog\n"s);
+        SearchServer search_server(""s);
+        ASSERT_EQUAL(IngestCorpus(search_server, path, { CorpusFormat::FRAMED }), 2u);
+        const auto found_docs = search_server.FindTopDocuments("fluffy"s);
+        ASSERT_EQUAL(found_docs.size(), 1u);
+        ASSERT_EQUAL(found_docs[0].id, 5);
+        ASSERT_EQUAL(found_docs[0].rating, 2);
+        ASSERT_EQUAL(search_server.FindTopDocuments("dog"s, DocumentStatus::BANNED).size(), 1u);
+    }
+
+    //    ,    
+    {
+        write_file("1\t0\t\tfluffy cat\n2\tx\t\tfluffy dog\n3\t0\t\tcat\n"s);
+        SearchServer search_server(""s);
+        try {
+            IngestCorpus(search_server, path, { CorpusFormat::FRAMED });
+            ASSERT_HINT(false, "Malformed line must throw"s);
+        }
+        catch (const std::invalid_argument& e) {
+            ASSERT(std::string(e.what()).find("Line 2"s) != std::string::npos);
+        }
+        ASSERT_EQUAL(search_server.GetDocumentCount(), 1);
+    }
+    {
+        write_file("1\t0\t\tfluffy cat\n1\t0\t\tfluffy dog\n"s);
+        SearchServer search_server(""s);
+        try {
+            IngestCorpus(search_server, path, { CorpusFormat::FRAMED });
+            ASSERT_HINT(false, "Duplicate id must throw"s);
+        }
+        catch (const std::invalid_argument&) {
+        }
+        ASSERT_EQUAL(search_server.GetDocumentCount(), 1);
+    }
+    std::filesystem::remove(path);
+}
+
+//  :       
+void TestQuantizedImpacts() {
+    const std::vector<std::string> texts = {
+        "fluffy cat fluffy tail"s, "white cat and collar"s, "well-groomed dog expressive eyes"s, "fluffy dog"s,
+        "cat cat cat dog"s, "black cat white dog white tail"s, "starling evgeny"s, "dog and cat"s,
+    };
+    const std::string query = "fluffy cat -starling white"s;
+
+    SearchServer exact_server("and"s);
+    for (size_t i = 0; i < texts.size(); ++i) {
+        exact_server.AddDocument(static_cast<int>(i), texts[i], DocumentStatus::ACTUAL, { static_cast<int>(i) });
+    }
+    ASSERT(exact_server.ExplainQuery(query).strategy == QueryStrategy::BITMAP);
+    const std::vector<Document> expected = exact_server.FindTopDocuments(query);
+    //  impact_bits     
+    ASSERT_EQUAL(exact_server.GetMemoryStats()[MemoryStructure::IMPACTS].bytes, 0u);
+
+    for (const int bits : { 8, 16 }) {
+        IndexOptions options;
+        options.impact_bits = bits;
+        SearchServer search_server("and"s, options);
+        //     ,      
+        for (size_t i = texts.size(); i-- > 0;) {
+            search_server.AddDocument(static_cast<int>(i), texts[i], DocumentStatus::ACTUAL, { static_cast<int>(i) });
+        }
+        //  :    1, IDF   log(- ),  -
+        const double tolerance = 3.0 * std::log(static_cast<double>(texts.size())) / ((1 << bits) - 1);
+        const std::vector<Document> found_docs = search_server.FindTopDocuments(query);
+        ASSERT_EQUAL(found_docs.size(), expected.size());
+        for (size_t i = 0; i < found_docs.size(); ++i) {
+            ASSERT_EQUAL(found_docs[i].id, expected[i].id);
+            ASSERT(std::abs(found_docs[i].relevance - expected[i].relevance) <= tolerance);
+        }
+        ASSERT(search_server.GetMemoryStats()[MemoryStructure::IMPACTS].bytes > 0);
+
+        //     ,  ,   ,   
+        search_server.RemoveDocument(0);
+        search_server.RemoveDocument(std::execution::par, 1);
+        const std::vector<Document> after_remove = search_server.FindTopDocuments("fluffy white"s);
+        ASSERT(std::none_of(after_remove.begin(), after_remove.end(), [](const Document& document) { return document.id <= 1; }));
+        ASSERT_EQUAL(after_remove.size(), 2u);
+    }
+
+    IndexOptions invalid_options;
+    invalid_options.impact_bits = 4;
+    try {
+        SearchServer search_server("and"s, invalid_options);
+        ASSERT_HINT(false, "Unsupported impact width must throw"s);
+    }
+    catch (const std::invalid_argument&) {
+    }
+}
+
+//  Roaring:   -  -
+void TestRoaringBitmap() {
+    // ׸    -  ,    - 
+    RoaringBitmap evens;
+    std::set<uint32_t> expected_evens;
+    for (uint32_t value = 0; value < 20000; value += 2) {
+        evens.Add(value);
+        expected_evens.insert(value);
+    }
+    for (uint32_t value = 70000; value < 70100; value += 2) {
+        evens.Add(value);
+        expected_evens.insert(value);
+    }
+    RoaringBitmap threes;
+    std::set<uint32_t> expected_threes;
+    for (uint32_t value = 0; value < 70100; value += 3) {
+        threes.Add(value);
+        expected_threes.insert(value);
+    }
+    evens.Remove(4);
+    expected_evens.erase(4);
+    ASSERT_EQUAL(evens.GetCardinality(), expected_evens.size());
+    ASSERT(evens.Contains(6) && !evens.Contains(4) && !evens.Contains(7) && evens.Contains(70098));
+
+    const auto to_vector = [](const RoaringBitmap& bitmap) {
+        std::vector<uint32_t> values;
+        bitmap.ForEach([&values](uint32_t value) { values.push_back(value); });
+        return values;
+    };
+    const auto combine = [&](auto operation) {
+        std::vector<uint32_t> values;
+        operation(expected_evens.begin(), expected_evens.end(), expected_threes.begin(), expected_threes.end(), std::back_inserter(values));
+        return values;
+    };
+
+    RoaringBitmap united = evens;
+    united.Union(threes);
+    ASSERT(to_vector(united) == combine([](auto... args) { return std::set_union(args...); }));
+    RoaringBitmap intersection = evens;
+    intersection.Intersect(threes);
+    ASSERT(to_vector(intersection) == combine([](auto... args) { return std::set_intersection(args...); }));
+    RoaringBitmap difference = evens;
+    difference.Subtract(threes);
+    ASSERT(to_vector(difference) == combine([](auto... args) { return std::set_difference(args...); }));
+
+    //    128 :    
+    std::vector<uint64_t> words(2, ~uint64_t{ 0 });
+    ASSERT_EQUAL(evens.AndNotInto(words.data(), words.size()), 63u);
+    ASSERT_EQUAL(words[0], 0xAAAAAAAAAAAAAAAAULL | (uint64_t{ 1 } << 4));
+    threes.AndInto(words.data(), words.size());
+    //   ,  3
+    ASSERT(words[1] & (uint64_t{ 1 } << (75 - 64)));
+    ASSERT_EQUAL(words[1] & (uint64_t{ 1 } << (71 - 64)), 0u);
+}
+
+//         ,   
+void TestTermBitmaps() {
+    //  cat  dog    ,    8  
+    std::vector<std::string> texts;
+    for (int i = 0; i < 40; ++i) {
+        std::string text = (i % 5 == 0) ? "bird"s : "cat"s;
+        text += (i % 3 == 0) ? " fluffy"s : " dog"s;
+        text += (i % 7 == 0) ? " white tail"s : " black"s;
+        texts.push_back(text);
+    }
+    IndexOptions options;
+    options.bitmap_min_document_freq = 8;
+    SearchServer search_server(""s, options);
+    IndexOptions plain_options;
+    plain_options.bitmap_min_document_freq = 0;
+    SearchServer plain_server(""s, plain_options);
+    for (int i = 0; i < 40; ++i) {
+        const DocumentStatus status = (i % 4 == 0) ? DocumentStatus::BANNED : DocumentStatus::ACTUAL;
+        search_server.AddDocument(i, texts[i], status, { i });
+        plain_server.AddDocument(i, texts[i], status, { i });
+    }
+    ASSERT(search_server.GetMemoryStats()[MemoryStructure::TERM_BITMAPS].entries > 0);
+    ASSERT_EQUAL(plain_server.GetMemoryStats()[MemoryStructure::TERM_BITMAPS].entries, 0u);
+
+    const auto check_same = [&]() {
+        for (const std::string& query : { "fluffy -cat"s, "white tail -dog"s, "black fluffy -cat -dog"s, "+white -cat"s, "bird -black"s }) {
+            for (const DocumentStatus status : { DocumentStatus::ACTUAL, DocumentStatus::BANNED }) {
+                const std::vector<Document> expected = plain_server.FindTopDocuments(query, status);
+                const std::vector<Document> found = search_server.FindTopDocuments(query, status);
+                ASSERT_EQUAL(found.size(), expected.size());
+                for (size_t i = 0; i < found.size(); ++i) {
+                    ASSERT_EQUAL(found[i].id, expected[i].id);
+                }
+                ASSERT_EQUAL(search_server.FindTopDocuments(std::execution::par, query, status).size(), expected.size());
+            }
+            const SearchPage page = search_server.FindPageAt(query, 100, 0);
+            ASSERT_EQUAL(page.documents.size(), plain_server.FindPageAt(query, 100, 0).documents.size());
+        }
+    };
+    check_same();
+
+    //     ,      :
+    //          
+    for (int i = 0; i < 37; ++i) {
+        if (i % 2 == 0) {
+            search_server.RemoveDocument(i);
+        }
+        else {
+            search_server.RemoveDocument(std::execution::par, i);
+        }
+        plain_server.RemoveDocument(i);
+    }
+    check_same();
+    ASSERT_EQUAL(search_server.GetMemoryStats()[MemoryStructure::TERM_BITMAPS].entries, 0u);
+
+    // , ,        ,    
+    SearchServer readded_server(""s, options);
+    SearchServer readded_plain(""s, plain_options);
+    for (SearchServer* server : { &readded_server, &readded_plain }) {
+        for (int i = 0; i < 8; ++i) {
+            server->AddDocument(i, "cat dog"s, DocumentStatus::ACTUAL, { 1 });
+        }
+        server->AddDocument(50, "dog bird"s, DocumentStatus::ACTUAL, { 1 });
+        server->RemoveDocument(0);
+        server->RemoveDocument(1);
+        server->AddDocument(100, "cat dog"s, DocumentStatus::ACTUAL, { 1 });
+    }
+    for (const std::string& query : { "+dog -cat"s, "dog bird -cat"s }) {
+        const std::vector<Document> expected = readded_plain.FindTopDocuments(query);
+        const std::vector<Document> found = readded_server.FindTopDocuments(query);
+        ASSERT_EQUAL(found.size(), 1u);
+        ASSERT_EQUAL(found.size(), expected.size());
+        ASSERT_EQUAL(found[0].id, 50);
+    }
+}
+
+//  :   ,   
+void TestForwardIndex() {
+    using WordList = std::vector<std::pair<std::string_view, double>>;
+    SearchServer search_server("and"s);
+    for (int i = 0; i < 20; ++i) {
+        search_server.AddDocument(i, "word"s + std::to_string(i) + " white cat and cat"s, DocumentStatus::ACTUAL, { 1 });
+    }
+
+    //   ,    -
+    const WordFrequencies word_freqs = search_server.GetWordFrequencies(7);
+    WordList expected = { { "cat"sv, 0.5 }, { "white"sv, 0.25 }, { "word7"sv, 0.25 } };
+    ASSERT(WordList(word_freqs.begin(), word_freqs.end()) == expected);
+    ASSERT_EQUAL(word_freqs.find("white"sv)->second, 0.25);
+    ASSERT(word_freqs.find("word8"sv) == word_freqs.end());
+    ASSERT(search_server.GetWordFrequencies(100).empty());
+
+    //      ;      
+    for (int i = 0; i < 15; ++i) {
+        search_server.RemoveDocument(i);
+    }
+    search_server.AddDocument(30, "fluffy dog"s, DocumentStatus::ACTUAL, { 1 });
+    expected = { { "cat"sv, 0.5 }, { "white"sv, 0.25 }, { "word17"sv, 0.25 } };
+    const WordFrequencies remaining = search_server.GetWordFrequencies(17);
+    ASSERT(WordList(remaining.begin(), remaining.end()) == expected);
+    const WordFrequencies added = search_server.GetWordFrequencies(30);
+    expected = { { "dog"sv, 0.5 }, { "fluffy"sv, 0.5 } };
+    ASSERT(WordList(added.begin(), added.end()) == expected);
+    ASSERT_EQUAL(search_server.GetMemoryStats()[MemoryStructure::FORWARD_INDEX].entries, 17u);
+}
+
+// :  ,  ,   
+void TestWriteAheadLog() {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "search_server_wal_test";
+    std::filesystem::remove_all(directory);
+    WalOptions options;
+    options.directory = directory.string();
+
+    const auto recover = [&options](SearchServer& search_server) {
+        WriteAheadLog wal(search_server, options);
+        return wal.GetRecoveryStats();
+    };
+
+    //    ;     
+    {
+        SearchServer search_server("and"s);
+        WriteAheadLog wal(search_server, options);
+        wal.AddDocument(1, "white cat and collar"s, DocumentStatus::ACTUAL, { 1, 2, 3 });
+        wal.AddDocument(2, "fluffy cat"s, DocumentStatus::BANNED, {});
+        wal.AddDocument(3, "groomed dog"s, DocumentStatus::ACTUAL, { 5 });
+        try {
+            wal.AddDocument(3, "fluffy dog"s, DocumentStatus::ACTUAL, {});
+            ASSERT_HINT(false, "Duplicate id must throw"s);
+        }
+        catch (const std::invalid_argument&) {}
+        wal.RemoveDocument(2);
+        wal.RemoveDocument(100);
+        ASSERT_EQUAL(wal.GetStats().records, 4u);
+        ASSERT_EQUAL(wal.GetStats().syncs, 4u);
+    }
+    {
+        SearchServer search_server("and"s);
+        const WalRecoveryStats stats = recover(search_server);
+        ASSERT_EQUAL(stats.replayed_records, 4u);
+        ASSERT(std::vector<int>(search_server.begin(), search_server.end()) == std::vector<int>({ 1, 3 }));
+        const auto found_docs = search_server.FindTopDocuments("cat"s);
+        ASSERT_EQUAL(found_docs.size(), 1u);
+        ASSERT_EQUAL(found_docs[0].rating, 2);
+    }
+
+    //      ,     
+    {
+        SearchServer search_server("and"s);
+        WriteAheadLog wal(search_server, options);
+        wal.Checkpoint();
+        wal.AddDocument(4, "fluffy cat"s, DocumentStatus::ACTUAL, { 7 });
+        wal.RemoveDocument(1);
+        ASSERT_EQUAL(search_server.GetDocumentCount(), 2);
+    }
+    {
+        size_t snapshot_count = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+            snapshot_count += entry.path().extension() == ".tsv"s ? 1 : 0;
+        }
+        ASSERT_EQUAL(snapshot_count, 1u);
+        SearchServer search_server("and"s);
+        const WalRecoveryStats stats = recover(search_server);
+        ASSERT_EQUAL(stats.snapshot_documents, 2u);
+        ASSERT_EQUAL(stats.replayed_records, 2u);
+        ASSERT(std::vector<int>(search_server.begin(), search_server.end()) == std::vector<int>({ 3, 4 }));
+    }
+
+    //    
+    {
+        std::filesystem::path last_segment;
+        for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+            if (entry.path().extension() == ".log"s && (last_segment.empty() || last_segment < entry.path())) {
+                last_segment = entry.path();
+            }
+        }
+        std::ofstream(last_segment, std::ios::binary | std::ios::app) << "\x10\x00\x00"s;
+        SearchServer search_server("and"s);
+        ASSERT_EQUAL(recover(search_server).truncated_bytes, 3u);
+        ASSERT_EQUAL(search_server.GetDocumentCount(), 2);
+    }
+    std::filesystem::remove_all(directory);
+}
+
+//     
+void TestAddDocumentRatingRange() {
+    SearchServer search_server("and"s);
+    const int ratings[] = { 4, 5, -3 };
+    search_server.AddDocument(1, "white cat"s, DocumentStatus::ACTUAL, std::begin(ratings), std::end(ratings));
+    const std::list<int> rating_list = { 7, 2 };
+    search_server.AddDocument(2, "fluffy cat"s, DocumentStatus::ACTUAL, rating_list.begin(), rating_list.end());
+    //     
+    std::istringstream rating_stream("10 20 30"s);
+    search_server.AddDocument(3, "groomed cat"s, DocumentStatus::ACTUAL, std::istream_iterator<int>(rating_stream), std::istream_iterator<int>());
+    search_server.AddDocument(4, "cat and dog"s, DocumentStatus::ACTUAL, ratings, ratings);
+
+    std::map<int, int> rating_by_id;
+    for (const Document& document : search_server.FindTopDocuments("cat"s)) {
+        rating_by_id[document.id] = document.rating;
+    }
+    const std::map<int, int> expected_ratings = { { 1, 2 }, { 2, 4 }, { 3, 20 }, { 4, 0 } };
+    ASSERT(rating_by_id == expected_ratings);
+
+    //     
+    try {
+        search_server.AddDocument(5, "cat d\x12og"s, DocumentStatus::ACTUAL, std::begin(ratings), std::end(ratings));
+        ASSERT_HINT(false, "Invalid text must throw"s);
+    }
+    catch (const std::invalid_argument&) {}
+    ASSERT_EQUAL(search_server.GetDocumentCount(), 4);
+    ASSERT_EQUAL(search_server.GetWordFrequencies(4).size(), 2u);
+}
+
+//  :  ,   future, Flush
+void TestIngestionQueue() {
+    SearchServer search_server("and"s);
+    {
+        IngestionQueue queue(search_server);
+        //     , future     
+        const int producer_count = 4;
+        const int documents_per_producer = 50;
+        std::vector<std::thread> producers;
+        std::vector<std::vector<std::future<void>>> results(producer_count);
+        for (int p = 0; p < producer_count; ++p) {
+            producers.emplace_back([&queue, &results, p] {
+                for (int i = 0; i < documents_per_producer; ++i) {
+                    const int id = p * documents_per_producer + i;
+                    results[p].push_back(queue.AddDocument(id, "cat number"s + std::to_string(id), DocumentStatus::ACTUAL, { id }));
+                }
+                });
+        }
+        for (std::thread& producer : producers) {
+            producer.join();
+        }
+        std::future<void> duplicate = queue.AddDocument(7, "dog"s, DocumentStatus::ACTUAL, {});
+        std::future<void> invalid = queue.AddDocument(1000, "d\x12og"s, DocumentStatus::ACTUAL, {});
+        queue.Flush();
+        ASSERT_EQUAL(search_server.GetDocumentCount(), producer_count * documents_per_producer);
+        for (auto& producer_results : results) {
+            for (std::future<void>& result : producer_results) {
+                result.get();
+            }
+        }
+        try {
+            duplicate.get();
+            ASSERT_HINT(false, "Duplicate id must be rejected"s);
+        }
+        catch (const std::invalid_argument&) {}
+        try {
+            invalid.get();
+            ASSERT_HINT(false, "Invalid text must be rejected"s);
+        }
+        catch (const std::invalid_argument&) {}
+        ASSERT_EQUAL(queue.GetStats().documents, 202u);
+        ASSERT(queue.GetStats().groups <= 202u);
+
+        // ,   ,    
+        queue.AddDocument(500, "fluffy cat"s, DocumentStatus::ACTUAL, {});
+    }
+    ASSERT_EQUAL(search_server.GetDocumentCount(), 201);
+    ASSERT_EQUAL(search_server.FindTopDocuments("number42"s).size(), 1u);
+}
+
+//  :      
+void TestStandingQueries() {
+    SearchServer search_server("and in"s);
+    search_server.AddDocument(0, "white cat and collar"s, DocumentStatus::ACTUAL, { 1 });
+    std::map<size_t, std::vector<Document>> alerts;
+    const auto collect = [&alerts](size_t index) {
+        return [&alerts, index](const Document& document) { alerts[index].push_back(document); };
+    };
+    search_server.RegisterStandingQuery("fluffy cat -dog"s, collect(0));
+    search_server.RegisterStandingQuery("+tail groom*"s, collect(1));
+    const size_t removed_query = search_server.RegisterStandingQuery("collar"s, collect(2));
+    search_server.RegisterStandingQuery("parrot -gre*"s, collect(3));
+    search_server.UnregisterStandingQuery(removed_query);
+    try {
+        search_server.RegisterStandingQuery("\"fluffy cat\""s, collect(4));
+        ASSERT_HINT(false, "Phrases must be rejected"s);
+    }
+    catch (const std::invalid_argument&) {}
+
+    search_server.AddDocument(1, "fluffy cat fluffy tail"s, DocumentStatus::ACTUAL, { 7 });
+    search_server.AddDocument(2, "fluffy dog and collar"s, DocumentStatus::ACTUAL, { 5 });
+    search_server.AddDocument(3, "groomed dog with tail"s, DocumentStatus::ACTUAL, { 2 });
+    search_server.AddDocument(4, "groomed parrot"s, DocumentStatus::ACTUAL, { 3 });
+    search_server.AddDocument(5, "green parrot"s, DocumentStatus::ACTUAL, { 3 });
+    search_server.AddDocument(6, "fluffy cat"s, DocumentStatus::BANNED, { 3 });
+
+    //     FindTopDocuments   
+    ASSERT_EQUAL(alerts[0].size(), 1u);
+    ASSERT_EQUAL(alerts[0][0].id, 1);
+    ASSERT_EQUAL(alerts[0][0].rating, 7);
+    ASSERT(alerts[1].size() == 2u && alerts[1][0].id == 1 && alerts[1][1].id == 3);
+    ASSERT(alerts[2].empty());
+    ASSERT(alerts[3].size() == 1u && alerts[3][0].id == 4);
+
+    SearchServer reference("and in"s);
+    reference.AddDocument(0, "white cat and collar"s, DocumentStatus::ACTUAL, { 1 });
+    reference.AddDocument(1, "fluffy cat fluffy tail"s, DocumentStatus::ACTUAL, { 7 });
+    const std::vector<Document> found_docs = reference.FindTopDocuments("fluffy cat -dog"s);
+    ASSERT_EQUAL(found_docs[0].id, 1);
+    ASSERT(std::abs(found_docs[0].relevance - alerts[0][0].relevance) < 1e-9);
+}
+
+//           
+void TestQueryDeadline() {
+    SearchServer search_server("and"s);
+    for (int i = 0; i < 5000; ++i) {
+        //  id,    ,    
+        search_server.AddDocument(i * 10, (i % 2 == 0) ? "fluffy cat"s : "fluffy dog"s, DocumentStatus::ACTUAL, { i % 7 });
+    }
+
+    const TopDocumentsResult unlimited = search_server.FindTopDocuments("cat fluffy -dog"s, QueryDeadline{});
+    const std::vector<Document> expected = search_server.FindTopDocuments("cat fluffy -dog"s);
+    ASSERT(unlimited.is_complete);
+    ASSERT_EQUAL(unlimited.documents.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQUAL(unlimited.documents[i].id, expected[i].id);
+    }
+
+    //        -   
+    CancellationToken cancelled;
+    cancelled.Cancel();
+    const TopDocumentsResult cancelled_result = search_server.FindTopDocuments("cat"s, QueryDeadline(cancelled));
+    ASSERT(!cancelled_result.is_complete);
+    ASSERT(cancelled_result.documents.empty());
+    const QueryDeadline expired(QueryDeadline::Clock::now() - std::chrono::seconds(1));
+    ASSERT(!search_server.FindTopDocuments(std::execution::par, "cat"s, DocumentStatus::ACTUAL, expired).is_complete);
+
+    //   :     1000- 
+    CancellationToken token;
+    int predicate_calls = 0;
+    const auto cancel_midway = [&token, &predicate_calls](int, DocumentStatus, int) {
+        if (++predicate_calls == 1000) {
+            token.Cancel();
+        }
+        return true;
+    };
+    const TopDocumentsResult partial = search_server.FindTopDocuments(std::execution::seq, "cat fluffy -dog"s, cancel_midway, QueryDeadline(token));
+    ASSERT(!partial.is_complete);
+    ASSERT(!partial.documents.empty());
+    // -     
+    for (const Document& document : partial.documents) {
+        ASSERT_EQUAL(document.id % 20, 0);
+    }
+
+    //          
+    for (const bool is_parallel : { false, true }) {
+        CancellationToken required_token;
+        const auto cancel_first = [&required_token](int, DocumentStatus, int) {
+            required_token.Cancel();
+            return true;
+        };
+        const TopDocumentsResult required = is_parallel
+            ? search_server.FindTopDocuments(std::execution::par, "+cat fluffy"s, cancel_first, QueryDeadline(required_token))
+            : search_server.FindTopDocuments(std::execution::seq, "+cat fluffy"s, cancel_first, QueryDeadline(required_token));
+        ASSERT(!required.is_complete);
+        ASSERT(required.documents.empty());
+    }
+
+    //   :     
+    const std::vector<std::string> queries = { "cat"s, "dog"s, "fluffy -cat"s };
+    const std::vector<TopDocumentsResult> batch = ProcessQueries(search_server, queries, expired);
+    ASSERT_EQUAL(batch.size(), queries.size());
+    for (const TopDocumentsResult& result : batch) {
+        ASSERT(!result.is_complete);
+    }
+    const std::vector<TopDocumentsResult> full_batch = ProcessQueries(search_server, queries, QueryDeadline::After(std::chrono::hours(1)));
+    for (const TopDocumentsResult& result : full_batch) {
+        ASSERT(result.is_complete);
+        ASSERT_EQUAL(result.documents.size(), 5u);
+    }
+}
+
+//  Try*     
+void TestTryApi() {
+    IndexOptions options;
+    options.store_positions = true;
+    SearchServer search_server("and in"s, options);
+    ASSERT(search_server.TryAddDocument(1, "white cat and fashionable collar"s, DocumentStatus::ACTUAL, { 8, -3 }).HasValue());
+    ASSERT(search_server.TryAddDocument(2, "fluffy cat fluffy tail"s, DocumentStatus::ACTUAL, { 7, 2, 7 }).HasValue());
+
+    ASSERT(search_server.TryAddDocument(-1, "dog"s, DocumentStatus::ACTUAL, { 1 }).GetError() == SearchError::NEGATIVE_DOCUMENT_ID);
+    ASSERT(search_server.TryAddDocument(1, "dog"s, DocumentStatus::ACTUAL, { 1 }).GetError() == SearchError::DUPLICATE_DOCUMENT_ID);
+    ASSERT(search_server.TryAddDocument(3, "big d\x12og"s, DocumentStatus::ACTUAL, { 1 }).GetError() == SearchError::INVALID_DOCUMENT_CHARACTERS);
+    //    
+    ASSERT_EQUAL(search_server.GetDocumentCount(), 2);
+
+    const Expected<std::vector<Document>> found = search_server.TryFindTopDocuments("fluffy cat"s);
+    ASSERT(found.HasValue());
+    ASSERT_EQUAL(found.Value().size(), 2u);
+    ASSERT_EQUAL(found.Value()[0].id, 2);
+    ASSERT(found.GetError() == SearchError::NONE);
+
+    const auto error_of = [&search_server](const std::string& query) {
+        return search_server.TryFindTopDocuments(std::execution::par, query, DocumentStatus::ACTUAL).GetError();
+    };
+    ASSERT(error_of("cat --tail"s) == SearchError::MULTIPLE_SIGNS);
+    ASSERT(error_of("cat -"s) == SearchError::EMPTY_SIGNED_WORD);
+    ASSERT(error_of("c\x01t"s) == SearchError::INVALID_QUERY_CHARACTERS);
+    ASSERT(error_of("cat *"s) == SearchError::EMPTY_PREFIX);
+    ASSERT(error_of("+cat*"s) == SearchError::REQUIRED_PREFIX);
+    ASSERT(error_of("\"fluffy -cat\""s) == SearchError::SIGNED_PHRASE_WORD);
+    ASSERT(error_of("\"fluffy cat\"x"s) == SearchError::INVALID_PHRASE_SUFFIX);
+    ASSERT(error_of("\"fluffy cat"s) == SearchError::UNCLOSED_PHRASE);
+    ASSERT(error_of("\"fluffy cat\"~2"s) == SearchError::NONE);
+
+    //   std::invalid_argument   
+    try {
+        search_server.FindTopDocuments("cat --tail"s);
+        ASSERT_HINT(false, "FindTopDocuments must throw for a double minus");
+    }
+    catch (const std::invalid_argument& e) {
+        ASSERT_EQUAL(std::string(e.what()), std::string(GetSearchErrorMessage(SearchError::MULTIPLE_SIGNS)));
+    }
+    try {
+        search_server.AddDocument(1, "dog"s, DocumentStatus::ACTUAL, { 1 });
+        ASSERT_HINT(false, "AddDocument must throw for a duplicate id");
+    }
+    catch (const std::invalid_argument&) {
+    }
+
+    //      ;     
+    ASSERT(error_of("cat --tail \x01"s) == SearchError::MULTIPLE_SIGNS);
+}
+
+//   ShardedSearchServer:     ,   
+void TestShardedStandingQueries() {
+    ShardedSearchServer sharded_server("and"s, 4);
+    std::mutex alerts_mutex;
+    std::map<int, double> alerts;
+    const size_t query_id = sharded_server.RegisterStandingQuery("fluffy cat -dog"s, [&](const Document& document) {
+        const std::lock_guard guard(alerts_mutex);
+        ASSERT_HINT(alerts.count(document.id) == 0, "Each document must be reported once"s);
+        alerts[document.id] = document.relevance;
+        });
+
+    std::vector<std::string> texts;
+    for (int i = 0; i < 40; ++i) {
+        texts.push_back((i % 3 == 0) ? "fluffy cat and dog"s : (i % 3 == 1) ? "fluffy cat"s : "white parrot"s);
+    }
+    std::vector<NewDocument> documents;
+    for (int i = 0; i < 40; ++i) {
+        documents.push_back({ i, texts[i], (i == 4) ? DocumentStatus::BANNED : DocumentStatus::ACTUAL, { i } });
+    }
+    sharded_server.AddDocuments(std::execution::par, documents);
+
+    //       
+    SearchServer reference("and"s);
+    for (const NewDocument& document : documents) {
+        reference.AddDocument(document.id, document.text, document.status, document.ratings);
+    }
+    const double expected_relevance = reference.FindTopDocuments("fluffy cat -dog"s).front().relevance;
+    ASSERT_EQUAL(alerts.size(), 12u);
+    for (const auto& [id, relevance] : alerts) {
+        ASSERT(id % 3 == 1 && id != 4);
+        ASSERT(std::abs(relevance - expected_relevance) < 1e-9);
+    }
+
+    sharded_server.UnregisterStandingQuery(query_id);
+    sharded_server.AddDocument(100, "fluffy cat"s, DocumentStatus::ACTUAL, { 1 });
+    ASSERT_EQUAL(alerts.count(100), 0u);
+}
+
+//  :   ,    
+void TestSearchServerCopy() {
+    IndexOptions options;
+    options.store_positions = true;
+    options.max_typo_distance = 1;
+    options.impact_bits = 16;
+    options.bitmap_min_document_freq = 4;
+    SearchServer search_server("and with"s, options);
+    for (int i = 0; i < 30; ++i) {
+        const std::string text = (i % 3 == 0) ? "curly cat with curly tail"s : (i % 3 == 1) ? "white dog and cat"s : "nasty parrot"s;
+        search_server.AddDocument(i, text, (i % 5 == 0) ? DocumentStatus::BANNED : DocumentStatus::ACTUAL, { i });
+    }
+    search_server.RemoveDocument(4);
+    int alert_count = 0;
+    search_server.RegisterStandingQuery("parrot"s, [&alert_count](const Document&) { ++alert_count; });
+
+    const SearchServer copy = search_server;
+    ASSERT_EQUAL(copy.GetDocumentCount(), search_server.GetDocumentCount());
+    for (const std::string& query : { "curly cat -dog"s, "\"curly tail\""s, "cat -white"s, "kat parrot"s, "c*"s }) {
+        for (const DocumentStatus status : { DocumentStatus::ACTUAL, DocumentStatus::BANNED }) {
+            const std::vector<Document> expected = search_server.FindTopDocuments(query, status);
+            const std::vector<Document> found = copy.FindTopDocuments(query, status);
+            ASSERT_EQUAL(found.size(), expected.size());
+            for (size_t i = 0; i < found.size(); ++i) {
+                ASSERT_EQUAL(found[i].id, expected[i].id);
+                ASSERT(std::abs(found[i].relevance - expected[i].relevance) < 1e-6);
+            }
+        }
+    }
+    {
+        const auto [words, status] = copy.MatchDocument("\"curly tail\" cat"s, 3);
+        ASSERT_EQUAL(words.size(), 3u);
+    }
+    ASSERT_EQUAL(copy.GetMemoryStats()[MemoryStructure::POSITIONS].entries, search_server.GetMemoryStats()[MemoryStructure::POSITIONS].entries);
+    ASSERT_EQUAL(copy.GetMemoryStats()[MemoryStructure::TERM_BITMAPS].entries, search_server.GetMemoryStats()[MemoryStructure::TERM_BITMAPS].entries);
+
+    //    ,       callback
+    SearchServer changed = copy;
+    changed.AddDocument(100, "nasty parrot"s, DocumentStatus::ACTUAL, { 1 });
+    changed.RemoveDocument(0);
+    ASSERT_EQUAL(alert_count, 1);
+    ASSERT_EQUAL(changed.GetDocumentCount(), copy.GetDocumentCount());
+    ASSERT_EQUAL(copy.FindTopDocuments("nasty"s, [](int document_id, DocumentStatus, int) { return document_id == 100; }).size(), 0u);
+    ASSERT_EQUAL(search_server.FindTopDocuments("curly"s, DocumentStatus::BANNED).size(), copy.FindTopDocuments("curly"s, DocumentStatus::BANNED).size());
+
+    //     
+    search_server.ResetQueryStats();
+    SearchServer stats_copy = search_server;
+    stats_copy.FindTopDocuments("cat"s);
+    ASSERT_EQUAL(search_server.GetQueryStats().stages[static_cast<size_t>(QueryStage::PARSE)].total_count, 0u);
+}
+
+//     LatencyHistogram   
+void TestLatencyHistogram() {
+    //    
+    for (uint64_t value = 0; value < static_cast<uint64_t>(LatencyHistogram::SUB_BUCKET_COUNT); ++value) {
+        ASSERT_EQUAL(LatencyHistogram::GetBucketUpperBound(LatencyHistogram::GetBucketIndex(value)), value);
+    }
+
+    //      ,      value / SUB_BUCKET_COUNT
+    std::vector<uint64_t> values;
+    for (int bit = 1; bit < 64; ++bit) {
+        const uint64_t power = uint64_t{ 1 } << bit;
+        values.push_back(power - 1);
+        values.push_back(power);
+        values.push_back(power + 1);
+    }
+    values.push_back(std::numeric_limits<uint64_t>::max());
+    for (const uint64_t value : values) {
+        const int index = LatencyHistogram::GetBucketIndex(value);
+        ASSERT(index >= 0 && index < LatencyHistogram::BUCKET_COUNT);
+        const uint64_t upper = LatencyHistogram::GetBucketUpperBound(index);
+        const uint64_t lower = index == 0 ? 0 : LatencyHistogram::GetBucketUpperBound(index - 1) + 1;
+        ASSERT_HINT(lower <= value && value <= upper, std::to_string(value));
+        ASSERT_HINT((upper - lower) * LatencyHistogram::SUB_BUCKET_COUNT <= value, std::to_string(value));
+    }
+    ASSERT_EQUAL(LatencyHistogram::GetBucketIndex(std::numeric_limits<uint64_t>::max()), LatencyHistogram::BUCKET_COUNT - 1);
+
+    //    :     
+    for (int index = 1; index < LatencyHistogram::BUCKET_COUNT; ++index) {
+        ASSERT_EQUAL(LatencyHistogram::GetBucketIndex(LatencyHistogram::GetBucketUpperBound(index - 1) + 1), index);
+    }
+
+    LatencyHistogram histogram;
+    for (uint64_t value = 1; value <= 1000; ++value) {
+        histogram.Record(value);
+    }
+    const LatencyHistogram::Snapshot snapshot = histogram.GetSnapshot();
+    ASSERT_EQUAL(snapshot.total_count, 1000u);
+    const uint64_t median = snapshot.GetValueAtPercentile(50);
+    ASSERT(median >= 500 && median <= 500 + 500 / LatencyHistogram::SUB_BUCKET_COUNT);
+    ASSERT_EQUAL(snapshot.GetValueAtPercentile(100), 1000u);
+}
+
 //  TestSearchServer      
 void TestSearchServer() {
     RUN_TEST(TestExcludeStopWordsFromAddedDocumentContent);
@@ -280,4 +1860,32 @@ void TestSearchServer() {
     RUN_TEST(TestByRating);
     RUN_TEST(TestFilterByPredicate);
     RUN_TEST(TestSearchByStatusDocuments);
+    RUN_TEST(TestRequestQueue);
+    RUN_TEST(TestQueryStats);
+    RUN_TEST(TestTraceRecorder);
+    RUN_TEST(TestFindPage);
+    RUN_TEST(TestMatchDocuments);
+    RUN_TEST(TestRequiredWords);
+    RUN_TEST(TestQueryPlanner);
+    RUN_TEST(TestPhraseQueries);
+    RUN_TEST(TestPrefixQueries);
+    RUN_TEST(TestTypoTolerance);
+    RUN_TEST(TestScratchArena);
+    RUN_TEST(TestMemoryStats);
+    RUN_TEST(TestShardedSearchServer);
+    RUN_TEST(TestQueryProtocol);
+    RUN_TEST(TestIngestCorpus);
+    RUN_TEST(TestQuantizedImpacts);
+    RUN_TEST(TestRoaringBitmap);
+    RUN_TEST(TestTermBitmaps);
+    RUN_TEST(TestForwardIndex);
+    RUN_TEST(TestWriteAheadLog);
+    RUN_TEST(TestAddDocumentRatingRange);
+    RUN_TEST(TestIngestionQueue);
+    RUN_TEST(TestStandingQueries);
+    RUN_TEST(TestQueryDeadline);
+    RUN_TEST(TestTryApi);
+    RUN_TEST(TestShardedStandingQueries);
+    RUN_TEST(TestSearchServerCopy);
+    RUN_TEST(TestLatencyHistogram);
 }
\ No newline at end of file
@@ -22,5 +22,89 @@ void TestFilterByPredicate();
 
 void TestSearchByStatusDocuments();
 
+//    RequestQueue
+void TestRequestQueue();
+
+//       
+void TestQueryStats();
+
+//       Chrome trace
+void TestTraceRecorder();
+
+//    FindPage  Paginate
+void TestFindPage();
+
+//      
+void TestMatchDocuments();
+
+//      (+)
+void TestRequiredWords();
+
+//         
+void TestQueryPlanner();
+
+//        
+void TestPhraseQueries();
+
+//    *    
+void TestPrefixQueries();
+
+//      
+void TestTypoTolerance();
+
+//    
+void TestScratchArena();
+
+//     
+void TestMemoryStats();
+
+//     ,    
+void TestShardedSearchServer();
+
+//    
+void TestQueryProtocol();
+
+//    
+void TestIngestCorpus();
+
+//  :       
+void TestQuantizedImpacts();
+
+//  Roaring:   -  -
+void TestRoaringBitmap();
+
+//         ,   
+void TestTermBitmaps();
+
+//  :   ,   
+void TestForwardIndex();
+
+// :  ,  ,   
+void TestWriteAheadLog();
+
+//     
+void TestAddDocumentRatingRange();
+
+//  :  ,   future, Flush
+void TestIngestionQueue();
+
+//  :      
+void TestStandingQueries();
+
+//           
+void TestQueryDeadline();
+
+//  Try*     
+void TestTryApi();
+
+//   ShardedSearchServer:     ,   
+void TestShardedStandingQueries();
+
+//  :   ,    
+void TestSearchServerCopy();
+
+//     LatencyHistogram   
+void TestLatencyHistogram();
+
 //  TestSearchServer      
 void TestSearchServer();
\ No newline at end of file
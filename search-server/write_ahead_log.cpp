@@ -0,0 +1,614 @@
+#include "write_ahead_log.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <execution>
+#include <filesystem>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+#include "corpus_reader.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std::literals;
+
+namespace {
+
+enum class RecordType : uint8_t {
+    ADD_DOCUMENT = 1,
+    REMOVE_DOCUMENT = 2,
+};
+
+// :   (4 ), CRC32  (4 ), : LSN, , id,
+//   - , - ,      .  -    
+struct LogRecord {
+    uint64_t lsn = 0;
+    RecordType type = RecordType::ADD_DOCUMENT;
+    int id = 0;
+    DocumentStatus status = DocumentStatus::ACTUAL;
+    std::vector<int> ratings;
+    std::string_view text;
+};
+
+const size_t RECORD_HEADER_SIZE = 8;
+//  ,     
+const size_t REPLAY_BATCH_SIZE = 4096;
+const size_t SNAPSHOT_WRITE_SIZE = size_t(1) << 20;
+
+std::array<uint32_t, 256> MakeCrc32Table() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) != 0 ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+uint32_t Crc32(const char* data, size_t size) {
+    static const std::array<uint32_t, 256> table = MakeCrc32Table();
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+template <typename Value>
+void Put(std::string& out, Value value) {
+    char bytes[sizeof(Value)];
+    std::memcpy(bytes, &value, sizeof(Value));
+    out.append(bytes, sizeof(Value));
+}
+
+template <typename Value>
+bool Get(std::string_view& data, Value& value) {
+    if (data.size() < sizeof(Value)) {
+        return false;
+    }
+    std::memcpy(&value, data.data(), sizeof(Value));
+    data.remove_prefix(sizeof(Value));
+    return true;
+}
+
+void AppendRecord(std::string& out, const LogRecord& record) {
+    const size_t header_offset = out.size();
+    out.resize(header_offset + RECORD_HEADER_SIZE);
+    Put(out, record.lsn);
+    Put(out, static_cast<uint8_t>(record.type));
+    Put(out, static_cast<int32_t>(record.id));
+    if (record.type == RecordType::ADD_DOCUMENT) {
+        Put(out, static_cast<uint8_t>(record.status));
+        Put(out, static_cast<uint32_t>(record.ratings.size()));
+        for (const int rating : record.ratings) {
+            Put(out, static_cast<int32_t>(rating));
+        }
+        out.append(record.text);
+    }
+    const size_t payload_offset = header_offset + RECORD_HEADER_SIZE;
+    const uint32_t payload_size = static_cast<uint32_t>(out.size() - payload_offset);
+    const uint32_t crc = Crc32(out.data() + payload_offset, payload_size);
+    std::memcpy(&out[header_offset], &payload_size, sizeof(payload_size));
+    std::memcpy(&out[header_offset + sizeof(payload_size)], &crc, sizeof(crc));
+}
+
+//     data. false -    , data  
+bool ParseRecord(std::string_view& data, LogRecord& record) {
+    std::string_view rest = data;
+    uint32_t payload_size = 0;
+    uint32_t crc = 0;
+    if (!Get(rest, payload_size) || !Get(rest, crc) || rest.size() < payload_size
+        || Crc32(rest.data(), payload_size) != crc) {
+        return false;
+    }
+    std::string_view payload = rest.substr(0, payload_size);
+    uint8_t type = 0;
+    int32_t id = 0;
+    if (!Get(payload, record.lsn) || !Get(payload, type) || !Get(payload, id)) {
+        return false;
+    }
+    record.type = static_cast<RecordType>(type);
+    record.id = id;
+    record.ratings.clear();
+    if (record.type == RecordType::ADD_DOCUMENT) {
+        uint8_t status = 0;
+        uint32_t rating_count = 0;
+        if (!Get(payload, status) || !Get(payload, rating_count) || payload.size() / sizeof(int32_t) < rating_count) {
+            return false;
+        }
+        record.status = static_cast<DocumentStatus>(status);
+        record.ratings.resize(rating_count);
+        for (int& rating : record.ratings) {
+            int32_t value = 0;
+            Get(payload, value);
+            rating = value;
+        }
+        record.text = payload;
+    }
+    else if (record.type != RecordType::REMOVE_DOCUMENT) {
+        return false;
+    }
+    data = rest.substr(payload_size);
+    return true;
+}
+
+//     CorpusFormat::FRAMED
+void AppendFramedLine(std::string& out, const LogRecord& record) {
+    out += std::to_string(record.id);
+    out += '\t';
+    out += std::to_string(static_cast<int>(record.status));
+    out += '\t';
+    for (size_t i = 0; i < record.ratings.size(); ++i) {
+        if (i > 0) {
+            out += ' ';
+        }
+        out += std::to_string(record.ratings[i]);
+    }
+    out += '\t';
+    out += record.text;
+    out += '\n';
+}
+
+std::runtime_error MakeFileError(std::string_view action, const std::filesystem::path& path) {
+    return std::runtime_error("Cannot "s + std::string(action) + " file "s + path.string() + ": "s + std::strerror(errno));
+}
+
+int OpenForWriting(const std::filesystem::path& path) {
+#ifdef _WIN32
+    const int fd = _open(path.string().c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#endif
+    if (fd < 0) {
+        throw MakeFileError("open"sv, path);
+    }
+    return fd;
+}
+
+void WriteAll(int fd, std::string_view data, const std::filesystem::path& path) {
+    while (!data.empty()) {
+#ifdef _WIN32
+        const int written = _write(fd, data.data(), static_cast<unsigned>(std::min<size_t>(data.size(), 1u << 30)));
+#else
+        const ssize_t written = write(fd, data.data(), data.size());
+#endif
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw MakeFileError("write"sv, path);
+        }
+        data.remove_prefix(static_cast<size_t>(written));
+    }
+}
+
+void SyncFile(int fd, const std::filesystem::path& path) {
+#ifdef _WIN32
+    if (_commit(fd) != 0) {
+#else
+    if (fdatasync(fd) != 0) {
+#endif
+        throw MakeFileError("sync"sv, path);
+    }
+}
+
+void CloseFile(int fd) {
+#ifdef _WIN32
+    _close(fd);
+#else
+    close(fd);
+#endif
+}
+
+// ,           
+void SyncDirectory(const std::filesystem::path& directory) {
+#ifndef _WIN32
+    const int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        throw MakeFileError("open"sv, directory);
+    }
+    const int result = fsync(fd);
+    close(fd);
+    if (result != 0) {
+        throw MakeFileError("sync"sv, directory);
+    }
+#endif
+}
+
+std::filesystem::path MakeFilePath(const std::string& directory, std::string_view prefix, uint64_t lsn, std::string_view extension) {
+    std::string number = std::to_string(lsn);
+    //   ,       
+    number.insert(0, number.size() < 20 ? 20 - number.size() : 0, '0');
+    return std::filesystem::path(directory) / (std::string(prefix) + number + std::string(extension));
+}
+
+//   <prefix><LSN><extension>   LSN
+std::vector<std::pair<uint64_t, std::filesystem::path>> ListFiles(const std::string& directory, std::string_view prefix, std::string_view extension) {
+    std::vector<std::pair<uint64_t, std::filesystem::path>> files;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory)) {
+        const std::string name = entry.path().filename().string();
+        if (name.size() <= prefix.size() + extension.size() || name.compare(0, prefix.size(), prefix) != 0
+            || name.compare(name.size() - extension.size(), extension.size(), extension) != 0) {
+            continue;
+        }
+        const char* first = name.data() + prefix.size();
+        const char* last = name.data() + name.size() - extension.size();
+        uint64_t lsn = 0;
+        const std::from_chars_result result = std::from_chars(first, last, lsn);
+        if (result.ec == std::errc() && result.ptr == last) {
+            files.emplace_back(lsn, entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+}
+
+WriteAheadLog::WriteAheadLog(SearchServer& search_server, const WalOptions& options)
+    : search_server_(search_server)
+    , options_(options)
+{
+    if (options_.directory.empty()) {
+        throw std::invalid_argument("Write-ahead log directory is not set");
+    }
+    std::filesystem::create_directories(options_.directory);
+    Recover();
+    durable_lsn_ = next_lsn_ - 1;
+    OpenSegment(next_lsn_);
+}
+
+WriteAheadLog::~WriteAheadLog() {
+    try {
+        Sync();
+    }
+    catch (const std::exception&) {
+        //         
+    }
+    if (segment_fd_ >= 0) {
+        CloseFile(segment_fd_);
+    }
+}
+
+void WriteAheadLog::AddDocument(int document_id, std::string_view document, DocumentStatus status, const std::vector<int>& ratings) {
+    std::unique_lock lock(mutex_);
+    ThrowIfFailed();
+    search_server_.AddPreparedDocument(search_server_.PrepareDocument(document_id, document, status, ratings));
+
+    LogRecord record;
+    record.lsn = next_lsn_++;
+    record.id = document_id;
+    record.status = status;
+    record.ratings = ratings;
+    record.text = document;
+    const size_t buffered_size = buffer_.size();
+    AppendRecord(buffer_, record);
+    ++buffered_records_;
+    ++stats_.records;
+    stats_.bytes += buffer_.size() - buffered_size;
+    if (buffered_records_ >= options_.sync_batch_size) {
+        WaitDurable(lock, record.lsn);
+    }
+}
+
+void WriteAheadLog::RemoveDocument(int document_id) {
+    std::unique_lock lock(mutex_);
+    ThrowIfFailed();
+    const int document_count = search_server_.GetDocumentCount();
+    search_server_.RemoveDocument(document_id);
+    if (search_server_.GetDocumentCount() == document_count) {
+        return;
+    }
+
+    LogRecord record;
+    record.lsn = next_lsn_++;
+    record.type = RecordType::REMOVE_DOCUMENT;
+    record.id = document_id;
+    const size_t buffered_size = buffer_.size();
+    AppendRecord(buffer_, record);
+    ++buffered_records_;
+    ++stats_.records;
+    stats_.bytes += buffer_.size() - buffered_size;
+    if (buffered_records_ >= options_.sync_batch_size) {
+        WaitDurable(lock, record.lsn);
+    }
+}
+
+void WriteAheadLog::Sync() {
+    std::unique_lock lock(mutex_);
+    WaitDurable(lock, next_lsn_ - 1);
+}
+
+WalStats WriteAheadLog::GetStats() const {
+    std::lock_guard lock(mutex_);
+    return stats_;
+}
+
+void WriteAheadLog::ThrowIfFailed() const {
+    if (!error_.empty()) {
+        throw std::runtime_error("Write-ahead log failed: "s + error_);
+    }
+}
+
+void WriteAheadLog::WaitDurable(std::unique_lock<std::mutex>& lock, uint64_t lsn) {
+    while (durable_lsn_ < lsn) {
+        ThrowIfFailed();
+        if (flushing_) {
+            //     ;      ,     
+            flushed_.wait(lock);
+            continue;
+        }
+        Flush(lock, false);
+    }
+}
+
+void WriteAheadLog::Flush(std::unique_lock<std::mutex>& lock, bool rotate) {
+    flushed_.wait(lock, [this] { return !flushing_; });
+    ThrowIfFailed();
+    flushing_ = true;
+    std::string batch;
+    batch.swap(spare_buffer_);
+    batch.swap(buffer_);
+    buffered_records_ = 0;
+    const uint64_t last_lsn = next_lsn_ - 1;
+    lock.unlock();
+
+    //   fsync   :       
+    std::string error;
+    bool synced = false;
+    try {
+        const std::filesystem::path path = MakeFilePath(options_.directory, "wal-"sv, segment_first_lsn_, ".log"sv);
+        if (!batch.empty()) {
+            WriteAll(segment_fd_, batch, path);
+            SyncFile(segment_fd_, path);
+            segment_bytes_ += batch.size();
+            synced = true;
+        }
+        if ((rotate || segment_bytes_ >= options_.segment_size) && segment_bytes_ > 0) {
+            OpenSegment(last_lsn + 1);
+        }
+    }
+    catch (const std::exception& e) {
+        error = e.what();
+    }
+    batch.clear();
+
+    lock.lock();
+    flushing_ = false;
+    spare_buffer_.swap(batch);
+    if (error.empty()) {
+        durable_lsn_ = last_lsn;
+    }
+    else {
+        error_ = error;
+    }
+    if (synced) {
+        ++stats_.syncs;
+    }
+    flushed_.notify_all();
+    ThrowIfFailed();
+}
+
+void WriteAheadLog::OpenSegment(uint64_t first_lsn) {
+    const std::filesystem::path path = MakeFilePath(options_.directory, "wal-"sv, first_lsn, ".log"sv);
+    const int fd = OpenForWriting(path);
+    SyncDirectory(options_.directory);
+    if (segment_fd_ >= 0) {
+        CloseFile(segment_fd_);
+    }
+    segment_fd_ = fd;
+    segment_first_lsn_ = first_lsn;
+    segment_bytes_ = 0;
+}
+
+void WriteAheadLog::Recover() {
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(options_.directory)) {
+        if (entry.path().extension() == ".tmp"s) {
+            std::filesystem::remove(entry.path());
+        }
+    }
+
+    //   LSN ,   ,    
+    const auto snapshots = ListFiles(options_.directory, "snapshot-"sv, ".tsv"sv);
+    if (!snapshots.empty()) {
+        IngestOptions ingest_options;
+        ingest_options.format = CorpusFormat::FRAMED;
+        recovery_stats_.snapshot_documents = IngestCorpus(search_server_, snapshots.back().second.string(), ingest_options);
+        next_lsn_ = snapshots.back().first;
+    }
+
+    const auto segments = ListFiles(options_.directory, "wal-"sv, ".log"sv);
+    for (size_t i = 0; i < segments.size(); ++i) {
+        const std::string path = segments[i].second.string();
+        const bool is_last = i + 1 == segments.size();
+        const size_t valid_size = ReplaySegment(path, is_last);
+        if (is_last && valid_size < std::filesystem::file_size(path)) {
+            recovery_stats_.truncated_bytes = std::filesystem::file_size(path) - valid_size;
+            std::filesystem::resize_file(path, valid_size);
+        }
+    }
+    if (!snapshots.empty()) {
+        RemoveObsoleteFiles(snapshots.back().first);
+    }
+}
+
+size_t WriteAheadLog::ReplaySegment(const std::string& path, bool is_last) {
+    MappedFile file(path);
+    const std::string_view data = file.GetData();
+
+    //          
+    std::vector<LogRecord> additions;
+    std::vector<PreparedDocument> documents;
+    std::vector<std::exception_ptr> errors;
+    const auto apply_additions = [&] {
+        documents.resize(additions.size());
+        errors.assign(additions.size(), nullptr);
+        std::transform(std::execution::par, additions.begin(), additions.end(), documents.begin(),
+            [this, &additions, &errors](const LogRecord& record) {
+                try {
+                    return search_server_.PrepareDocument(record.id, record.text, record.status, record.ratings);
+                }
+                catch (...) {
+                    errors[&record - additions.data()] = std::current_exception();
+                    return PreparedDocument{};
+                }
+            });
+        for (size_t i = 0; i < documents.size(); ++i) {
+            if (errors[i]) {
+                std::rethrow_exception(errors[i]);
+            }
+            search_server_.AddPreparedDocument(documents[i]);
+        }
+        additions.clear();
+    };
+
+    std::string_view rest = data;
+    LogRecord record;
+    while (ParseRecord(rest, record)) {
+        if (record.lsn < next_lsn_) {
+            continue;
+        }
+        next_lsn_ = record.lsn + 1;
+        ++recovery_stats_.replayed_records;
+        if (record.type == RecordType::ADD_DOCUMENT) {
+            additions.push_back(record);
+            if (additions.size() >= REPLAY_BATCH_SIZE) {
+                apply_additions();
+            }
+        }
+        else {
+            apply_additions();
+            search_server_.RemoveDocument(record.id);
+        }
+    }
+    apply_additions();
+
+    const size_t valid_size = data.size() - rest.size();
+    //        
+    if (valid_size < data.size() && !is_last) {
+        throw std::runtime_error("Write-ahead log segment "s + path + " is corrupted at offset "s + std::to_string(valid_size));
+    }
+    return valid_size;
+}
+
+void WriteAheadLog::Checkpoint() {
+    std::lock_guard checkpoint_lock(checkpoint_mutex_);
+    uint64_t checkpoint_lsn = 0;
+    {
+        std::unique_lock lock(mutex_);
+        Flush(lock, true);
+        checkpoint_lsn = segment_first_lsn_;
+    }
+
+    //     ,    
+    const auto snapshots = ListFiles(options_.directory, "snapshot-"sv, ".tsv"sv);
+    const uint64_t snapshot_lsn = snapshots.empty() ? 1 : snapshots.back().first;
+    if (snapshot_lsn >= checkpoint_lsn) {
+        return;
+    }
+
+    //      ;     
+    std::deque<MappedFile> segment_files;
+    std::map<int, LogRecord> last_records;
+    for (const auto& [first_lsn, path] : ListFiles(options_.directory, "wal-"sv, ".log"sv)) {
+        if (first_lsn >= checkpoint_lsn) {
+            break;
+        }
+        std::string_view rest = segment_files.emplace_back(path.string()).GetData();
+        LogRecord record;
+        while (ParseRecord(rest, record)) {
+            if (record.lsn >= snapshot_lsn) {
+                last_records[record.id] = record;
+            }
+        }
+        if (!rest.empty()) {
+            throw std::runtime_error("Write-ahead log segment "s + path.string() + " is corrupted"s);
+        }
+    }
+
+    const std::filesystem::path temporary_path = MakeFilePath(options_.directory, "snapshot-"sv, checkpoint_lsn, ".tmp"sv);
+    const int fd = OpenForWriting(temporary_path);
+    try {
+        std::string out;
+        //   ,       
+        if (!snapshots.empty()) {
+            MappedFile snapshot(snapshots.back().second.string());
+            std::string_view text = snapshot.GetData();
+            while (!text.empty()) {
+                const size_t line_end = text.find('\n');
+                const std::string_view line = text.substr(0, line_end == std::string_view::npos ? text.size() : line_end + 1);
+                text.remove_prefix(line.size());
+                int id = 0;
+                const std::string_view id_field = line.substr(0, line.find('\t'));
+                if (std::from_chars(id_field.data(), id_field.data() + id_field.size(), id).ec != std::errc()) {
+                    continue;
+                }
+                if (last_records.count(id) == 0) {
+                    out.append(line);
+                    if (out.back() != '\n') {
+                        out += '\n';
+                    }
+                }
+                if (out.size() >= SNAPSHOT_WRITE_SIZE) {
+                    WriteAll(fd, out, temporary_path);
+                    out.clear();
+                }
+            }
+        }
+        for (const auto& [id, record] : last_records) {
+            if (record.type == RecordType::ADD_DOCUMENT) {
+                AppendFramedLine(out, record);
+            }
+            if (out.size() >= SNAPSHOT_WRITE_SIZE) {
+                WriteAll(fd, out, temporary_path);
+                out.clear();
+            }
+        }
+        WriteAll(fd, out, temporary_path);
+        SyncFile(fd, temporary_path);
+    }
+    catch (...) {
+        CloseFile(fd);
+        std::filesystem::remove(temporary_path);
+        throw;
+    }
+    CloseFile(fd);
+
+    //   :      
+    std::filesystem::rename(temporary_path, MakeFilePath(options_.directory, "snapshot-"sv, checkpoint_lsn, ".tsv"sv));
+    SyncDirectory(options_.directory);
+    segment_files.clear();
+    RemoveObsoleteFiles(checkpoint_lsn);
+}
+
+void WriteAheadLog::RemoveObsoleteFiles(uint64_t snapshot_lsn) {
+    bool removed = false;
+    for (const auto& [lsn, path] : ListFiles(options_.directory, "snapshot-"sv, ".tsv"sv)) {
+        if (lsn < snapshot_lsn) {
+            removed |= std::filesystem::remove(path);
+        }
+    }
+    //   ,       
+    const auto segments = ListFiles(options_.directory, "wal-"sv, ".log"sv);
+    for (size_t i = 0; i + 1 < segments.size() && segments[i + 1].first <= snapshot_lsn; ++i) {
+        removed |= std::filesystem::remove(segments[i].second);
+    }
+    if (removed) {
+        SyncDirectory(options_.directory);
+    }
+}
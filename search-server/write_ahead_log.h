@@ -0,0 +1,108 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "search_server.h"
+
+struct WalOptions {
+    //  ; ,   
+    std::string directory;
+    // - ,            (fsync).
+    // 1 -     fsync  ,    
+    //    fsync (group commit). N > 1 -    ,  
+    //  N    Sync;      N - 1  
+    size_t sync_batch_size = 1;
+    //   ,       
+    size_t segment_size = size_t(64) << 20;
+};
+
+struct WalStats {
+    size_t records = 0; //     
+    size_t bytes = 0;
+    size_t syncs = 0;   //  fsync 
+};
+
+struct WalRecoveryStats {
+    size_t snapshot_documents = 0;
+    size_t replayed_records = 0;
+    size_t truncated_bytes = 0; //      
+};
+
+//    (WAL)  AddDocument  RemoveDocument.   
+//     (LSN)    CRC32.     wal-<LSN  >.log;
+// Checkpoint      snapshot-<LSN>.tsv -    CorpusFormat::FRAMED
+//  ,    LSN, -   .      
+//        ;   .
+//
+//           ,   
+//    .      fsync,     
+// ( sync_batch_size == 1).      ,     
+class WriteAheadLog {
+public:
+    //   search_server    .     
+    //    id.  std::runtime_error,          
+    WriteAheadLog(SearchServer& search_server, const WalOptions& options);
+    ~WriteAheadLog();
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    // ,   ,    .
+    //            std::runtime_error
+    void AddDocument(int document_id, std::string_view document, DocumentStatus status, const std::vector<int>& ratings);
+    //       
+    void RemoveDocument(int document_id);
+
+    //       
+    void Sync();
+
+    //              .
+    //           
+    void Checkpoint();
+
+    WalStats GetStats() const;
+
+    WalRecoveryStats GetRecoveryStats() const {
+        return recovery_stats_;
+    }
+
+private:
+    void Recover();
+    //     
+    size_t ReplaySegment(const std::string& path, bool is_last);
+    void OpenSegment(uint64_t first_lsn);
+    void RemoveObsoleteFiles(uint64_t snapshot_lsn);
+
+    //        ; rotate -     
+    void Flush(std::unique_lock<std::mutex>& lock, bool rotate);
+    void WaitDurable(std::unique_lock<std::mutex>& lock, uint64_t lsn);
+    void ThrowIfFailed() const;
+
+    SearchServer& search_server_;
+    const WalOptions options_;
+    WalRecoveryStats recovery_stats_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable flushed_;
+    std::string buffer_;       //  ,     
+    std::string spare_buffer_; //     ,     
+    size_t buffered_records_ = 0;
+    uint64_t next_lsn_ = 1;
+    uint64_t durable_lsn_ = 0;
+    bool flushing_ = false;    //    ,    fsync
+    std::string error_;
+    WalStats stats_;
+
+    //     (flushing_)    
+    int segment_fd_ = -1;
+    uint64_t segment_first_lsn_ = 1;
+    size_t segment_bytes_ = 0;
+
+    std::mutex checkpoint_mutex_;
+};